@@ -0,0 +1,138 @@
+//
+//  ASCoreStackLayoutBenchmark.cpp
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "ASCoreStackLayout.h"
+
+/**
+ * Benchmarks of the stack engine on synthetic trees. The trees are the ones of
+ * ASStackLayoutSpecPerformanceTests, so the numbers can be compared with the ones measured on devices.
+ *
+ * Usage: ASCoreStackLayoutBenchmark [iteration count]
+ */
+
+using namespace ASCore;
+
+static const int kRunCount = 10;
+
+static std::shared_ptr<LeafElement> leafElement(Size size)
+{
+  auto leaf = std::make_shared<LeafElement>();
+  leaf->style.size.width = DimensionMakeWithPoints(size.width);
+  leaf->style.size.height = DimensionMakeWithPoints(size.height);
+  return leaf;
+}
+
+static std::shared_ptr<StackLayout> stackLayout(StackLayoutDirection direction,
+                                                StackLayoutAlignItems alignItems,
+                                                std::vector<std::shared_ptr<LayoutElement>> children)
+{
+  return std::make_shared<StackLayout>(direction, 4, StackLayoutJustifyContent::Start, alignItems, std::move(children));
+}
+
+/**
+ * Lays out the given element repeatedly and prints the time per node.
+ */
+static void measureLayout(const char *name, LayoutElement &element, size_t nodeCount, const SizeRange &sizeRange, int iterationCount)
+{
+  element.layoutThatFits(sizeRange);
+
+  std::chrono::nanoseconds time(0);
+  for (int run = 0; run < kRunCount; run++) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterationCount; i++) {
+      element.layoutThatFits(sizeRange);
+    }
+    time += std::chrono::steady_clock::now() - start;
+  }
+  std::printf("%-24s %8.0f ns per node\n", name, (double)time.count() / ((double)kRunCount * iterationCount * nodeCount));
+}
+
+static void measureDeepTree(int iterationCount)
+{
+  const size_t depth = 50;
+  std::shared_ptr<LayoutElement> element = leafElement({20, 20});
+  for (size_t i = 0; i < depth; i++) {
+    const StackLayoutDirection direction = (i % 2 == 0) ? StackLayoutDirection::Vertical : StackLayoutDirection::Horizontal;
+    element = stackLayout(direction, StackLayoutAlignItems::Stretch, {element, leafElement({10, 10})});
+  }
+
+  measureLayout("DeepTree", *element, depth + 1, {{0, 0}, {1000, INFINITY}}, iterationCount);
+}
+
+static void measureWideTree(int iterationCount)
+{
+  const size_t nodeCount = 500;
+  std::vector<std::shared_ptr<LayoutElement>> children;
+  children.reserve(nodeCount);
+  for (size_t i = 0; i < nodeCount; i++) {
+    auto leaf = leafElement({20.0 + i % 7, 20.0 + i % 5});
+    leaf->style.flexShrink = 1;
+    children.push_back(leaf);
+  }
+
+  // The children don't fit, so every one of them is shrunk.
+  auto stack = stackLayout(StackLayoutDirection::Horizontal, StackLayoutAlignItems::Center, std::move(children));
+  measureLayout("WideTree", *stack, nodeCount, {{2000, 0}, {2000, INFINITY}}, iterationCount);
+}
+
+static void measureWrappingTree(int iterationCount)
+{
+  const size_t nodeCount = 500;
+  std::vector<std::shared_ptr<LayoutElement>> children;
+  children.reserve(nodeCount);
+  for (size_t i = 0; i < nodeCount; i++) {
+    children.push_back(leafElement({30.0 + i % 40, 20}));
+  }
+
+  auto stack = stackLayout(StackLayoutDirection::Horizontal, StackLayoutAlignItems::Start, std::move(children));
+  stack->flexWrap = StackLayoutFlexWrap::Wrap;
+  stack->alignContent = StackLayoutAlignContent::SpaceBetween;
+  stack->lineSpacing = 4;
+  measureLayout("WrappingTree", *stack, nodeCount, {{375, 0}, {375, INFINITY}}, iterationCount);
+}
+
+static void measureBaselineAlignedTree(int iterationCount)
+{
+  const size_t nodeCount = 500;
+  std::vector<std::shared_ptr<LayoutElement>> children;
+  children.reserve(nodeCount);
+  for (size_t i = 0; i < nodeCount; i++) {
+    auto leaf = leafElement({20, 14.0 + i % 10});
+    leaf->style.ascender = 10.0 + i % 10;
+    leaf->style.descender = -4;
+    children.push_back(leaf);
+  }
+
+  auto stack = stackLayout(StackLayoutDirection::Horizontal, StackLayoutAlignItems::BaselineFirst, std::move(children));
+  measureLayout("BaselineAlignedTree", *stack, nodeCount, SizeRangeUnconstrained, iterationCount);
+}
+
+int main(int argc, char *argv[])
+{
+  const int iterationCount = (argc > 1) ? std::atoi(argv[1]) : 100;
+  if (iterationCount <= 0) {
+    std::fprintf(stderr, "usage: %s [iteration count]\n", argv[0]);
+    return 1;
+  }
+
+  measureDeepTree(iterationCount);
+  measureWideTree(iterationCount);
+  measureWrappingTree(iterationCount);
+  measureBaselineAlignedTree(iterationCount);
+  return 0;
+}
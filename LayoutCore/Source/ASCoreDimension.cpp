@@ -0,0 +1,44 @@
+//
+//  ASCoreDimension.cpp
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#include "ASCoreDimension.h"
+
+#include <cassert>
+#include <limits>
+
+namespace ASCore {
+
+const Float ParentDimensionUndefined = std::numeric_limits<Float>::quiet_NaN();
+const Size ParentSizeUndefined = {ParentDimensionUndefined, ParentDimensionUndefined};
+
+const Dimension DimensionAuto = {DimensionUnit::Auto, 0};
+
+const SizeRange SizeRangeUnconstrained = {{0, 0}, {INFINITY, INFINITY}};
+
+namespace {
+
+Float gScreenScale = 1;
+
+} // namespace
+
+Float ScreenScale()
+{
+  return gScreenScale;
+}
+
+void SetScreenScale(Float scale)
+{
+  assert(scale > 0 && "The screen scale must be positive");
+  gScreenScale = scale;
+}
+
+} // namespace ASCore
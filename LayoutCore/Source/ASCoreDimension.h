@@ -0,0 +1,132 @@
+//
+//  ASCoreDimension.h
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#pragma once
+
+#include <cmath>
+
+#include "ASLayoutEngineDimension.h"
+
+/**
+ * Platform independent counterparts of the types in ASDimension.h and ASDimensionInternal.h. They are resolved by
+ * the dimension math of ASLayoutEngineDimension.h, the same code the framework runs, so layouts computed by the
+ * portable core match the ones of the framework point for point.
+ */
+namespace ASCore {
+
+/// CGFloat is a double on 64-bit Apple platforms.
+typedef double Float;
+
+struct Point {
+  Float x;
+  Float y;
+};
+
+inline Point operator+(const Point &p1, const Point &p2)
+{
+  return {p1.x + p2.x, p1.y + p2.y};
+}
+
+inline bool operator==(const Point &p1, const Point &p2)
+{
+  return p1.x == p2.x && p1.y == p2.y;
+}
+
+struct Size {
+  Float width;
+  Float height;
+};
+
+inline bool operator==(const Size &s1, const Size &s2)
+{
+  return s1.width == s2.width && s1.height == s2.height;
+}
+
+/**
+ * The counterpart of ASLayoutElementParentDimensionUndefined.
+ */
+extern const Float ParentDimensionUndefined;
+
+/**
+ * The counterpart of ASLayoutElementParentSizeUndefined.
+ */
+extern const Size ParentSizeUndefined;
+
+// MARK: - Dimension
+
+struct Dimension {
+  DimensionUnit unit;
+  Float value;
+};
+
+extern const Dimension DimensionAuto;
+
+inline Dimension DimensionMakeWithPoints(Float points)
+{
+  return {DimensionUnit::Points, points};
+}
+
+inline Dimension DimensionMakeWithFraction(Float fraction)
+{
+  return {DimensionUnit::Fraction, fraction};
+}
+
+// MARK: - SizeRange
+
+/**
+ * An inclusive range of sizes. Used to provide a simple constraint to layout.
+ */
+struct SizeRange {
+  Size min;
+  Size max;
+};
+
+extern const SizeRange SizeRangeUnconstrained;
+
+// MARK: - LayoutElementSize
+
+/**
+ * The counterpart of ASLayoutElementSize. All dimensions are auto by default.
+ */
+struct LayoutElementSize {
+  Dimension width = DimensionAuto;
+  Dimension height = DimensionAuto;
+  Dimension minWidth = DimensionAuto;
+  Dimension maxWidth = DimensionAuto;
+  Dimension minHeight = DimensionAuto;
+  Dimension maxHeight = DimensionAuto;
+};
+
+/**
+ * Resolves the given size to a parent size, with {0, 0} - {INFINITY, INFINITY} as auto size range.
+ */
+inline SizeRange LayoutElementSizeResolve(const LayoutElementSize &size, const Size &parentSize)
+{
+  return LayoutElementSizeResolveAutoSize(size, parentSize, SizeRangeUnconstrained);
+}
+
+// MARK: - Pixel rounding
+
+/**
+ * The scale ASFloorPixelValue rounds to. Defaults to 1, set it to match the screen of the device a layout is
+ * compared against.
+ */
+Float ScreenScale();
+void SetScreenScale(Float scale);
+
+inline Float FloorPixelValue(Float f)
+{
+  const Float scale = ScreenScale();
+  return std::floor(f * scale) / scale;
+}
+
+} // namespace ASCore
@@ -0,0 +1,33 @@
+//
+//  ASCoreLayoutElement.cpp
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#include "ASCoreLayoutElement.h"
+
+namespace ASCore {
+
+std::shared_ptr<Layout> LayoutElement::layoutThatFits(const SizeRange &constrainedSize, const Size &parentSize)
+{
+  const SizeRange resolvedRange = SizeRangeIntersect(constrainedSize, LayoutElementSizeResolve(style.size, parentSize));
+  return calculateLayoutThatFits(resolvedRange);
+}
+
+std::shared_ptr<Layout> LayoutElement::layoutThatFits(const SizeRange &constrainedSize)
+{
+  return layoutThatFits(constrainedSize, constrainedSize.max);
+}
+
+std::shared_ptr<Layout> LeafElement::calculateLayoutThatFits(const SizeRange &constrainedSize)
+{
+  return std::make_shared<Layout>(this, SizeRangeClamp(constrainedSize, intrinsicSize));
+}
+
+} // namespace ASCore
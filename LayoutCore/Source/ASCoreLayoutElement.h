@@ -0,0 +1,94 @@
+//
+//  ASCoreLayoutElement.h
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ASCoreDimension.h"
+#include "ASStackLayoutEngine.h"
+
+namespace ASCore {
+
+class LayoutElement;
+
+/**
+ * The style values the stack engine reads from its children, see ASLayoutElementStyle.
+ */
+struct LayoutElementStyle {
+  LayoutElementSize size;
+  Float spacingBefore = 0;
+  Float spacingAfter = 0;
+  Float flexGrow = 0;
+  Float flexShrink = 0;
+  Dimension flexBasis = DimensionAuto;
+  StackLayoutAlignSelf alignSelf = StackLayoutAlignSelf::Auto;
+  /// Like on iOS these are outputs too: a vertical stack sets them from its first and last child while laid out.
+  Float ascender = 0;
+  Float descender = 0;
+};
+
+/**
+ * The counterpart of ASLayout. The position is set by the parent once it has placed the layout.
+ */
+struct Layout {
+  const LayoutElement *element;
+  Size size;
+  Point position;
+  std::vector<std::shared_ptr<Layout>> sublayouts;
+
+  Layout(const LayoutElement *element, Size size) : element(element), size(size), position({0, 0}) {}
+  Layout(const LayoutElement *element, Size size, std::vector<std::shared_ptr<Layout>> sublayouts)
+    : element(element), size(size), position({0, 0}), sublayouts(std::move(sublayouts)) {}
+};
+
+/**
+ * The thin element interface the portable core lays out, standing in for id<ASLayoutElement>. Subclasses only
+ * implement calculateLayoutThatFits:, like ASLayoutSpec subclasses do.
+ */
+class LayoutElement {
+public:
+  LayoutElementStyle style;
+
+  virtual ~LayoutElement() = default;
+
+  /**
+   * Resolves the style size relative to parentSize, intersects it with constrainedSize and calculates the layout
+   * within the result. parentSize may be undefined in either dimension.
+   */
+  std::shared_ptr<Layout> layoutThatFits(const SizeRange &constrainedSize, const Size &parentSize);
+
+  /**
+   * Lays out at the top of a tree, with the max of constrainedSize as parent size.
+   */
+  std::shared_ptr<Layout> layoutThatFits(const SizeRange &constrainedSize);
+
+protected:
+  virtual std::shared_ptr<Layout> calculateLayoutThatFits(const SizeRange &constrainedSize) = 0;
+};
+
+/**
+ * A leaf of the tree, like a display node without subnodes. It is as close to its intrinsic size as the range allows,
+ * which is zero by default so that the style size decides.
+ */
+class LeafElement : public LayoutElement {
+public:
+  Size intrinsicSize;
+
+  explicit LeafElement(Size intrinsicSize = {0, 0}) : intrinsicSize(intrinsicSize) {}
+
+protected:
+  std::shared_ptr<Layout> calculateLayoutThatFits(const SizeRange &constrainedSize) override;
+};
+
+} // namespace ASCore
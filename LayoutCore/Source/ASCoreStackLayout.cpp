@@ -0,0 +1,140 @@
+//
+//  ASCoreStackLayout.cpp
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#include "ASCoreStackLayout.h"
+
+#include "ASStackLayoutEngine.h"
+
+namespace ASCore {
+
+namespace {
+
+struct StackLayoutSpecChild {
+  /** The original source child. Ascender and descender are read from its style as they are updated by layout. */
+  LayoutElement *element;
+  /** Size of the element */
+  LayoutElementSize size;
+  /** Flex inputs of the element, read from the style once. */
+  Float spacingBefore;
+  Float spacingAfter;
+  Float flexGrow;
+  Float flexShrink;
+  Dimension flexBasis;
+  StackLayoutAlignSelf alignSelf;
+};
+
+/**
+ * Adapts the portable element interface to the stack engine. Children are always laid out in order.
+ */
+struct StackLayoutEngineTraits {
+  typedef ASCore::Float Float;
+  typedef ASCore::Size Size;
+  typedef ASCore::Point Point;
+  typedef ASCore::SizeRange SizeRange;
+  typedef StackLayoutSpecChild Child;
+  typedef std::shared_ptr<ASCore::Layout> Layout;
+
+  static Layout layoutThatFits(const Child &child, const SizeRange &sizeRange, const Size &parentSize)
+  {
+    return child.element->layoutThatFits(sizeRange, parentSize);
+  }
+
+  static Size layoutSize(const Layout &layout)
+  {
+    return layout->size;
+  }
+
+  static Float ascender(const Child &child)
+  {
+    return child.element->style.ascender;
+  }
+
+  static Float descender(const Child &child)
+  {
+    return child.element->style.descender;
+  }
+
+  static Float floorPixelValue(Float f)
+  {
+    return FloorPixelValue(f);
+  }
+
+  template <typename Work>
+  static void apply(size_t count, bool concurrent, const Work &work)
+  {
+    for (size_t i = 0; i < count; i++) {
+      work(i);
+    }
+  }
+};
+
+struct StackLayoutSpecStyle {
+  StackLayoutDirection direction;
+  Float spacing;
+  StackLayoutJustifyContent justifyContent;
+  StackLayoutAlignItems alignItems;
+  StackLayoutFlexWrap flexWrap;
+  StackLayoutAlignContent alignContent;
+  Float lineSpacing;
+};
+
+typedef StackUnpositionedLayout<StackLayoutEngineTraits> StackUnpositionedLayoutType;
+typedef StackPositionedLayout<StackLayoutEngineTraits> StackPositionedLayoutType;
+
+} // namespace
+
+std::shared_ptr<Layout> StackLayout::calculateLayoutThatFits(const SizeRange &constrainedSize)
+{
+  if (children.empty()) {
+    return std::make_shared<Layout>(this, constrainedSize.min);
+  }
+
+  // All style values but the ascender and descender are read in one snapshot, see ASStackLayoutSpec.
+  std::vector<StackLayoutSpecChild> stackChildren;
+  stackChildren.reserve(children.size());
+  for (const auto &child : children) {
+    const LayoutElementStyle &childStyle = child->style;
+    stackChildren.push_back({
+      child.get(),
+      childStyle.size,
+      childStyle.spacingBefore,
+      childStyle.spacingAfter,
+      childStyle.flexGrow,
+      childStyle.flexShrink,
+      childStyle.flexBasis,
+      childStyle.alignSelf
+    });
+  }
+
+  const StackLayoutSpecStyle stackStyle = {direction, spacing, justifyContent, alignItems, flexWrap, alignContent, lineSpacing};
+
+  const auto unpositionedLayout = StackUnpositionedLayoutType::compute(stackChildren, stackStyle, constrainedSize, false);
+  const auto positionedLayout = StackPositionedLayoutType::compute(unpositionedLayout, stackStyle, constrainedSize);
+
+  if (direction == StackLayoutDirection::Vertical) {
+    style.ascender = stackChildren.front().element->style.ascender;
+    style.descender = stackChildren.back().element->style.descender;
+  }
+
+  // The engine works on the sizes and positions stored in the items, apply them to the layouts only now.
+  std::vector<std::shared_ptr<Layout>> sublayouts;
+  sublayouts.reserve(positionedLayout.items.size());
+  for (const auto &item : positionedLayout.items) {
+    std::shared_ptr<Layout> sublayout = item.layout ? item.layout : std::make_shared<Layout>(item.child.element, item.size);
+    sublayout->position = item.position;
+    sublayouts.push_back(std::move(sublayout));
+  }
+
+  return std::make_shared<Layout>(this, positionedLayout.size, std::move(sublayouts));
+}
+
+} // namespace ASCore
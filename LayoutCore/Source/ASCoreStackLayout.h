@@ -0,0 +1,49 @@
+//
+//  ASCoreStackLayout.h
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ASCoreLayoutElement.h"
+
+namespace ASCore {
+
+/**
+ * The counterpart of ASStackLayoutSpec. It runs the same engine on the portable element interface, so trees of
+ * stacks and leaves can be laid out and benchmarked without UIKit.
+ */
+class StackLayout : public LayoutElement {
+public:
+  StackLayoutDirection direction = StackLayoutDirection::Horizontal;
+  Float spacing = 0;
+  StackLayoutJustifyContent justifyContent = StackLayoutJustifyContent::Start;
+  StackLayoutAlignItems alignItems = StackLayoutAlignItems::Stretch;
+  StackLayoutFlexWrap flexWrap = StackLayoutFlexWrap::NoWrap;
+  StackLayoutAlignContent alignContent = StackLayoutAlignContent::Start;
+  Float lineSpacing = 0;
+  std::vector<std::shared_ptr<LayoutElement>> children;
+
+  StackLayout() = default;
+  StackLayout(StackLayoutDirection direction,
+              Float spacing,
+              StackLayoutJustifyContent justifyContent,
+              StackLayoutAlignItems alignItems,
+              std::vector<std::shared_ptr<LayoutElement>> children)
+    : direction(direction), spacing(spacing), justifyContent(justifyContent), alignItems(alignItems), children(std::move(children)) {}
+
+protected:
+  std::shared_ptr<Layout> calculateLayoutThatFits(const SizeRange &constrainedSize) override;
+};
+
+} // namespace ASCore
@@ -0,0 +1,165 @@
+//
+//  ASCoreStackLayoutTests.cpp
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#include <cstdio>
+#include <memory>
+
+#include "ASCoreStackLayout.h"
+
+/**
+ * Checks the frames the shared stack engine computes on the portable element interface against the numbers
+ * ASStackLayoutSpecTests expects from the framework.
+ */
+
+using namespace ASCore;
+
+static int failureCount = 0;
+
+#define ASCoreAssertTrue(condition, ...) \
+  do { \
+    if (!(condition)) { \
+      std::fprintf(stderr, "%s:%d: %s failed: ", __FILE__, __LINE__, #condition); \
+      std::fprintf(stderr, __VA_ARGS__); \
+      std::fprintf(stderr, "\n"); \
+      failureCount++; \
+    } \
+  } while (0)
+
+static std::shared_ptr<LeafElement> leafWithSize(Size size)
+{
+  auto leaf = std::make_shared<LeafElement>();
+  leaf->style.size.width = DimensionMakeWithPoints(size.width);
+  leaf->style.size.height = DimensionMakeWithPoints(size.height);
+  return leaf;
+}
+
+static void assertSize(const Layout &layout, Size size)
+{
+  ASCoreAssertTrue(layout.size == size, "Layout has size {%g, %g}, expected {%g, %g}",
+                   layout.size.width, layout.size.height, size.width, size.height);
+}
+
+static void assertSublayoutFrame(const Layout &layout, size_t index, Point position, Size size)
+{
+  if (index >= layout.sublayouts.size()) {
+    ASCoreAssertTrue(index < layout.sublayouts.size(), "Missing sublayout %zu", index);
+    return;
+  }
+  const Layout &sublayout = *layout.sublayouts[index];
+  ASCoreAssertTrue(sublayout.position == position && sublayout.size == size,
+                   "Sublayout %zu has frame {%g, %g, %g, %g}, expected {%g, %g, %g, %g}", index,
+                   sublayout.position.x, sublayout.position.y, sublayout.size.width, sublayout.size.height,
+                   position.x, position.y, size.width, size.height);
+}
+
+static void testThatChildrenAreSizedAndPositionedAlongTheStack()
+{
+  StackLayout stack(StackLayoutDirection::Horizontal, 10, StackLayoutJustifyContent::Start, StackLayoutAlignItems::Center,
+                    {leafWithSize({50, 20}), leafWithSize({30, 40})});
+  auto layout = stack.layoutThatFits({{0, 0}, {200, 100}});
+
+  assertSize(*layout, {90, 40});
+  assertSublayoutFrame(*layout, 0, {0, 10}, {50, 20});
+  assertSublayoutFrame(*layout, 1, {60, 0}, {30, 40});
+}
+
+static void testThatFlexibleChildrenGrowAndShrink()
+{
+  auto fixedLeaf = leafWithSize({40, 20});
+  auto growingLeaf = leafWithSize({20, 20});
+  growingLeaf->style.flexGrow = 1;
+  StackLayout stack;
+  stack.children = {fixedLeaf, growingLeaf};
+
+  auto layout = stack.layoutThatFits({{100, 0}, {100, 100}});
+  assertSize(*layout, {100, 20});
+  assertSublayoutFrame(*layout, 0, {0, 0}, {40, 20});
+  assertSublayoutFrame(*layout, 1, {40, 0}, {60, 20});
+
+  growingLeaf->style.flexGrow = 0;
+  fixedLeaf->style.flexShrink = 1;
+  growingLeaf->style.size.width = DimensionMakeWithPoints(80);
+  layout = stack.layoutThatFits({{100, 0}, {100, 100}});
+  assertSublayoutFrame(*layout, 0, {0, 0}, {20, 20});
+  assertSublayoutFrame(*layout, 1, {20, 0}, {80, 20});
+}
+
+static void testThatChildrenStretchAndJustifyAlongTheCrossAxis()
+{
+  // The first child has no width, so it is stretched. The second one keeps its own width.
+  auto stretchedLeaf = std::make_shared<LeafElement>();
+  stretchedLeaf->style.size.height = DimensionMakeWithPoints(10);
+  StackLayout stack(StackLayoutDirection::Vertical, 0, StackLayoutJustifyContent::End, StackLayoutAlignItems::Stretch,
+                    {stretchedLeaf, leafWithSize({30, 40})});
+  auto layout = stack.layoutThatFits({{80, 100}, {80, 100}});
+
+  assertSize(*layout, {80, 100});
+  assertSublayoutFrame(*layout, 0, {0, 50}, {80, 10});
+  assertSublayoutFrame(*layout, 1, {0, 60}, {30, 40});
+}
+
+static void testThatWrappingChildrenStartNewLines()
+{
+  StackLayout stack;
+  for (int i = 0; i < 3; i++) {
+    stack.children.push_back(leafWithSize({40, 20 + 10.0 * i}));
+  }
+  stack.flexWrap = StackLayoutFlexWrap::Wrap;
+  stack.spacing = 5;
+  stack.lineSpacing = 10;
+  auto layout = stack.layoutThatFits({{0, 0}, {100, 200}});
+
+  assertSize(*layout, {85, 80});
+  assertSublayoutFrame(*layout, 0, {0, 0}, {40, 20});
+  assertSublayoutFrame(*layout, 1, {45, 0}, {40, 30});
+  assertSublayoutFrame(*layout, 2, {0, 40}, {40, 40});
+}
+
+static void testThatBaselineAlignedChildrenShareTheirBaseline()
+{
+  auto tallLeaf = leafWithSize({20, 30});
+  tallLeaf->style.ascender = 20;
+  tallLeaf->style.descender = -10;
+  auto shortLeaf = leafWithSize({20, 20});
+  shortLeaf->style.ascender = 10;
+  shortLeaf->style.descender = -10;
+  auto row = std::make_shared<StackLayout>(StackLayoutDirection::Horizontal, 0, StackLayoutJustifyContent::Start,
+                                           StackLayoutAlignItems::BaselineFirst,
+                                           std::vector<std::shared_ptr<LayoutElement>>{tallLeaf, shortLeaf});
+  auto layout = row->layoutThatFits(SizeRangeUnconstrained);
+
+  assertSize(*layout, {40, 30});
+  assertSublayoutFrame(*layout, 0, {0, 0}, {20, 30});
+  assertSublayoutFrame(*layout, 1, {20, 10}, {20, 20});
+
+  // A vertical stack takes the ascender of its first child and the descender of its last one.
+  StackLayout column(StackLayoutDirection::Vertical, 0, StackLayoutJustifyContent::Start, StackLayoutAlignItems::Start,
+                     {shortLeaf, tallLeaf});
+  column.layoutThatFits(SizeRangeUnconstrained);
+  ASCoreAssertTrue(column.style.ascender == 10 && column.style.descender == -10,
+                   "Column has ascender %g and descender %g", column.style.ascender, column.style.descender);
+}
+
+int main()
+{
+  testThatChildrenAreSizedAndPositionedAlongTheStack();
+  testThatFlexibleChildrenGrowAndShrink();
+  testThatChildrenStretchAndJustifyAlongTheCrossAxis();
+  testThatWrappingChildrenStartNewLines();
+  testThatBaselineAlignedChildrenShareTheirBaseline();
+
+  if (failureCount > 0) {
+    std::fprintf(stderr, "%d assertion(s) failed\n", failureCount);
+    return 1;
+  }
+  return 0;
+}
@@ -1603,6 +1603,7 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
   );
 
   if (targetContentOffset != NULL) {
+    _layoutController.decelerationTargetContentOffset = *targetContentOffset;
     ASDisplayNodeAssert(_batchContext != nil, @"Batch context should exist");
     [self _beginBatchFetchingIfNeededWithContentOffset:*targetContentOffset velocity:velocity];
   }
@@ -2054,6 +2055,11 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
   return context;
 }
 
+- (NSHashTable<ASCollectionElement *> *)visibleElementsForDataController:(ASDataController *)dataController
+{
+  return [self visibleElementsForRangeController:_rangeController];
+}
+
 #pragma mark - ASRangeControllerDataSource
 
 - (ASRangeController *)rangeController
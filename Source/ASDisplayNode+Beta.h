@@ -57,6 +57,27 @@ typedef struct {
   NSInteger layoutComputationNumberOfPasses;
 } ASDisplayNodePerformanceMeasurements;
 
+/**
+ * Observes the automatic range tuning of the exp_adaptive_ranges experiment, e.g. for logging.
+ */
+@protocol ASRangeTuningDelegate <NSObject>
+
+/**
+ * Called on the main thread after each window of frames during which ranges were being updated, whether or not the
+ * buffer scale changed.
+ *
+ * @param bufferScale The factor now applied to the display and preload buffers of all range controllers.
+ * @param previousBufferScale The factor applied before this window was evaluated.
+ * @param droppedFrameCount The number of frames that were dropped during the window.
+ * @param frameCount The number of frames in the window, including the dropped ones.
+ */
+- (void)rangeTuningDidUpdateBufferScale:(CGFloat)bufferScale
+                    previousBufferScale:(CGFloat)previousBufferScale
+                      droppedFrameCount:(NSUInteger)droppedFrameCount
+                             frameCount:(NSUInteger)frameCount;
+
+@end
+
 @interface ASDisplayNode (Beta)
 
 /**
@@ -134,6 +155,23 @@ typedef struct {
  */
 + (void)setRangeModeForMemoryWarnings:(ASLayoutRangeMode)rangeMode;
 
+/**
+ * If the exp_adaptive_ranges experiment is enabled, range controllers watch for dropped frames while they update their
+ * ranges. Their display and preload buffers grow while frames have slack and shrink while frames are being dropped.
+ * The delegate is told about every tuning decision. It is held weakly.
+ */
++ (void)setRangeTuningDelegate:(nullable id<ASRangeTuningDelegate>)delegate;
+
+/**
+ * If the exp_range_memory_budget experiment is enabled, the display and preload ranges of all range controllers share
+ * this budget, in estimated bytes of decoded backing stores and retained layouts. Items are admitted across all range
+ * controllers in order of how close they are to being visible, so e.g. horizontal collections nested in a vertical
+ * collection don't each preload independently. Visible items are always admitted. Defaults to an eighth of the
+ * physical memory.
+ */
++ (NSUInteger)rangeMemoryBudget;
++ (void)setRangeMemoryBudget:(NSUInteger)rangeMemoryBudget;
+
 /**
  * @abstract Whether to draw all descendent nodes' contents into this node's layer's backing store.
  *
@@ -15,6 +15,7 @@
 //      http://www.apache.org/licenses/LICENSE-2.0
 //
 
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
@@ -484,6 +485,11 @@ ASLayoutElementStyleExtensibilityForwarding
   }
 }
 
+- (NSUInteger)layoutVersion
+{
+  return _layoutVersion.load();
+}
+
 @end
 
 #pragma mark -
@@ -653,6 +659,8 @@ ASLayoutElementStyleExtensibilityForwarding
         return;
       }
       as_activity_create_for_scope("Commit layout transition");
+      // The animation starts from the current subnodes, so they need to reflect the previous layout completely.
+      [self _finishIncrementalLayoutTransition];
       ASLayoutTransition *pendingLayoutTransition;
       _ASTransitionContext *pendingLayoutTransitionContext;
       {
@@ -903,19 +911,76 @@ ASLayoutElementStyleExtensibilityForwarding
     return;
   }
 
+  BOOL hasIncrementalLayoutTransition;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    hasIncrementalLayoutTransition = (_incrementalLayoutTransition != nil);
+  }
+
   // Trampoline to the main thread if necessary
-  if (ASDisplayNodeThreadIsMain() || layoutTransition.isSynchronous == NO) {
+  if (ASDisplayNodeThreadIsMain()) {
     // Committing the layout transition will result in subnode insertions and removals, both of which must be called without the lock held
+    ASAssertUnlocked(__instanceLock__);
+    [self _commitLayoutTransitionOnMainThread:layoutTransition];
+  } else if (layoutTransition.isSynchronous == NO && hasIncrementalLayoutTransition == NO) {
     ASAssertUnlocked(__instanceLock__);
     [layoutTransition commitTransition];
   } else {
     // Subnode insertions and removals need to happen always on the main thread if at least one subnode is already loaded
+    // or a previous transition is still being applied there
     ASPerformBlockOnMainThread(^{
-      [layoutTransition commitTransition];
+      [self _commitLayoutTransitionOnMainThread:layoutTransition];
     });
   }
 }
 
+- (void)_commitLayoutTransitionOnMainThread:(ASLayoutTransition *)layoutTransition
+{
+  ASDisplayNodeAssertMainThread();
+  ASAssertUnlocked(__instanceLock__);
+
+  // Operations of the new transition are calculated against the previous layout, so apply that one completely first.
+  [self _finishIncrementalLayoutTransition];
+
+  if (ASActivateExperimentalFeature(ASExperimentalIncrementalLayoutTransitions) == NO) {
+    [layoutTransition commitTransition];
+    return;
+  }
+
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    _incrementalLayoutTransition = layoutTransition;
+  }
+  __weak __typeof__(self) weakSelf = self;
+  __weak ASLayoutTransition *weakLayoutTransition = layoutTransition;
+  [layoutTransition commitTransitionIncrementallyWithCompletion:^{
+    __typeof__(self) strongSelf = weakSelf;
+    if (strongSelf == nil) {
+      return;
+    }
+    ASDN::MutexLocker l(strongSelf->__instanceLock__);
+    if (strongSelf->_incrementalLayoutTransition == weakLayoutTransition) {
+      strongSelf->_incrementalLayoutTransition = nil;
+    }
+  }];
+}
+
+/**
+ * Synchronously applies the rest of a layout transition that is being applied across frames, if any.
+ */
+- (void)_finishIncrementalLayoutTransition
+{
+  ASDisplayNodeAssertMainThread();
+  ASAssertUnlocked(__instanceLock__);
+
+  ASLayoutTransition *incrementalLayoutTransition;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    incrementalLayoutTransition = _incrementalLayoutTransition;
+  }
+  [incrementalLayoutTransition finishIncrementalCommit];
+}
+
 - (void)_assertSubnodeState
 {
   // Verify that any orphaned nodes are removed.
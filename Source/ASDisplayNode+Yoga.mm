@@ -163,6 +163,22 @@
   ASDisplayNodeAssert(childCount == self.yogaChildren.count,
                       @"Yoga tree should always be in sync with .yogaNodes array! %@", self.yogaChildren);
 
+  // Yoga flags every node whose layout it computed instead of taking from its cache. If neither this node nor its
+  // children got a new layout, the ASLayout from the previous pass is still accurate. Parents are set up before their
+  // children, so the children's flags are still intact here.
+  BOOL hasNewLayout = (self.yogaCalculatedLayout == nil || YGNodeGetHasNewLayout(yogaNode));
+  for (ASDisplayNode *subnode in self.yogaChildren) {
+    if (hasNewLayout) {
+      break;
+    }
+    hasNewLayout = YGNodeGetHasNewLayout(subnode.style.yogaNode);
+  }
+  YGNodeSetHasNewLayout(yogaNode, false);
+  if (hasNewLayout == NO) {
+    ASYogaLog("-setupYogaCalculatedLayout: reusing layout of clean Yoga node: %@", self);
+    return;
+  }
+
   NSMutableArray *sublayouts = [NSMutableArray arrayWithCapacity:childCount];
   for (ASDisplayNode *subnode in self.yogaChildren) {
     [sublayouts addObject:[subnode layoutForYogaNode]];
@@ -268,18 +284,10 @@
 
   ASLockScopeSelf();
 
-  // Prepare all children for the layout pass with the current Yoga tree configuration.
-  ASDisplayNodePerformBlockOnEveryYogaChild(self, ^(ASDisplayNode * _Nonnull node) {
-    node.yogaLayoutInProgress = YES;
-  });
-
   if (ASSizeRangeEqualToSizeRange(rootConstrainedSize, ASSizeRangeUnconstrained)) {
     rootConstrainedSize = [self _locked_constrainedSizeForLayoutPass];
   }
 
-  ASYogaLog("CALCULATING at Yoga root with constraint = {%@, %@}: %@",
-            NSStringFromCGSize(rootConstrainedSize.min), NSStringFromCGSize(rootConstrainedSize.max), self);
-
   YGNodeRef rootYogaNode = self.style.yogaNode;
 
   // Apply the constrainedSize as a base, known frame of reference.
@@ -290,20 +298,41 @@
   YGNodeStyleSetMinWidth (rootYogaNode, yogaFloatForCGFloat(rootConstrainedSize.min.width));
   YGNodeStyleSetMinHeight(rootYogaNode, yogaFloatForCGFloat(rootConstrainedSize.min.height));
 
-  // It is crucial to use yogaFloat... to convert CGFLOAT_MAX into YGUndefined here.
-  YGNodeCalculateLayout(rootYogaNode,
-                        yogaFloatForCGFloat(rootConstrainedSize.max.width),
-                        yogaFloatForCGFloat(rootConstrainedSize.max.height),
-                        YGDirectionInherit);
+  // Style changes, measure func invalidations and tree mutations all mark the root dirty. If it is clean and the
+  // constraint didn't change, Yoga would return its cached layout for every node without calling any measure func.
+  BOOL needsYogaLayout = (YGNodeIsDirty(rootYogaNode)
+                          || ASSizeRangeEqualToSizeRange(rootConstrainedSize, _yogaRootConstrainedSize) == NO);
+  _yogaRootConstrainedSize = rootConstrainedSize;
 
-  // Reset accessible elements, since layout may have changed.
-  ASPerformBlockOnMainThread(^{
-    [(_ASDisplayView *)self.view setAccessibleElements:nil];
-  });
+  if (needsYogaLayout) {
+    ASYogaLog("CALCULATING at Yoga root with constraint = {%@, %@}: %@",
+              NSStringFromCGSize(rootConstrainedSize.min), NSStringFromCGSize(rootConstrainedSize.max), self);
+
+    // Prepare all children for the layout pass with the current Yoga tree configuration.
+    ASDisplayNodePerformBlockOnEveryYogaChild(self, ^(ASDisplayNode * _Nonnull node) {
+      node.yogaLayoutInProgress = YES;
+    });
+
+    // It is crucial to use yogaFloat... to convert CGFLOAT_MAX into YGUndefined here.
+    YGNodeCalculateLayout(rootYogaNode,
+                          yogaFloatForCGFloat(rootConstrainedSize.max.width),
+                          yogaFloatForCGFloat(rootConstrainedSize.max.height),
+                          YGDirectionInherit);
 
+    // Reset accessible elements, since layout may have changed.
+    ASPerformBlockOnMainThread(^{
+      [(_ASDisplayView *)self.view setAccessibleElements:nil];
+    });
+  } else {
+    ASYogaLog("REUSING Yoga layout of clean tree at root: %@", self);
+  }
+
+  // Only nodes with a new Yoga layout, or whose ASLayout was invalidated, build a new ASLayout.
   ASDisplayNodePerformBlockOnEveryYogaChild(self, ^(ASDisplayNode * _Nonnull node) {
     [node setupYogaCalculatedLayout];
-    node.yogaLayoutInProgress = NO;
+    if (needsYogaLayout) {
+      node.yogaLayoutInProgress = NO;
+    }
   });
 
 #if YOGA_LAYOUT_LOGGING /* YOGA_LAYOUT_LOGGING */
@@ -32,6 +32,7 @@
 #import <AsyncDisplayKit/_ASDisplayView.h>
 #import <AsyncDisplayKit/_ASPendingState.h>
 #import <AsyncDisplayKit/_ASScopeTimer.h>
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
 #import <AsyncDisplayKit/ASDimension.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h>
@@ -1188,6 +1189,11 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__);
     ASDisplayNodeAssert(layoutSpec.isMutable, @"Node %@ returned layout spec %@ that has already been used. Layout specs should always be regenerated.", self, layoutSpec);
     
     layoutSpec.isMutable = NO;
+    
+    if (ASActivateExperimentalFeature(ASExperimentalLayoutSpecCache)) {
+      [layoutSpec adoptCachedLayoutsFromLayoutSpec:_lastLayoutSpec];
+      _lastLayoutSpec = layoutSpec;
+    }
   }
   
   // Manually propagate the trait collection here so that any layoutSpec children of layoutSpec will get a traitCollection
@@ -27,6 +27,13 @@ typedef NS_OPTIONS(NSUInteger, ASExperimentalFeatures) {
   ASExperimentalNetworkImageQueue = 1 << 5,                 // exp_network_image_queue
   ASExperimentalDeallocQueue = 1 << 6,                      // exp_dealloc_queue_v2
   ASExperimentalCollectionTeardown = 1 << 7,                // exp_collection_teardown
+  ASExperimentalLayoutSpecCache = 1 << 8,                   // exp_layout_spec_cache
+  ASExperimentalIncrementalLayoutTransitions = 1 << 9,      // exp_incremental_layout_transitions
+  ASExperimentalCoalescedBatchUpdates = 1 << 10,            // exp_coalesced_batch_updates
+  ASExperimentalPredictiveRanges = 1 << 11,                 // exp_predictive_ranges
+  ASExperimentalAdaptiveRanges = 1 << 12,                   // exp_adaptive_ranges
+  ASExperimentalRangeMemoryBudget = 1 << 13,                // exp_range_memory_budget
+  ASExperimentalTableRowOffsets = 1 << 14,                  // exp_table_row_offsets
   ASExperimentalFeatureAll = 0xFFFFFFFF
 };
 
@@ -23,7 +23,14 @@ NSArray<NSString *> *ASExperimentalFeaturesGetNames(ASExperimentalFeatures flags
                                       @"exp_infer_layer_defaults",
                                       @"exp_network_image_queue",
                                       @"exp_dealloc_queue_v2",
-                                      @"exp_collection_teardown"]));
+                                      @"exp_collection_teardown",
+                                      @"exp_layout_spec_cache",
+                                      @"exp_incremental_layout_transitions",
+                                      @"exp_coalesced_batch_updates",
+                                      @"exp_predictive_ranges",
+                                      @"exp_adaptive_ranges",
+                                      @"exp_range_memory_budget",
+                                      @"exp_table_row_offsets"]));
   
   if (flags == ASExperimentalFeatureAll) {
     return allNames;
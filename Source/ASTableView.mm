@@ -560,7 +560,9 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
 
 - (void)relayoutItems
 {
-  [_dataController relayoutAllNodesWithInvalidationBlock:nil];
+  [_dataController relayoutAllNodesWithInvalidationBlock:^{
+    [_layoutController invalidateRowOffsets];
+  }];
 }
 
 - (void)setTuningParameters:(ASRangeTuningParameters)tuningParameters forRangeType:(ASLayoutRangeType)rangeType
@@ -755,7 +757,9 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
     [_cellsForLayoutUpdates removeAllObjects];
 
     [self beginUpdates];
-    [_dataController relayoutAllNodesWithInvalidationBlock:nil];
+    [_dataController relayoutAllNodesWithInvalidationBlock:^{
+      [_layoutController invalidateRowOffsets];
+    }];
     [self endUpdatesAnimated:(ASDisplayNodeLayerHasAnimations(self.layer) == NO) completion:nil];
   } else {
     if (_cellsForLayoutUpdates.count > 0) {
@@ -765,6 +769,7 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
       let nodesSizeChanged = [[NSMutableArray<ASCellNode *> alloc] init];
       [_dataController relayoutNodes:nodes nodesSizeChanged:nodesSizeChanged];
       if (nodesSizeChanged.count > 0) {
+        [_layoutController nodesDidRelayout:nodesSizeChanged];
         [self requeryNodeHeights];
       }
     }
@@ -1261,6 +1266,7 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
   );
 
   if (targetContentOffset != NULL) {
+    _layoutController.decelerationTargetContentOffset = *targetContentOffset;
     ASDisplayNodeAssert(_batchContext != nil, @"Batch context should exist");
     [self _beginBatchFetchingIfNeededWithContentOffset:*targetContentOffset velocity:velocity];
   }
@@ -1799,6 +1805,17 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
   return (fabs(rect.size.height - size.height) < FLT_EPSILON);
 }
 
+- (NSHashTable<ASCollectionElement *> *)visibleElementsForDataController:(ASDataController *)dataController
+{
+  return [self visibleElementsForRangeController:_rangeController];
+}
+
+- (BOOL)dataControllerMeasuresElementsOnDemand:(ASDataController *)dataController
+{
+  // With estimated row heights, UITableView only asks for the heights of the rows it is about to display.
+  return self.estimatedRowHeight != 0;
+}
+
 #pragma mark - _ASTableViewCellDelegate
 
 - (void)didLayoutSubviewsOfTableViewCell:(_ASTableViewCell *)tableViewCell
@@ -1834,6 +1851,7 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
 
     // If the node height changed, trigger a height requery.
     if (oldSize.height != calculatedSize.height) {
+      [_layoutController nodesDidRelayout:@[ node ]];
       [self beginUpdates];
       [self endUpdatesAnimated:(ASDisplayNodeLayerHasAnimations(self.layer) == NO) completion:nil];
     }
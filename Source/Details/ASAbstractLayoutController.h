@@ -26,8 +26,47 @@ AS_EXTERN ASDirectionalScreenfulBuffer ASDirectionalScreenfulBufferVertical(ASSc
 
 AS_EXTERN CGRect CGRectExpandToRangeWithScrollableDirections(CGRect rect, ASRangeTuningParameters tuningParameters, ASScrollDirection scrollableDirections, ASScrollDirection scrollDirection);
 
+/**
+ * Returns the bounds the scroll view is predicted to show after the given interval.
+ *
+ * While the user is dragging, the bounds move along with the pan gesture at its current velocity. While the scroll view
+ * is decelerating, they move along UIKit's exponential deceleration curve toward the given target content offset.
+ * The predicted bounds stay within the scrollable content. Otherwise the scroll view is idle and its bounds are returned.
+ */
+AS_EXTERN CGRect ASScrollViewPredictedBounds(UIScrollView *scrollView, CGPoint decelerationTargetContentOffset, NSTimeInterval interval);
+
 @interface ASAbstractLayoutController : NSObject <ASLayoutController>
 
+/**
+ * The content offset the scroll view is decelerating to. Owners of layout controllers set this when dragging ends.
+ */
+@property (nonatomic) CGPoint decelerationTargetContentOffset;
+
+/**
+ * How far ahead, in seconds, range bounds are stretched toward the predicted bounds of the scroll view.
+ * Only used if the exp_predictive_ranges experiment is enabled. Defaults to 0.25 seconds, or 15 frames at 60 FPS.
+ */
+@property (nonatomic) NSTimeInterval rangePredictionInterval;
+
+/**
+ * The factor the leading and trailing buffers of the tuning parameters are scaled by when computing range bounds, see
+ * rangeBoundsOfScrollView:scrollableDirections:scrollDirection:rangeTuningParameters:. Range controllers shrink it
+ * while frames are dropped and grow it back afterwards if the exp_adaptive_ranges experiment is enabled. Defaults to 1.
+ */
+@property (nonatomic) CGFloat bufferScale;
+
+/**
+ * Returns the bounds of the scroll view expanded by the tuning parameters, scaled by bufferScale.
+ *
+ * If the exp_predictive_ranges experiment is enabled, the bounds are also stretched to cover the predicted bounds of the
+ * scroll view after rangePredictionInterval, expanded the same way. They shrink back to the expanded bounds when
+ * the scroll view is idle.
+ */
+- (CGRect)rangeBoundsOfScrollView:(UIScrollView *)scrollView
+             scrollableDirections:(ASScrollDirection)scrollableDirections
+                  scrollDirection:(ASScrollDirection)scrollDirection
+            rangeTuningParameters:(ASRangeTuningParameters)tuningParameters;
+
 @end
 
 @interface ASAbstractLayoutController (Unavailable)
@@ -18,6 +18,7 @@
 #import <AsyncDisplayKit/ASAbstractLayoutController.h>
 
 #import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
 
 #include <vector>
 
@@ -90,6 +91,34 @@ CGRect CGRectExpandToRangeWithScrollableDirections(CGRect rect, ASRangeTuningPar
   return rect;
 }
 
+CGRect ASScrollViewPredictedBounds(UIScrollView *scrollView, CGPoint decelerationTargetContentOffset, NSTimeInterval interval)
+{
+  CGRect bounds = scrollView.bounds;
+  CGPoint contentOffset = bounds.origin;
+  CGPoint predictedContentOffset;
+  if (scrollView.isTracking) {
+    // The content moves opposite to the finger.
+    CGPoint velocity = [scrollView.panGestureRecognizer velocityInView:scrollView.superview];
+    predictedContentOffset = CGPointMake(contentOffset.x - velocity.x * interval, contentOffset.y - velocity.y * interval);
+  } else if (scrollView.isDecelerating) {
+    // The remaining distance to the target shrinks by the deceleration rate every millisecond.
+    CGFloat remainingFraction = pow(scrollView.decelerationRate, interval * 1000);
+    CGPoint target = decelerationTargetContentOffset;
+    predictedContentOffset = CGPointMake(target.x - (target.x - contentOffset.x) * remainingFraction,
+                                         target.y - (target.y - contentOffset.y) * remainingFraction);
+  } else {
+    return bounds;
+  }
+
+  UIEdgeInsets contentInset = scrollView.contentInset;
+  CGSize contentSize = scrollView.contentSize;
+  CGFloat maxX = MAX(-contentInset.left, contentSize.width + contentInset.right - bounds.size.width);
+  CGFloat maxY = MAX(-contentInset.top, contentSize.height + contentInset.bottom - bounds.size.height);
+  bounds.origin.x = MIN(MAX(predictedContentOffset.x, -contentInset.left), maxX);
+  bounds.origin.y = MIN(MAX(predictedContentOffset.y, -contentInset.top), maxY);
+  return bounds;
+}
+
 @interface ASAbstractLayoutController () {
   std::vector<std::vector<ASRangeTuningParameters>> _tuningParameters;
 }
@@ -104,6 +133,8 @@ CGRect CGRectExpandToRangeWithScrollableDirections(CGRect rect, ASRangeTuningPar
   }
   ASDisplayNodeAssert(self.class != [ASAbstractLayoutController class], @"Should never create instances of abstract class ASAbstractLayoutController.");
   
+  _rangePredictionInterval = 0.25;
+  _bufferScale = 1.0;
   _tuningParameters = std::vector<std::vector<ASRangeTuningParameters>> (ASLayoutRangeModeCount, std::vector<ASRangeTuningParameters> (ASLayoutRangeTypeCount));
   
   _tuningParameters[ASLayoutRangeModeFull][ASLayoutRangeTypeDisplay] = {
@@ -172,6 +203,30 @@ CGRect CGRectExpandToRangeWithScrollableDirections(CGRect rect, ASRangeTuningPar
   _tuningParameters[rangeMode][rangeType] = tuningParameters;
 }
 
+#pragma mark - Range Bounds
+
+- (CGRect)rangeBoundsOfScrollView:(UIScrollView *)scrollView
+             scrollableDirections:(ASScrollDirection)scrollableDirections
+                  scrollDirection:(ASScrollDirection)scrollDirection
+            rangeTuningParameters:(ASRangeTuningParameters)tuningParameters
+{
+  tuningParameters.leadingBufferScreenfuls *= _bufferScale;
+  tuningParameters.trailingBufferScreenfuls *= _bufferScale;
+  CGRect bounds = scrollView.bounds;
+  CGRect rangeBounds = CGRectExpandToRangeWithScrollableDirections(bounds, tuningParameters, scrollableDirections, scrollDirection);
+  if (!ASActivateExperimentalFeature(ASExperimentalPredictiveRanges)) {
+    return rangeBounds;
+  }
+
+  CGRect predictedBounds = ASScrollViewPredictedBounds(scrollView, _decelerationTargetContentOffset, _rangePredictionInterval);
+  if (CGRectEqualToRect(predictedBounds, bounds)) {
+    return rangeBounds;
+  }
+  // Cover everything between here and there, so fast flings don't overrun the range.
+  CGRect predictedRangeBounds = CGRectExpandToRangeWithScrollableDirections(predictedBounds, tuningParameters, scrollableDirections, scrollDirection);
+  return CGRectUnion(rangeBounds, predictedRangeBounds);
+}
+
 #pragma mark - Abstract Index Path Range Support
 
 - (NSHashTable<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType map:(ASElementMap *)map
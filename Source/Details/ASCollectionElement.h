@@ -18,7 +18,7 @@
 #import <AsyncDisplayKit/ASDataController.h>
 #import <AsyncDisplayKit/ASTraitCollection.h>
 
-@class ASDisplayNode;
+@class ASDisplayNode, ASSection;
 @protocol ASRangeManagingNode;
 
 NS_ASSUME_NONNULL_BEGIN
@@ -32,6 +32,13 @@ AS_SUBCLASSING_RESTRICTED
 @property (nonatomic) ASPrimitiveTraitCollection traitCollection;
 @property (nullable, nonatomic, readonly) id nodeModel;
 
+/**
+ * The section of items the element belongs to, or nil for supplementary elements. Set by the first element map that
+ * contains the element, which uses it to look the element up. Item elements never change sections: moving an item
+ * creates a new element.
+ */
+@property (nullable, nonatomic) ASSection *section;
+
 - (instancetype)initWithNodeModel:(nullable id)nodeModel
                         nodeBlock:(ASCellNodeBlock)nodeBlock
          supplementaryElementKind:(nullable NSString *)supplementaryElementKind
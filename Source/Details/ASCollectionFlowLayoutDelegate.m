@@ -60,11 +60,35 @@
 + (ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context
 {
   ASElementMap *elements = context.elements;
-  NSArray<ASCellNode *> *children = ASArrayByFlatMapping(elements.itemElements, ASCollectionElement *element, element.node);
-  if (children.count == 0) {
+  NSArray<ASCollectionElement *> *itemElements = elements.itemElements;
+  if (itemElements.count == 0) {
     return [[ASCollectionLayoutState alloc] initWithContext:context];
   }
-  
+
+  ASSizeRange sizeRange = ASSizeRangeForCollectionLayoutThatFitsViewportSize(context.viewportSize, context.scrollableDirections);
+  ASLayout *layout = [[self _stackSpecWithElements:itemElements] layoutThatFits:sizeRange];
+
+  return [[ASCollectionLayoutState alloc] initWithContext:context layout:layout getElementBlock:[self _getElementBlock]];
+}
+
++ (ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context
+                                         previousLayout:(ASCollectionLayoutState *)previousLayout
+                              unchangedLeadingItemCount:(NSUInteger)unchangedLeadingItemCount
+                             unchangedTrailingItemCount:(NSUInteger)unchangedTrailingItemCount
+{
+  // Items only wrap into lines if the layout scrolls vertically.
+  if (context.scrollableDirections != ASScrollDirectionVerticalDirections) {
+    return nil;
+  }
+
+  return ASCollectionLayoutStateByUpdatingWrappingLayout(context, previousLayout, unchangedLeadingItemCount, unchangedTrailingItemCount, UIEdgeInsetsZero, ^(NSArray<ASCollectionElement *> *elements) {
+    return [self _stackSpecWithElements:elements];
+  }, [self _getElementBlock]);
+}
+
++ (ASStackLayoutSpec *)_stackSpecWithElements:(NSArray<ASCollectionElement *> *)elements
+{
+  NSArray<ASCellNode *> *children = ASArrayByFlatMapping(elements, ASCollectionElement *element, element.node);
   ASStackLayoutSpec *stackSpec = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal
                                                                          spacing:0
                                                                   justifyContent:ASStackLayoutJustifyContentStart
@@ -73,14 +97,15 @@
                                                                     alignContent:ASStackLayoutAlignContentStart
                                                                         children:children];
   stackSpec.concurrent = YES;
+  return stackSpec;
+}
 
-  ASSizeRange sizeRange = ASSizeRangeForCollectionLayoutThatFitsViewportSize(context.viewportSize, context.scrollableDirections);
-  ASLayout *layout = [stackSpec layoutThatFits:sizeRange];
-
-  return [[ASCollectionLayoutState alloc] initWithContext:context layout:layout getElementBlock:^ASCollectionElement * _Nullable(ASLayout * _Nonnull sublayout) {
++ (ASCollectionLayoutStateGetElementBlock)_getElementBlock
+{
+  return ^ASCollectionElement * _Nullable(ASLayout * _Nonnull sublayout) {
     ASCellNode *node = ASDynamicCast(sublayout.layoutElement, ASCellNode);
     return node ? node.collectionElement : nil;
-  }];
+  };
 }
 
 @end
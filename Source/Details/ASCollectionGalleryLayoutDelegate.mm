@@ -103,14 +103,50 @@
     return [[ASCollectionLayoutState alloc] initWithContext:context];
   }
 
-  NSArray<_ASGalleryLayoutItem *> *children = ASArrayByFlatMapping(elements.itemElements,
-                                                                   ASCollectionElement *element,
-                                                                   [[_ASGalleryLayoutItem alloc] initWithItemSize:itemSize collectionElement:element]);
-  if (children.count == 0) {
+  NSArray<ASCollectionElement *> *itemElements = elements.itemElements;
+  if (itemElements.count == 0) {
     return [[ASCollectionLayoutState alloc] initWithContext:context];
   }
 
-  // Use a stack spec to calculate layout content size and frames of all elements without actually measuring each element
+  ASLayoutSpec *finalSpec = [self _stackSpecWithElements:itemElements scrollableDirections:scrollableDirections info:info];
+  UIEdgeInsets sectionInset = info.sectionInset;
+  if (UIEdgeInsetsEqualToEdgeInsets(sectionInset, UIEdgeInsetsZero) == NO) {
+    finalSpec = [ASInsetLayoutSpec insetLayoutSpecWithInsets:sectionInset child:finalSpec];
+  }
+
+  ASLayout *layout = [finalSpec layoutThatFits:ASSizeRangeForCollectionLayoutThatFitsViewportSize(pageSize, scrollableDirections)];
+
+  return [[ASCollectionLayoutState alloc] initWithContext:context layout:layout getElementBlock:[self _getElementBlock]];
+}
+
++ (ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context
+                                         previousLayout:(ASCollectionLayoutState *)previousLayout
+                              unchangedLeadingItemCount:(NSUInteger)unchangedLeadingItemCount
+                             unchangedTrailingItemCount:(NSUInteger)unchangedTrailingItemCount
+{
+  _ASCollectionGalleryLayoutInfo *info = ASDynamicCast(context.additionalInfo, _ASCollectionGalleryLayoutInfo);
+  if (info == nil || CGSizeEqualToSize(CGSizeZero, info.itemSize)) {
+    return nil;
+  }
+
+  ASScrollDirection scrollableDirections = context.scrollableDirections;
+  return ASCollectionLayoutStateByUpdatingWrappingLayout(context, previousLayout, unchangedLeadingItemCount, unchangedTrailingItemCount, info.sectionInset, ^(NSArray<ASCollectionElement *> *elements) {
+    return [self _stackSpecWithElements:elements scrollableDirections:scrollableDirections info:info];
+  }, [self _getElementBlock]);
+}
+
+/**
+ * Returns a stack spec that calculates the frames of the given elements without actually measuring each element.
+ */
++ (ASStackLayoutSpec *)_stackSpecWithElements:(NSArray<ASCollectionElement *> *)elements
+                         scrollableDirections:(ASScrollDirection)scrollableDirections
+                                         info:(_ASCollectionGalleryLayoutInfo *)info
+{
+  CGSize itemSize = info.itemSize;
+  NSArray<_ASGalleryLayoutItem *> *children = ASArrayByFlatMapping(elements,
+                                                                   ASCollectionElement *element,
+                                                                   [[_ASGalleryLayoutItem alloc] initWithItemSize:itemSize collectionElement:element]);
+
   ASStackLayoutDirection stackDirection = ASScrollDirectionContainsVerticalDirection(scrollableDirections)
                                               ? ASStackLayoutDirectionHorizontal
                                               : ASStackLayoutDirectionVertical;
@@ -123,19 +159,15 @@
                                                                      lineSpacing:info.minimumLineSpacing
                                                                         children:children];
   stackSpec.concurrent = YES;
+  return stackSpec;
+}
 
-  ASLayoutSpec *finalSpec = stackSpec;
-  UIEdgeInsets sectionInset = info.sectionInset;
-  if (UIEdgeInsetsEqualToEdgeInsets(sectionInset, UIEdgeInsetsZero) == NO) {
-    finalSpec = [ASInsetLayoutSpec insetLayoutSpecWithInsets:sectionInset child:stackSpec];
-  }
-
-  ASLayout *layout = [finalSpec layoutThatFits:ASSizeRangeForCollectionLayoutThatFitsViewportSize(pageSize, scrollableDirections)];
-
-  return [[ASCollectionLayoutState alloc] initWithContext:context layout:layout getElementBlock:^ASCollectionElement * _Nullable(ASLayout * _Nonnull sublayout) {
++ (ASCollectionLayoutStateGetElementBlock)_getElementBlock
+{
+  return ^ASCollectionElement * _Nullable(ASLayout * _Nonnull sublayout) {
     _ASGalleryLayoutItem *item = ASDynamicCast(sublayout.layoutElement, _ASGalleryLayoutItem);
     return item ? item.collectionElement : nil;
-  }];
+  };
 }
 
 @end
@@ -23,6 +23,9 @@
 @implementation ASCollectionLayoutContext {
   Class<ASCollectionLayoutDelegate> _layoutDelegateClass;
   __weak ASCollectionLayoutCache *_layoutCache;
+  __weak ASElementMap *_previousElements;
+  NSUInteger _unchangedLeadingItemCount;
+  NSUInteger _unchangedTrailingItemCount;
 }
 
 - (instancetype)initWithViewportSize:(CGSize)viewportSize
@@ -32,6 +35,29 @@
                  layoutDelegateClass:(Class<ASCollectionLayoutDelegate>)layoutDelegateClass
                          layoutCache:(ASCollectionLayoutCache *)layoutCache
                       additionalInfo:(id)additionalInfo
+{
+  return [self initWithViewportSize:viewportSize
+               initialContentOffset:initialContentOffset
+               scrollableDirections:scrollableDirections
+                           elements:elements
+                layoutDelegateClass:layoutDelegateClass
+                        layoutCache:layoutCache
+                     additionalInfo:additionalInfo
+                   previousElements:nil
+          unchangedLeadingItemCount:0
+         unchangedTrailingItemCount:0];
+}
+
+- (instancetype)initWithViewportSize:(CGSize)viewportSize
+                initialContentOffset:(CGPoint)initialContentOffset
+                scrollableDirections:(ASScrollDirection)scrollableDirections
+                            elements:(ASElementMap *)elements
+                 layoutDelegateClass:(Class<ASCollectionLayoutDelegate>)layoutDelegateClass
+                         layoutCache:(ASCollectionLayoutCache *)layoutCache
+                      additionalInfo:(id)additionalInfo
+                    previousElements:(ASElementMap *)previousElements
+           unchangedLeadingItemCount:(NSUInteger)unchangedLeadingItemCount
+          unchangedTrailingItemCount:(NSUInteger)unchangedTrailingItemCount
 {
   self = [super init];
   if (self) {
@@ -42,6 +68,9 @@
     _layoutDelegateClass = layoutDelegateClass;
     _layoutCache = layoutCache;
     _additionalInfo = additionalInfo;
+    _previousElements = previousElements;
+    _unchangedLeadingItemCount = unchangedLeadingItemCount;
+    _unchangedTrailingItemCount = unchangedTrailingItemCount;
   }
   return self;
 }
@@ -56,7 +85,22 @@
   return _layoutCache;
 }
 
-// NOTE: Some properties, like initialContentOffset and layoutCache are ignored in -isEqualToContext: and -hash.
+- (ASElementMap *)previousElements
+{
+  return _previousElements;
+}
+
+- (NSUInteger)unchangedLeadingItemCount
+{
+  return _unchangedLeadingItemCount;
+}
+
+- (NSUInteger)unchangedTrailingItemCount
+{
+  return _unchangedTrailingItemCount;
+}
+
+// NOTE: Some properties, like initialContentOffset, layoutCache and the previous elements are ignored in -isEqualToContext: and -hash.
 // That is because contexts can be equal regardless of the content offsets or layout caches.
 - (BOOL)isEqualToContext:(ASCollectionLayoutContext *)context
 {
@@ -62,6 +62,31 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context;
 
+@optional
+
+/**
+ * @abstract Prepares and returns a new layout for the given context by updating the layout of the elements it was updated from.
+ *
+ * @param context A context that contains all elements to be laid out and any additional information needed.
+ *
+ * @param previousLayout A layout calculated by this class for a context that only differs from the given one in its elements.
+ *
+ * @param unchangedLeadingItemCount The number of items, in section order across sections, at the start of the context's elements
+ * that are the same elements as at the start of the previous layout's elements.
+ *
+ * @param unchangedTrailingItemCount The number of items at the end of the context's elements that are the same elements as at the
+ * end of the previous layout's elements. They don't overlap with the leading items, but their index paths may have changed.
+ *
+ * @return The new layout, or nil to have it calculated from scratch with +calculateLayoutWithContext:.
+ *
+ * @discussion This method is called instead of +calculateLayoutWithContext: for batch updates, if the previous layout is still cached.
+ * It has the same requirements. Appending a page of items to a long list should only cost as much as laying out the new items.
+ */
++ (nullable ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context
+                                                  previousLayout:(ASCollectionLayoutState *)previousLayout
+                                       unchangedLeadingItemCount:(NSUInteger)unchangedLeadingItemCount
+                                      unchangedTrailingItemCount:(NSUInteger)unchangedTrailingItemCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
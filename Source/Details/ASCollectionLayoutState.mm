@@ -21,10 +21,13 @@
 #import <AsyncDisplayKit/ASElementMap.h>
 #import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASLayoutSpecUtilities.h>
-#import <AsyncDisplayKit/ASPageTable.h>
 #import <AsyncDisplayKit/ASThread.h>
 
+#import <objc/runtime.h>
+
+#import <algorithm>
 #import <queue>
+#import <vector>
 
 @implementation NSMapTable (ASCollectionLayoutConvenience)
 
@@ -35,13 +38,106 @@
 
 @end
 
+/**
+ * An index of layout attributes by frame. Entries are sorted by where they start along the scrollable axis, next to
+ * the furthest any entry up to them reaches along it. Both are monotonic, so a rect query binary searches the run of
+ * entries that can intersect the rect and only tests those. Queries don't allocate.
+ *
+ * Entries can be removed. They are only marked as such, so an index that is mostly removed still scans them.
+ *
+ * The attributes are not retained. Not thread-safe.
+ */
+class ASCollectionLayoutSpatialIndex {
+public:
+  struct Entry {
+    CGRect frame;
+    unowned UICollectionViewLayoutAttributes *attributes;
+  };
+
+  ASCollectionLayoutSpatialIndex() : _vertical(true), _count(0) {}
+
+  ASCollectionLayoutSpatialIndex(std::vector<Entry> &&entries, bool vertical) : _entries(std::move(entries)), _vertical(vertical), _count(_entries.size())
+  {
+    std::sort(_entries.begin(), _entries.end(), [&](const Entry &a, const Entry &b) {
+      return minAlongAxis(a.frame) < minAlongAxis(b.frame);
+    });
+    _mins.reserve(_count);
+    _reaches.reserve(_count);
+    CGFloat reach = -CGFLOAT_MAX;
+    for (let &entry : _entries) {
+      _mins.push_back(minAlongAxis(entry.frame));
+      reach = MAX(reach, maxAlongAxis(entry.frame));
+      _reaches.push_back(reach);
+    }
+    _removed.assign(_count, false);
+  }
+
+  /// The number of entries that haven't been removed.
+  NSUInteger count() const { return _count; }
+
+  /// The number of bytes taken by the index itself, not including the attributes.
+  NSUInteger memoryCost() const
+  {
+    return _entries.capacity() * sizeof(Entry) + (_mins.capacity() + _reaches.capacity()) * sizeof(CGFloat) + _removed.capacity() / 8;
+  }
+
+  /// Calls body with the attributes of every entry whose frame intersects the rect, in order along the scrollable axis.
+  template <typename F>
+  void enumerateEntriesInRect(CGRect rect, F body) const
+  {
+    let range = rangeForRect(rect);
+    for (NSUInteger i = range.first; i < range.second; i++) {
+      if (!_removed[i] && CGRectIntersectsRect(rect, _entries[i].frame)) {
+        body(_entries[i].attributes);
+      }
+    }
+  }
+
+  /// Like enumerateEntriesInRect, but removes the entries as well.
+  template <typename F>
+  void removeEntriesInRect(CGRect rect, F body)
+  {
+    let range = rangeForRect(rect);
+    for (NSUInteger i = range.first; i < range.second; i++) {
+      if (!_removed[i] && CGRectIntersectsRect(rect, _entries[i].frame)) {
+        _removed[i] = true;
+        _count--;
+        body(_entries[i].attributes);
+      }
+    }
+  }
+
+private:
+  std::vector<Entry> _entries;
+  std::vector<CGFloat> _mins;
+  std::vector<CGFloat> _reaches;
+  std::vector<bool> _removed;
+  bool _vertical;
+  NSUInteger _count;
+
+  CGFloat minAlongAxis(CGRect frame) const { return _vertical ? CGRectGetMinY(frame) : CGRectGetMinX(frame); }
+  CGFloat maxAlongAxis(CGRect frame) const { return _vertical ? CGRectGetMaxY(frame) : CGRectGetMaxX(frame); }
+
+  /// The entries that can intersect the rect: the ones that reach past its start and start before its end.
+  std::pair<NSUInteger, NSUInteger> rangeForRect(CGRect rect) const
+  {
+    if (_count == 0 || CGRectIsNull(rect) || CGRectIsEmpty(rect)) {
+      return {0, 0};
+    }
+    NSUInteger begin = std::upper_bound(_reaches.begin(), _reaches.end(), minAlongAxis(rect)) - _reaches.begin();
+    NSUInteger end = std::lower_bound(_mins.begin(), _mins.end(), maxAlongAxis(rect)) - _mins.begin();
+    return {begin, MAX(begin, end)};
+  }
+};
+
 @implementation ASCollectionLayoutState {
   ASDN::Mutex __instanceLock__;
   CGSize _contentSize;
   ASCollectionLayoutContext *_context;
   NSMapTable<ASCollectionElement *, UICollectionViewLayoutAttributes *> *_elementToLayoutAttributesTable;
-  ASPageToLayoutAttributesTable *_pageToLayoutAttributesTable;
-  ASPageToLayoutAttributesTable *_unmeasuredPageToLayoutAttributesTable;
+  ASCollectionLayoutSpatialIndex _layoutAttributesIndex;
+  ASCollectionLayoutSpatialIndex _unmeasuredLayoutAttributesIndex; // Guarded by __instanceLock__
+  NSUInteger _cost;
 }
 
 - (instancetype)initWithContext:(ASCollectionLayoutContext *)context
@@ -110,9 +206,33 @@ elementToLayoutAttributesTable:[NSMapTable elementToLayoutAttributesTable]];
     _context = context;
     _contentSize = contentSize;
     _elementToLayoutAttributesTable = [table copy]; // Copy the given table to make sure clients can't mutate it after this point.
-    CGSize pageSize = context.viewportSize;
-    _pageToLayoutAttributesTable = [ASPageTable pageTableWithLayoutAttributes:table.objectEnumerator contentSize:contentSize pageSize:pageSize];
-    _unmeasuredPageToLayoutAttributesTable = [ASCollectionLayoutState _unmeasuredLayoutAttributesTableFromTable:table contentSize:contentSize pageSize:pageSize];
+
+    // The indexes don't retain the attributes. The table above does, for as long as this object lives.
+    std::vector<ASCollectionLayoutSpatialIndex::Entry> entries;
+    std::vector<ASCollectionLayoutSpatialIndex::Entry> unmeasuredEntries;
+    entries.reserve(_elementToLayoutAttributesTable.count);
+    for (ASCollectionElement *element in _elementToLayoutAttributesTable) {
+      UICollectionViewLayoutAttributes *attrs = [_elementToLayoutAttributesTable objectForKey:element];
+      CGRect frame = attrs.frame;
+      entries.push_back({frame, attrs});
+      ASCellNode *node = element.nodeIfAllocated;
+      if (node == nil || CGSizeEqualToSize(node.calculatedSize, frame.size) == NO) {
+        unmeasuredEntries.push_back({frame, attrs});
+      }
+    }
+    // Index along the scrollable axis, which is the longer one.
+    bool vertical = (contentSize.height >= contentSize.width);
+    _layoutAttributesIndex = ASCollectionLayoutSpatialIndex(std::move(entries), vertical);
+    _unmeasuredLayoutAttributesIndex = ASCollectionLayoutSpatialIndex(std::move(unmeasuredEntries), vertical);
+
+    // Each attributes object, plus a key and a value slot in the table.
+    static NSUInteger attributesCost;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+      attributesCost = class_getInstanceSize([UICollectionViewLayoutAttributes class]) + 2 * sizeof(void *);
+    });
+    _cost = class_getInstanceSize([self class]) + _elementToLayoutAttributesTable.count * attributesCost
+            + _layoutAttributesIndex.memoryCost() + _unmeasuredLayoutAttributesIndex.memoryCost();
   }
   return self;
 }
@@ -127,6 +247,11 @@ elementToLayoutAttributesTable:[NSMapTable elementToLayoutAttributesTable]];
   return _contentSize;
 }
 
+- (NSUInteger)cost
+{
+  return _cost;
+}
+
 - (NSArray<UICollectionViewLayoutAttributes *> *)allLayoutAttributes
 {
   return [_elementToLayoutAttributesTable.objectEnumerator allObjects];
@@ -152,108 +277,24 @@ elementToLayoutAttributesTable:[NSMapTable elementToLayoutAttributesTable]];
 
 - (NSArray<UICollectionViewLayoutAttributes *> *)layoutAttributesForElementsInRect:(CGRect)rect
 {
-  CGSize pageSize = _context.viewportSize;
-  NSPointerArray *pages = ASPageCoordinatesForPagesThatIntersectRect(rect, _contentSize, pageSize);
-  if (pages.count == 0) {
-    return @[];
-  }
-
-  // Use a set here because some items may span multiple pages
-  let result = [[NSMutableSet<UICollectionViewLayoutAttributes *> alloc] init];
-  for (id pagePtr in pages) {
-    ASPageCoordinate page = (ASPageCoordinate)pagePtr;
-    NSArray<UICollectionViewLayoutAttributes *> *allAttrs = [_pageToLayoutAttributesTable objectForPage:page];
-    if (allAttrs.count > 0) {
-      CGRect pageRect = ASPageCoordinateGetPageRect(page, pageSize);
-
-      if (CGRectContainsRect(rect, pageRect)) {
-        [result addObjectsFromArray:allAttrs];
-      } else {
-        for (UICollectionViewLayoutAttributes *attrs in allAttrs) {
-          if (CGRectIntersectsRect(rect, attrs.frame)) {
-            [result addObject:attrs];
-          }
-        }
-      }
-    }
-  }
-
-  return [result allObjects];
+  let result = [[NSMutableArray<UICollectionViewLayoutAttributes *> alloc] init];
+  _layoutAttributesIndex.enumerateEntriesInRect(rect, [&](UICollectionViewLayoutAttributes *attrs) {
+    [result addObject:attrs];
+  });
+  return result;
 }
 
-- (ASPageToLayoutAttributesTable *)getAndRemoveUnmeasuredLayoutAttributesPageTableInRect:(CGRect)rect
+- (NSArray<UICollectionViewLayoutAttributes *> *)getAndRemoveUnmeasuredLayoutAttributesInRect:(CGRect)rect
 {
-  CGSize pageSize = _context.viewportSize;
-  CGSize contentSize = _contentSize;
-
   ASDN::MutexLocker l(__instanceLock__);
-  if (_unmeasuredPageToLayoutAttributesTable.count == 0 || CGRectIsNull(rect) || CGRectIsEmpty(rect) || CGSizeEqualToSize(CGSizeZero, contentSize) || CGSizeEqualToSize(CGSizeZero, pageSize)) {
-    return nil;
-  }
-
-  // Step 1: Determine all the pages that intersect the specified rect
-  NSPointerArray *pagesInRect = ASPageCoordinatesForPagesThatIntersectRect(rect, contentSize, pageSize);
-  if (pagesInRect.count == 0) {
-    return nil;
-  }
-
-  // Step 2: Filter out attributes in these pages that intersect the specified rect.
-  ASPageToLayoutAttributesTable *result = nil;
-  for (id pagePtr in pagesInRect) {
-    ASPageCoordinate page = (ASPageCoordinate)pagePtr;
-    NSMutableArray *attrsInPage = [_unmeasuredPageToLayoutAttributesTable objectForPage:page];
-    if (attrsInPage.count == 0) {
-      continue;
-    }
-
-    NSMutableArray *intersectingAttrsInPage = nil;
-    CGRect pageRect = ASPageCoordinateGetPageRect(page, pageSize);
-    if (CGRectContainsRect(rect, pageRect)) {
-      // This page fits well within the specified rect. Simply return all of its attributes.
-      intersectingAttrsInPage = attrsInPage;
-    } else {
-      // The page intersects the specified rect. Some attributes in this page are returned, some are not.
-      for (UICollectionViewLayoutAttributes *attrs in attrsInPage) {
-        if (CGRectIntersectsRect(rect, attrs.frame)) {
-          if (intersectingAttrsInPage == nil) {
-            intersectingAttrsInPage = [[NSMutableArray alloc] init];
-          }
-          [intersectingAttrsInPage addObject:attrs];
-        }
-      }
+  NSMutableArray<UICollectionViewLayoutAttributes *> *result = nil;
+  _unmeasuredLayoutAttributesIndex.removeEntriesInRect(rect, [&](UICollectionViewLayoutAttributes *attrs) {
+    if (result == nil) {
+      result = [[NSMutableArray alloc] init];
     }
-
-    if (intersectingAttrsInPage.count > 0) {
-      if (attrsInPage.count == intersectingAttrsInPage.count) {
-        [_unmeasuredPageToLayoutAttributesTable removeObjectForPage:page];
-      } else {
-        [attrsInPage removeObjectsInArray:intersectingAttrsInPage];
-      }
-      if (result == nil) {
-        result = [ASPageTable pageTableForStrongObjectPointers];
-      }
-      [result setObject:intersectingAttrsInPage forPage:page];
-    }
-  }
-
+    [result addObject:attrs];
+  });
   return result;
 }
 
-#pragma mark - Private methods
-
-+ (ASPageToLayoutAttributesTable *)_unmeasuredLayoutAttributesTableFromTable:(NSMapTable<ASCollectionElement *, UICollectionViewLayoutAttributes *> *)table
-                                                                 contentSize:(CGSize)contentSize
-                                                                    pageSize:(CGSize)pageSize
-{
-  NSMutableArray<UICollectionViewLayoutAttributes *> *unmeasuredAttrs = [[NSMutableArray alloc] init];
-  for (ASCollectionElement *element in table) {
-    UICollectionViewLayoutAttributes *attrs = [table objectForKey:element];
-    if (element.nodeIfAllocated == nil || CGSizeEqualToSize(element.nodeIfAllocated.calculatedSize, attrs.frame.size) == NO) {
-      [unmeasuredAttrs addObject:attrs];
-    }
-  }
-
-  return [ASPageTable pageTableWithLayoutAttributes:unmeasuredAttrs contentSize:contentSize pageSize:pageSize];
-}
-
 @end
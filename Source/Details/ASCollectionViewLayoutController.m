@@ -129,9 +129,10 @@ typedef struct ASRangeGeometry ASRangeGeometry;
 - (CGRect)rangeBoundsWithScrollDirection:(ASScrollDirection)scrollDirection
                    rangeTuningParameters:(ASRangeTuningParameters)tuningParameters
 {
-  CGRect rect = _collectionView.bounds;
-  
-  return CGRectExpandToRangeWithScrollableDirections(rect, tuningParameters, [_collectionView scrollableDirections], scrollDirection);
+  return [self rangeBoundsOfScrollView:_collectionView
+                  scrollableDirections:[_collectionView scrollableDirections]
+                       scrollDirection:scrollDirection
+                 rangeTuningParameters:tuningParameters];
 }
 
 @end
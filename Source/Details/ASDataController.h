@@ -50,6 +50,31 @@ typedef NSUInteger ASDataControllerAnimationOptions;
 AS_EXTERN NSString * const ASDataControllerRowNodeKind;
 AS_EXTERN NSString * const ASCollectionInvalidUpdateException;
 
+/**
+ * Statistics about the updates of a data controller, for instrumentation. Durations are of the most recent update
+ * that reached the given stage.
+ */
+typedef struct {
+  /// The number of change sets waiting to be merged into the next update. See exp_coalesced_batch_updates.
+  NSUInteger queuedChangeSetCount;
+  /// The number of updates latched into the pending map that haven't been handed to the delegate yet.
+  NSUInteger inFlightUpdateCount;
+  /// The most updates that were in flight at once.
+  NSUInteger maxInFlightUpdateCount;
+  /// The number of updates handed to the delegate so far.
+  NSUInteger deliveredUpdateCount;
+  /// Main thread time spent waiting for earlier updates. Only nonzero with synchronous data loading.
+  NSTimeInterval mainThreadWaitDuration;
+  /// Main thread time spent validating the change set and latching the new pending map.
+  NSTimeInterval latchDuration;
+  /// Time spent on the editing queue behind earlier updates before preparing nodes.
+  NSTimeInterval queueWaitDuration;
+  /// Time spent allocating and measuring the nodes, or calculating the layout with the layout delegate.
+  NSTimeInterval preparationDuration;
+  /// Time between the nodes being prepared and the update being handed to the delegate on the main thread.
+  NSTimeInterval deliveryDuration;
+} ASDataControllerUpdateStatistics;
+
 /**
  Data source for data controller
  It will be invoked in the same thread as the api call of ASDataController.
@@ -100,6 +125,20 @@ AS_EXTERN NSString * const ASCollectionInvalidUpdateException;
 
 - (nullable id<ASSectionContext>)dataController:(ASDataController *)dataController contextForSection:(NSInteger)section;
 
+/**
+ The elements that are currently on screen. Nodes are allocated and measured outward from these elements, so that
+ the ones the user sees first are ready first.
+ */
+- (nullable NSHashTable<ASCollectionElement *> *)visibleElementsForDataController:(ASDataController *)dataController;
+
+/**
+ Whether the view only asks for the sizes of the elements it is about to display, e.g. a table view with estimated
+ row heights. If so, updates are delivered as soon as the elements on and around the screen are measured, and the
+ others are measured afterwards. Otherwise the view asks for every size when it applies an update, so updates are
+ delivered once all elements are measured. Defaults to NO.
+ */
+- (BOOL)dataControllerMeasuresElementsOnDemand:(ASDataController *)dataController;
+
 @end
 
 /**
@@ -148,6 +187,18 @@ AS_EXTERN NSString * const ASCollectionInvalidUpdateException;
  */
 + (ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context;
 
+@optional
+
+/**
+ * @abstract Returns a layout context for the given elements, which the given change set produced from the previous elements.
+ * The layout of the previous elements can be updated instead of calculated from scratch.
+ *
+ * @discussion This method will be called on main thread, for batch updates only.
+ */
+- (ASCollectionLayoutContext *)layoutContextWithElements:(ASElementMap *)elements
+                                        previousElements:(ASElementMap *)previousElements
+                                               changeSet:(_ASHierarchyChangeSet *)changeSet;
+
 @end
 
 /**
@@ -257,6 +308,14 @@ AS_EXTERN NSString * const ASCollectionInvalidUpdateException;
  */
 - (void)relayoutNodes:(id<NSFastEnumeration>)nodes nodesSizeChanged:(NSMutableArray<ASCellNode *> *)nodesSizesChanged;
 
+/**
+ * Statistics about the updates processed so far. Updates are latched on the main thread, then prepared in order
+ * on a background queue while later updates are latched, then handed to the delegate in order.
+ *
+ * This property can be read on any thread.
+ */
+@property (readonly) ASDataControllerUpdateStatistics updateStatistics;
+
 /**
  * See ASCollectionNode.h for full documentation of these methods.
  */
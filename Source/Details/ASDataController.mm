@@ -17,7 +17,9 @@
 
 #import <AsyncDisplayKit/ASDataController.h>
 
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 #import <AsyncDisplayKit/_ASHierarchyChangeSet.h>
 #import <AsyncDisplayKit/_ASScopeTimer.h>
@@ -26,6 +28,7 @@
 #import <AsyncDisplayKit/ASCollectionElement.h>
 #import <AsyncDisplayKit/ASCollectionLayoutContext.h>
 #import <AsyncDisplayKit/ASCollectionLayoutState.h>
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
 #import <AsyncDisplayKit/ASDispatch.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
 #import <AsyncDisplayKit/ASElementMap.h>
@@ -52,6 +55,14 @@
 const static char * kASDataControllerEditingQueueKey = "kASDataControllerEditingQueueKey";
 const static char * kASDataControllerEditingQueueContext = "kASDataControllerEditingQueueContext";
 
+/**
+ * Smaller batches are allocated on the calling thread. Unlike a stack child, each element is a cell node that is
+ * allocated and laid out with its whole subtree: at the 170-500 ns per node of ASStackLayoutSpecPerformanceTests, the
+ * stack math of a 20 node cell alone takes 5-10 µs. So fewer elements than stack children make up for the ~10 µs it
+ * takes to hand work to a helper and wake the caller again.
+ */
+static const size_t kASDataControllerMinimumConcurrentNodeCount = 4;
+
 NSString * const ASDataControllerRowNodeKind = @"_ASDataControllerRowNodeKind";
 NSString * const ASCollectionInvalidUpdateException = @"ASCollectionInvalidUpdateException";
 
@@ -72,6 +83,12 @@ typedef void (^ASDataControllerSynchronizationBlock)();
   dispatch_queue_t _editingTransactionQueue;  // Serial background queue.  Dispatches concurrent layout and manages _editingNodes.
   dispatch_group_t _editingTransactionGroup;  // Group of all edit transaction blocks. Useful for waiting.
   std::atomic<int> _editingTransactionGroupCount;
+
+  NSMutableArray<_ASHierarchyChangeSet *> *_pendingChangeSets;  // Main thread only. Change sets waiting to be merged.
+  BOOL _pendingChangeSetsFlushScheduled;                         // Main thread only.
+
+  ASDN::Mutex _updateStatisticsLock;
+  ASDataControllerUpdateStatistics _updateStatistics;  // Guarded by _updateStatisticsLock.
   
   BOOL _initialReloadDataHasBeenCalled;
 
@@ -85,6 +102,8 @@ typedef void (^ASDataControllerSynchronizationBlock)();
     unsigned int constrainedSizeForNodeAtIndexPath:1;
     unsigned int constrainedSizeForSupplementaryNodeOfKindAtIndexPath:1;
     unsigned int contextForSection:1;
+    unsigned int visibleElementsForDataController:1;
+    unsigned int measuresElementsOnDemand:1;
   } _dataSourceFlags;
 }
 
@@ -111,6 +130,8 @@ typedef void (^ASDataControllerSynchronizationBlock)();
   _dataSourceFlags.constrainedSizeForNodeAtIndexPath = [_dataSource respondsToSelector:@selector(dataController:constrainedSizeForNodeAtIndexPath:)];
   _dataSourceFlags.constrainedSizeForSupplementaryNodeOfKindAtIndexPath = [_dataSource respondsToSelector:@selector(dataController:constrainedSizeForSupplementaryNodeOfKind:atIndexPath:)];
   _dataSourceFlags.contextForSection = [_dataSource respondsToSelector:@selector(dataController:contextForSection:)];
+  _dataSourceFlags.visibleElementsForDataController = [_dataSource respondsToSelector:@selector(visibleElementsForDataController:)];
+  _dataSourceFlags.measuresElementsOnDemand = [_dataSource respondsToSelector:@selector(dataControllerMeasuresElementsOnDemand:)];
   
 #if ASEVENTLOG_ENABLE
   _eventLog = eventLog;
@@ -129,6 +150,8 @@ typedef void (^ASDataControllerSynchronizationBlock)();
   _editingTransactionQueue = dispatch_queue_create(queueName, DISPATCH_QUEUE_SERIAL);
   dispatch_queue_set_specific(_editingTransactionQueue, &kASDataControllerEditingQueueKey, &kASDataControllerEditingQueueContext, NULL);
   _editingTransactionGroup = dispatch_group_create();
+
+  _pendingChangeSets = [[NSMutableArray alloc] init];
   
   return self;
 }
@@ -149,7 +172,10 @@ typedef void (^ASDataControllerSynchronizationBlock)();
 
 #pragma mark - Cell Layout
 
-- (void)_allocateNodesFromElements:(NSArray<ASCollectionElement *> *)elements completion:(ASDataControllerCompletionBlock)completionHandler
+- (void)_allocateNodesFromElements:(NSArray<ASCollectionElement *> *)elements
+                   firstPhaseCount:(NSUInteger)firstPhaseCount
+               deliversUpdateEarly:(BOOL)deliversUpdateEarly
+                        completion:(ASDataControllerCompletionBlock)completionHandler
 {
   ASSERT_ON_EDITING_QUEUE;
   
@@ -165,33 +191,171 @@ typedef void (^ASDataControllerSynchronizationBlock)();
   {
     as_activity_create_for_scope("Data controller batch");
 
-    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
-    ASDispatchApply(nodeCount, queue, 0, ^(size_t i) {
-      __strong id<ASDataControllerSource> strongDataSource = weakDataSource;
-      if (strongDataSource == nil) {
-        return;
-      }
+    // Phase 1: the elements on screen and about a screenful around it, at high priority.
+    firstPhaseCount = MIN(firstPhaseCount, nodeCount);
+    [self _allocateNodesFromElements:elements
+                             inRange:NSMakeRange(0, firstPhaseCount)
+                               queue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+                          dataSource:weakDataSource];
+  }
 
-      // Allocate the node.
-      ASCollectionElement *context = elements[i];
-      ASCellNode *node = context.node;
-      if (node == nil) {
-        ASDisplayNodeAssertNotNil(node, @"Node block created nil node; %@, %@", self, strongDataSource);
-        node = [[ASCellNode alloc] init]; // Fallback to avoid crash for production apps.
-      }
+  // If the view only asks for the sizes it displays, the update is delivered as soon as the first screen is ready.
+  // Otherwise it would ask for the sizes of the elements of phase 2 right away and measure them on the main thread.
+  if (deliversUpdateEarly) {
+    completionHandler();
+  }
 
-      // Layout the node if the size range is valid.
-      ASSizeRange sizeRange = context.constrainedSize;
-      if (ASSizeRangeHasSignificantArea(sizeRange)) {
-        [self _layoutNode:node withConstrainedSize:sizeRange];
-      }
-    });
+  {
+    as_activity_create_for_scope("Data controller batch, second phase");
+
+    // Phase 2: everything else, nearest first. The editing queue stays busy until these are done, so the next update
+    // is prepared against fully measured nodes. If the update was delivered already, this runs at low priority while
+    // the first screen is on display.
+    long priority = deliversUpdateEarly ? DISPATCH_QUEUE_PRIORITY_LOW : DISPATCH_QUEUE_PRIORITY_DEFAULT;
+    [self _allocateNodesFromElements:elements
+                             inRange:NSMakeRange(firstPhaseCount, nodeCount - firstPhaseCount)
+                               queue:dispatch_get_global_queue(priority, 0)
+                          dataSource:weakDataSource];
+  }
+
+  if (!deliversUpdateEarly) {
+    completionHandler();
   }
 
-  completionHandler();
   ASSignpostEndCustom(ASSignpostDataControllerBatch, self, 0, (weakDataSource != nil ? ASSignpostColorDefault : ASSignpostColorRed));
 }
 
+- (void)_allocateNodesFromElements:(NSArray<ASCollectionElement *> *)elements
+                           inRange:(NSRange)range
+                             queue:(dispatch_queue_t)queue
+                        dataSource:(__weak id<ASDataControllerSource>)weakDataSource
+{
+  if (range.length == 0) {
+    return;
+  }
+
+  // Laying out the nodes may dispatch concurrent stack layouts of its own.
+  ASDispatchCooperativeApply(range.length, queue, kASDataControllerMinimumConcurrentNodeCount, ^(size_t i) {
+    __strong id<ASDataControllerSource> strongDataSource = weakDataSource;
+    if (strongDataSource == nil) {
+      return;
+    }
+
+    // Allocate the node.
+    ASCollectionElement *context = elements[range.location + i];
+    ASCellNode *node = context.node;
+    if (node == nil) {
+      ASDisplayNodeAssertNotNil(node, @"Node block created nil node; %@, %@", self, strongDataSource);
+      node = [[ASCellNode alloc] init]; // Fallback to avoid crash for production apps.
+    }
+
+    // Layout the node if the size range is valid.
+    ASSizeRange sizeRange = context.constrainedSize;
+    if (ASSizeRangeHasSignificantArea(sizeRange)) {
+      [self _layoutNode:node withConstrainedSize:sizeRange];
+    }
+  });
+}
+
+/**
+ * Orders the elements by their distance, in items across sections, from the nearest of the anchor index paths.
+ * Supplementary elements are placed at the index path they are attached to. Ties keep their original order.
+ *
+ * @param firstPhaseCount On return, the number of leading elements that are at most as far from the anchors as the
+ * anchors span, i.e. roughly the elements on screen and a screenful before and after it. If there are no anchors, the
+ * elements are returned as is and all of them are in the first phase.
+ */
+- (NSArray<ASCollectionElement *> *)_elementsByProximity:(NSArray<ASCollectionElement *> *)elements
+                                            toIndexPaths:(NSArray<NSIndexPath *> *)anchorIndexPaths
+                                                   inMap:(ASElementMap *)map
+                                         firstPhaseCount:(NSUInteger *)firstPhaseCount
+{
+  NSUInteger count = elements.count;
+  NSInteger sectionCount = map.numberOfSections;
+  *firstPhaseCount = count;
+  if (count == 0 || anchorIndexPaths.count == 0 || sectionCount == 0) {
+    return elements;
+  }
+
+  std::vector<NSInteger> sectionStarts(sectionCount + 1, 0);
+  for (NSInteger section = 0; section < sectionCount; section++) {
+    sectionStarts[section + 1] = sectionStarts[section] + [map numberOfItemsInSection:section];
+  }
+  // Anchors may come from an older map, so clamp them to this one.
+  let position = [&](NSIndexPath *indexPath) {
+    NSInteger section = MIN(MAX(indexPath.section, 0), sectionCount - 1);
+    NSInteger item = MIN(MAX(indexPath.item, 0), sectionStarts[section + 1] - sectionStarts[section]);
+    return sectionStarts[section] + item;
+  };
+
+  std::vector<NSInteger> anchors;
+  anchors.reserve(anchorIndexPaths.count);
+  for (NSIndexPath *indexPath in anchorIndexPaths) {
+    anchors.push_back(position(indexPath));
+  }
+  std::sort(anchors.begin(), anchors.end());
+  NSInteger span = anchors.back() - anchors.front() + 1;
+
+  std::vector<std::pair<NSInteger, NSUInteger>> distances;
+  distances.reserve(count);
+  NSUInteger i = 0;
+  for (ASCollectionElement *element in elements) {
+    NSIndexPath *indexPath = [map indexPathForElement:element];
+    NSInteger distance = NSIntegerMax;
+    if (indexPath != nil) {
+      NSInteger p = position(indexPath);
+      let next = std::lower_bound(anchors.begin(), anchors.end(), p);
+      if (next != anchors.end()) {
+        distance = *next - p;
+      }
+      if (next != anchors.begin()) {
+        distance = MIN(distance, p - *(next - 1));
+      }
+    }
+    distances.emplace_back(distance, i++);
+  }
+  // Pairs compare by distance first, then by original index.
+  std::sort(distances.begin(), distances.end());
+
+  NSUInteger phaseCount = 0;
+  let result = [[NSMutableArray<ASCollectionElement *> alloc] initWithCapacity:count];
+  for (let &d : distances) {
+    if (d.first <= span) {
+      phaseCount++;
+    }
+    [result addObject:elements[d.second]];
+  }
+  *firstPhaseCount = phaseCount;
+  return result;
+}
+
+/**
+ * Returns the index paths in the given map of the elements that are on screen. Elements that are no longer in the map,
+ * e.g. because they were reloaded, contribute the index path they are displayed at.
+ */
+- (NSArray<NSIndexPath *> *)_visibleIndexPathsInMap:(ASElementMap *)map
+{
+  ASDisplayNodeAssertMainThread();
+  if (!_dataSourceFlags.visibleElementsForDataController) {
+    return nil;
+  }
+
+  NSHashTable<ASCollectionElement *> *visibleElements = [_dataSource visibleElementsForDataController:self];
+  if (visibleElements.count == 0) {
+    return nil;
+  }
+
+  ASElementMap *visibleMap = self.visibleMap;
+  let indexPaths = [[NSMutableArray<NSIndexPath *> alloc] initWithCapacity:visibleElements.count];
+  for (ASCollectionElement *element in visibleElements) {
+    NSIndexPath *indexPath = [map indexPathForElement:element] ?: [visibleMap indexPathForElement:element];
+    if (indexPath != nil) {
+      [indexPaths addObject:indexPath];
+    }
+  }
+  return indexPaths;
+}
+
 /**
  * Measure and layout the given node with the constrained size range.
  */
@@ -395,7 +559,8 @@ typedef void (^ASDataControllerSynchronizationBlock)();
         NSIndexPath *oldIndexPath = [changeSet oldIndexPathForNewIndexPath:indexPath];
         if (oldIndexPath != nil) {
           ASCollectionElement *oldElement = [previousMap elementForItemAtIndexPath:oldIndexPath];
-          ASCellNode *oldNode = oldElement.node;
+          // While earlier updates are still preparing their nodes, don't allocate the old node on the main thread.
+          ASCellNode *oldNode = (_editingTransactionGroupCount > 0 ? oldElement.nodeIfAllocated : oldElement.node);
           if ([oldNode canUpdateToNodeModel:nodeModel]) {
             // Just wrap the node in a block. The collection element will -setNodeModel:
             nodeBlock = ^{
@@ -489,6 +654,7 @@ typedef void (^ASDataControllerSynchronizationBlock)();
 
 - (void)waitUntilAllUpdatesAreProcessed
 {
+  [self _flushPendingChangeSets];
   // Schedule block in main serial queue to wait until all operations are finished that are
   // where scheduled while waiting for the _editingTransactionQueue to finish
   [self _scheduleBlockOnMainSerialQueue:^{ }];
@@ -497,7 +663,7 @@ typedef void (^ASDataControllerSynchronizationBlock)();
 - (BOOL)isProcessingUpdates
 {
   ASDisplayNodeAssertMainThread();
-  return _mainSerialQueue.numberOfScheduledBlocks > 0 || _editingTransactionGroupCount > 0;
+  return _pendingChangeSets.count > 0 || _mainSerialQueue.numberOfScheduledBlocks > 0 || _editingTransactionGroupCount > 0;
 }
 
 - (void)onDidFinishProcessingUpdates:(void (^)())completion
@@ -520,6 +686,12 @@ typedef void (^ASDataControllerSynchronizationBlock)();
   }
 }
 
+- (ASDataControllerUpdateStatistics)updateStatistics
+{
+  ASDN::MutexLocker l(_updateStatisticsLock);
+  return _updateStatistics;
+}
+
 - (BOOL)isSynchronized {
   return _synchronized;
 }
@@ -541,6 +713,67 @@ typedef void (^ASDataControllerSynchronizationBlock)();
 {
   ASDisplayNodeAssertMainThread();
 
+  // Instead of waiting here for the previous update to be prepared, queue the change set. It will be merged with the
+  // other ones submitted until the end of this run loop turn and the previous update, and applied as a single update.
+  if (_initialReloadDataHasBeenCalled && !_usesSynchronousDataLoading
+      && ASActivateExperimentalFeature(ASExperimentalCoalescedBatchUpdates)) {
+    _synchronized = NO;
+    [_pendingChangeSets addObject:changeSet];
+    {
+      ASDN::MutexLocker l(_updateStatisticsLock);
+      _updateStatistics.queuedChangeSetCount = _pendingChangeSets.count;
+    }
+    [self _schedulePendingChangeSetsFlush];
+    return;
+  }
+
+  [self _flushPendingChangeSets];
+  [self _updateWithChangeSet:changeSet];
+}
+
+- (void)_schedulePendingChangeSetsFlush
+{
+  ASDisplayNodeAssertMainThread();
+  if (_pendingChangeSetsFlushScheduled) {
+    return;
+  }
+
+  // The group notifies asynchronously even if it's empty, so this runs on a later run loop turn at the earliest.
+  _pendingChangeSetsFlushScheduled = YES;
+  dispatch_group_notify(_editingTransactionGroup, dispatch_get_main_queue(), ^{
+    _pendingChangeSetsFlushScheduled = NO;
+    [self _flushPendingChangeSets];
+  });
+}
+
+- (void)_flushPendingChangeSets
+{
+  ASDisplayNodeAssertMainThread();
+  if (_pendingChangeSets.count == 0) {
+    return;
+  }
+
+  // The change sets were all created against the item counts of the last applied update, since item counts are only
+  // invalidated when an update is applied. The merged change set goes from there to the current data source.
+  _ASHierarchyChangeSet *changeSet;
+  if (_pendingChangeSets.count == 1) {
+    changeSet = _pendingChangeSets.firstObject;
+  } else {
+    as_log_debug(ASCollectionLog(), "Merging %lu batch updates %@", (unsigned long)_pendingChangeSets.count, ASViewToDisplayNode(ASDynamicCast(self.dataSource, UIView)));
+    changeSet = [_ASHierarchyChangeSet changeSetByMergingChangeSets:_pendingChangeSets];
+  }
+  [_pendingChangeSets removeAllObjects];
+  {
+    ASDN::MutexLocker l(_updateStatisticsLock);
+    _updateStatistics.queuedChangeSetCount = 0;
+  }
+  [self _updateWithChangeSet:changeSet];
+}
+
+- (void)_updateWithChangeSet:(_ASHierarchyChangeSet *)changeSet
+{
+  ASDisplayNodeAssertMainThread();
+
   _synchronized = NO;
 
   [changeSet addCompletionHandler:^(BOOL finished) {
@@ -566,11 +799,14 @@ typedef void (^ASDataControllerSynchronizationBlock)();
     as_log_debug(ASCollectionLog(), "performBatchUpdates %@ %@", ASViewToDisplayNode(ASDynamicCast(self.dataSource, UIView)), changeSet);
   }
   
+  // Earlier updates may still be preparing their nodes. The new map is built on top of the pending map, which they
+  // already latched, so there's no need to wait for them unless data loading is synchronous.
   NSTimeInterval transactionQueueFlushDuration = 0.0f;
-  {
+  if (_usesSynchronousDataLoading) {
     ASDN::ScopeTimer t(transactionQueueFlushDuration);
     dispatch_group_wait(_editingTransactionGroup, DISPATCH_TIME_FOREVER);
   }
+  NSTimeInterval latchStartTime = CACurrentMediaTime();
   
   // If the initial reloadData has not been called, just bail because we don't have our old data source counts.
   // See ASUICollectionViewTests.testThatIssuingAnUpdateBeforeInitialReloadIsUnacceptable
@@ -636,21 +872,53 @@ typedef void (^ASDataControllerSynchronizationBlock)();
 
     // Step 2: Ask layout delegate for contexts
     if (canDelegate) {
-      layoutContext = [self.layoutDelegate layoutContextWithElements:newMap];
+      id<ASDataControllerLayoutDelegate> layoutDelegate = self.layoutDelegate;
+      if (!changeSet.includesReloadData && [layoutDelegate respondsToSelector:@selector(layoutContextWithElements:previousElements:changeSet:)]) {
+        layoutContext = [layoutDelegate layoutContextWithElements:newMap previousElements:previousMap changeSet:changeSet];
+      } else {
+        layoutContext = [layoutDelegate layoutContextWithElements:newMap];
+      }
     }
   }
 
+  // The layout delegate measures outward from the visible rect itself. Otherwise, nodes are allocated outward from
+  // the elements that are currently on screen.
+  NSArray<NSIndexPath *> *visibleIndexPaths = canDelegate ? nil : [self _visibleIndexPathsInMap:newMap];
+  BOOL deliversUpdateEarly = (_dataSourceFlags.measuresElementsOnDemand && [_dataSource dataControllerMeasuresElementsOnDemand:self]);
+
   as_log_debug(ASCollectionLog(), "New content: %@", newMap.smallDescription);
 
+  NSTimeInterval enqueueTime = CACurrentMediaTime();
+  {
+    ASDN::MutexLocker l(_updateStatisticsLock);
+    _updateStatistics.mainThreadWaitDuration = transactionQueueFlushDuration;
+    _updateStatistics.latchDuration = enqueueTime - latchStartTime;
+    _updateStatistics.inFlightUpdateCount++;
+    _updateStatistics.maxInFlightUpdateCount = MAX(_updateStatistics.maxInFlightUpdateCount, _updateStatistics.inFlightUpdateCount);
+  }
+
   Class<ASDataControllerLayoutDelegate> layoutDelegateClass = [self.layoutDelegate class];
   ++_editingTransactionGroupCount;
   dispatch_group_async(_editingTransactionGroup, _editingTransactionQueue, ^{
     __block __unused os_activity_scope_state_s preparationScope = {}; // unused if deployment target < iOS10
     as_activity_scope_enter(as_activity_create("Prepare nodes for collection update", AS_ACTIVITY_CURRENT, OS_ACTIVITY_FLAG_DEFAULT), &preparationScope);
+    NSTimeInterval preparationStartTime = CACurrentMediaTime();
 
     dispatch_block_t completion = ^() {
+      NSTimeInterval preparationEndTime = CACurrentMediaTime();
+      {
+        ASDN::MutexLocker l(_updateStatisticsLock);
+        _updateStatistics.queueWaitDuration = preparationStartTime - enqueueTime;
+        _updateStatistics.preparationDuration = preparationEndTime - preparationStartTime;
+      }
       [_mainSerialQueue performBlockOnMainThread:^{
         as_activity_scope_leave(&preparationScope);
+        {
+          ASDN::MutexLocker l(_updateStatisticsLock);
+          _updateStatistics.deliveryDuration = CACurrentMediaTime() - preparationEndTime;
+          _updateStatistics.inFlightUpdateCount--;
+          _updateStatistics.deliveredUpdateCount++;
+        }
         // Step 4: Inform the delegate
         [_delegate dataController:self updateWithChangeSet:changeSet updates:^{
           // Step 5: Deploy the new data as "completed"
@@ -682,7 +950,15 @@ typedef void (^ASDataControllerSynchronizationBlock)();
           [elementsToProcess addObject:element];
         }
       }
-      [self _allocateNodesFromElements:elementsToProcess completion:completion];
+      NSUInteger firstPhaseCount;
+      NSArray<ASCollectionElement *> *orderedElements = [self _elementsByProximity:elementsToProcess
+                                                                      toIndexPaths:visibleIndexPaths
+                                                                             inMap:newMap
+                                                                   firstPhaseCount:&firstPhaseCount];
+      [self _allocateNodesFromElements:orderedElements
+                       firstPhaseCount:firstPhaseCount
+                   deliversUpdateEarly:deliversUpdateEarly
+                            completion:completion];
     }
   });
   
@@ -51,6 +51,14 @@ AS_SUBCLASSING_RESTRICTED
  */
 - (NSInteger)numberOfItemsInSection:(NSInteger)section;
 
+/**
+ * Returns the elements of the items in the given section. O(1)
+ *
+ * Maps made from one another share the arrays of the sections whose items didn't change, so a section whose array is
+ * identical in two maps has the same items in both.
+ */
+- (NSArray<ASCollectionElement *> *)itemElementsInSection:(NSInteger)section;
+
 /**
  * Returns the context object for the given section, if any. O(1)
  */
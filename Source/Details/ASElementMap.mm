@@ -0,0 +1,481 @@
+//
+//  ASElementMap.mm
+//  Texture
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the /ASDK-Licenses directory of this source tree. An additional
+//  grant of patent rights can be found in the PATENTS file in the same directory.
+//
+//  Modifications to this file made after 4/13/2017 are: Copyright (c) 2017-present,
+//  Pinterest, Inc.  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import "ASElementMap.h"
+#import <UIKit/UIKit.h>
+#import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASTwoDimensionalArrayUtils.h>
+#import <AsyncDisplayKit/ASMutableElementMap.h>
+#import <AsyncDisplayKit/ASSection.h>
+#import <AsyncDisplayKit/NSIndexSet+ASHelpers.h>
+#import <AsyncDisplayKit/ASObjectDescriptionHelpers.h>
+#import <AsyncDisplayKit/ASInternalHelpers.h>
+
+#import <vector>
+
+@interface ASElementMap () <ASDescriptionProvider>
+
+@property (nonatomic, readonly) NSArray<ASSection *> *sections;
+
+// The items, in a 2D array
+@property (nonatomic, readonly) ASCollectionElementTwoDimensionalArray *sectionsOfItems;
+
+@property (nonatomic, readonly) ASSupplementaryElementDictionary *supplementaryElements;
+
+@end
+
+/**
+ * An open addressing hash table from pointers to integers, with linear probing. It is built once with a known number
+ * of keys and is at most half full, so it never grows and needs no tombstones. Keys are not retained. NULL marks an
+ * empty slot, so it is never a key: it is not inserted and never found.
+ */
+class ASElementMapIndexTable {
+public:
+  ASElementMapIndexTable() : ASElementMapIndexTable(0) {}
+
+  explicit ASElementMapIndexTable(NSUInteger keyCount)
+  {
+    NSUInteger capacity = 8;
+    while (capacity < 2 * keyCount) {
+      capacity *= 2;
+    }
+    _slots.assign(capacity, Slot{NULL, 0});
+    _mask = capacity - 1;
+  }
+
+  void insert(const void *key, uint64_t value)
+  {
+    if (key == NULL) {
+      return;
+    }
+    for (NSUInteger i = hash(key); ; i = (i + 1) & _mask) {
+      if (_slots[i].key == NULL || _slots[i].key == key) {
+        _slots[i] = Slot{key, value};
+        return;
+      }
+    }
+  }
+
+  bool find(const void *key, uint64_t *value) const
+  {
+    if (key == NULL) {
+      return false;
+    }
+    for (NSUInteger i = hash(key); ; i = (i + 1) & _mask) {
+      if (_slots[i].key == key) {
+        *value = _slots[i].value;
+        return true;
+      } else if (_slots[i].key == NULL) {
+        return false;
+      }
+    }
+  }
+
+private:
+  struct Slot {
+    const void *key;
+    uint64_t value;
+  };
+
+  NSUInteger hash(const void *key) const
+  {
+    // Objects are 16-byte aligned, so drop the low bits and mix the rest (Fibonacci hashing).
+    return (NSUInteger)((((uintptr_t)key >> 4) * 0x9E3779B97F4A7C15ULL) >> 32) & _mask;
+  }
+
+  std::vector<Slot> _slots;
+  NSUInteger _mask;
+};
+
+ASDISPLAYNODE_INLINE uint64_t ASElementMapPackIndexPath(NSInteger section, NSInteger item)
+{
+  return ((uint64_t)section << 32) | (uint32_t)item;
+}
+
+/**
+ * One section of items and the index of each of its elements. Sections of items are immutable, so maps that share a
+ * section of items also share this object.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface _ASElementMapSection : NSObject {
+@package
+  NSArray<ASCollectionElement *> *_items;
+  // The same elements as _items, for lookups without message sends. Retained by _items.
+  std::vector<unowned ASCollectionElement *> _elements;
+  // Element -> item index
+  ASElementMapIndexTable _itemIndexes;
+}
+@end
+
+@implementation _ASElementMapSection
+
+- (instancetype)initWithItems:(NSArray<ASCollectionElement *> *)items section:(ASSection *)section
+{
+  if (self = [super init]) {
+    _items = items;
+    NSUInteger count = items.count;
+    _elements.resize(count);
+    [items getObjects:_elements.data() range:NSMakeRange(0, count)];
+    _itemIndexes = ASElementMapIndexTable(count);
+    for (NSUInteger i = 0; i < count; i++) {
+      ASCollectionElement *element = _elements[i];
+      if (element.section == nil) {
+        element.section = section;
+      }
+      ASDisplayNodeAssert(element.section == section, @"Item elements may not change sections: %@", element);
+      _itemIndexes.insert((__bridge const void *)element, i);
+    }
+  }
+  return self;
+}
+
+@end
+
+@implementation ASElementMap {
+  // Section index -> section of items. Shared with the maps that have the same section of items.
+  NSArray<_ASElementMapSection *> *_itemSections;
+  // The same sections as _itemSections, for lookups without message sends. Retained by _itemSections.
+  std::vector<unowned _ASElementMapSection *> _itemSectionList;
+  // Section -> section index
+  ASElementMapIndexTable _sectionIndexes;
+  // Supplementary element -> packed index path
+  ASElementMapIndexTable _supplementaryIndexPaths;
+  NSArray<ASCollectionElement *> *_supplementaryElementList;
+  NSUInteger _count;
+}
+
+- (instancetype)init
+{
+  return [self initWithSections:@[] items:@[] supplementaryElements:@{}];
+}
+
+- (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements
+{
+  return [self initWithSections:sections items:items itemIndexTables:nil supplementaryElements:supplementaryElements];
+}
+
+- (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items itemIndexTables:(NSArray *)itemIndexTables supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements
+{
+  NSCParameterAssert(items.count == sections.count);
+  NSCParameterAssert(itemIndexTables == nil || itemIndexTables.count == items.count);
+
+  if (self = [super init]) {
+    _sections = [sections copy];
+    // Copying an immutable section of items returns the same array, so unchanged sections are shared.
+    _sectionsOfItems = [[NSArray alloc] initWithArray:items copyItems:YES];
+    _supplementaryElements = [[NSDictionary alloc] initWithDictionary:supplementaryElements copyItems:YES];
+
+    // Reuse the sections whose items didn't change and index the others.
+    NSInteger sectionCount = _sectionsOfItems.count;
+    NSMutableArray<_ASElementMapSection *> *itemSections = [[NSMutableArray alloc] initWithCapacity:sectionCount];
+    _itemSectionList.reserve(sectionCount);
+    _sectionIndexes = ASElementMapIndexTable(sectionCount);
+    for (NSInteger s = 0; s < sectionCount; s++) {
+      NSArray *sectionOfItems = _sectionsOfItems[s];
+      _ASElementMapSection *itemSection = ASDynamicCast(itemIndexTables[s], _ASElementMapSection);
+      if (itemSection == nil || itemSection->_items != sectionOfItems) {
+        itemSection = [[_ASElementMapSection alloc] initWithItems:sectionOfItems section:_sections[s]];
+      }
+      [itemSections addObject:itemSection];
+      _itemSectionList.push_back(itemSection);
+      _sectionIndexes.insert((__bridge const void *)_sections[s], s);
+      _count += sectionOfItems.count;
+    }
+    _itemSections = itemSections;
+
+    // Supplementary elements are few, so their index paths are recorded in every map.
+    NSMutableArray<ASCollectionElement *> *supplementaryElementList = [[NSMutableArray alloc] init];
+    for (NSDictionary *supplementariesForKind in [_supplementaryElements objectEnumerator]) {
+      [supplementaryElementList addObjectsFromArray:supplementariesForKind.allValues];
+    }
+    _supplementaryIndexPaths = ASElementMapIndexTable(supplementaryElementList.count);
+    for (NSDictionary *supplementariesForKind in [_supplementaryElements objectEnumerator]) {
+      [supplementariesForKind enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *_Nonnull indexPath, ASCollectionElement * _Nonnull element, BOOL * _Nonnull stop) {
+        _supplementaryIndexPaths.insert((__bridge const void *)element, ASElementMapPackIndexPath(indexPath.section, indexPath.item));
+      }];
+    }
+    _supplementaryElementList = supplementaryElementList;
+    _count += supplementaryElementList.count;
+  }
+  return self;
+}
+
+- (NSUInteger)count
+{
+  return _count;
+}
+
+- (NSArray<NSIndexPath *> *)itemIndexPaths
+{
+  return ASIndexPathsForTwoDimensionalArray(_sectionsOfItems);
+}
+
+- (NSArray<ASCollectionElement *> *)itemElements
+{
+  return ASElementsInTwoDimensionalArray(_sectionsOfItems);
+}
+
+- (NSInteger)numberOfSections
+{
+  return _sectionsOfItems.count;
+}
+
+- (NSArray<NSString *> *)supplementaryElementKinds
+{
+  return _supplementaryElements.allKeys;
+}
+
+- (NSInteger)numberOfItemsInSection:(NSInteger)section
+{
+  if (![self sectionIndexIsValid:section assert:YES]) {
+    return 0;
+  }
+
+  return _sectionsOfItems[section].count;
+}
+
+- (NSArray<ASCollectionElement *> *)itemElementsInSection:(NSInteger)section
+{
+  if (![self sectionIndexIsValid:section assert:YES]) {
+    return @[];
+  }
+
+  return _sectionsOfItems[section];
+}
+
+- (id<ASSectionContext>)contextForSection:(NSInteger)section
+{
+  if (![self sectionIndexIsValid:section assert:NO]) {
+    return nil;
+  }
+
+  return _sections[section].context;
+}
+
+- (nullable NSIndexPath *)indexPathForElement:(ASCollectionElement *)element
+{
+  if (element == nil) {
+    return nil;
+  }
+
+  uint64_t value;
+  if (element.supplementaryElementKind != nil) {
+    if (!_supplementaryIndexPaths.find((__bridge const void *)element, &value)) {
+      return nil;
+    }
+    return [NSIndexPath indexPathForItem:(uint32_t)value inSection:(NSInteger)(value >> 32)];
+  }
+
+  // Find the element's section, then look it up in that section's index.
+  if (element.section == nil || !_sectionIndexes.find((__bridge const void *)element.section, &value)) {
+    return nil;
+  }
+  NSInteger section = (NSInteger)value;
+  if (!_itemSectionList[section]->_itemIndexes.find((__bridge const void *)element, &value)) {
+    return nil;
+  }
+  return [NSIndexPath indexPathForItem:(NSInteger)value inSection:section];
+}
+
+- (nullable NSIndexPath *)indexPathForElementIfCell:(ASCollectionElement *)element
+{
+  if (element.supplementaryElementKind == nil) {
+    return [self indexPathForElement:element];
+  } else {
+    return nil;
+  }
+}
+
+- (nullable ASCollectionElement *)elementForItemAtIndexPath:(NSIndexPath *)indexPath
+{
+  NSInteger section, item;
+  if (![self itemIndexPathIsValid:indexPath assert:NO item:&item section:&section]) {
+    return nil;
+  }
+
+  return _itemSectionList[section]->_elements[item];
+}
+
+- (nullable ASCollectionElement *)supplementaryElementOfKind:(NSString *)supplementaryElementKind atIndexPath:(NSIndexPath *)indexPath
+{
+  return _supplementaryElements[supplementaryElementKind][indexPath];
+}
+
+- (ASCollectionElement *)elementForLayoutAttributes:(UICollectionViewLayoutAttributes *)layoutAttributes
+{
+  switch (layoutAttributes.representedElementCategory) {
+    case UICollectionElementCategoryCell:
+      // Cell
+      return [self elementForItemAtIndexPath:layoutAttributes.indexPath];
+    case UICollectionElementCategorySupplementaryView:
+      // Supplementary element.
+      return [self supplementaryElementOfKind:layoutAttributes.representedElementKind atIndexPath:layoutAttributes.indexPath];
+    case UICollectionElementCategoryDecorationView:
+      // No support for decoration views.
+      return nil;
+  }
+}
+
+- (NSIndexPath *)convertIndexPath:(NSIndexPath *)indexPath fromMap:(ASElementMap *)map
+{
+  if (indexPath.item == NSNotFound) {
+    // Section index path
+    NSInteger result = [self convertSection:indexPath.section fromMap:map];
+    return (result != NSNotFound ? [NSIndexPath indexPathWithIndex:result] : nil);
+  } else {
+    // Item index path
+    ASCollectionElement *element = [map elementForItemAtIndexPath:indexPath];
+    return [self indexPathForElement:element];
+  }
+}
+
+- (NSInteger)convertSection:(NSInteger)sectionIndex fromMap:(ASElementMap *)map
+{
+  if (![map sectionIndexIsValid:sectionIndex assert:YES]) {
+    return NSNotFound;
+  }
+
+  ASSection *section = map.sections[sectionIndex];
+  uint64_t result;
+  return _sectionIndexes.find((__bridge const void *)section, &result) ? (NSInteger)result : NSNotFound;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+  return self;
+}
+
+// NSMutableCopying conformance is declared in ASMutableElementMap.h, so that most consumers of ASElementMap don't bother with it.
+#pragma mark - NSMutableCopying
+
+- (id)mutableCopyWithZone:(NSZone *)zone
+{
+  return [[ASMutableElementMap alloc] initWithSections:_sections items:_sectionsOfItems itemIndexTables:_itemSections supplementaryElements:_supplementaryElements];
+}
+
+#pragma mark - NSFastEnumeration
+
+/**
+ * Enumerates the items section by section, then the supplementary elements.
+ * state->extra[0] is the current section, or the number of sections once items are done. state->extra[1] is the
+ * next item in that section, or the next supplementary element.
+ */
+- (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state objects:(id  _Nullable __unsafe_unretained [])buffer count:(NSUInteger)len
+{
+  if (state->state == 0) {
+    state->state = 1;
+    // The map is immutable.
+    state->mutationsPtr = &state->extra[4];
+    state->extra[0] = 0;
+    state->extra[1] = 0;
+  }
+
+  NSUInteger sectionCount = _sectionsOfItems.count;
+  NSUInteger section = state->extra[0];
+  NSUInteger index = state->extra[1];
+  while (section < sectionCount && index >= _sectionsOfItems[section].count) {
+    section++;
+    index = 0;
+  }
+
+  NSArray<ASCollectionElement *> *elements = (section < sectionCount ? _sectionsOfItems[section] : _supplementaryElementList);
+  NSUInteger count = MIN(len, elements.count - MIN(index, elements.count));
+  [elements getObjects:buffer range:NSMakeRange(index, count)];
+
+  state->itemsPtr = buffer;
+  state->extra[0] = section;
+  state->extra[1] = index + count;
+  return count;
+}
+
+- (NSString *)smallDescription
+{
+  NSMutableArray *sectionDescriptions = [NSMutableArray array];
+
+  NSUInteger i = 0;
+  for (NSArray *section in _sectionsOfItems) {
+    [sectionDescriptions addObject:[NSString stringWithFormat:@"<S%tu: %tu>", i, section.count]];
+    i++;
+  }
+  return ASObjectDescriptionMakeWithoutObject(@[ @{ @"itemCounts": sectionDescriptions }]);
+}
+
+#pragma mark - ASDescriptionProvider
+
+- (NSString *)description
+{
+  return ASObjectDescriptionMake(self, [self propertiesForDescription]);
+}
+
+- (NSMutableArray<NSDictionary *> *)propertiesForDescription
+{
+  NSMutableArray *result = [NSMutableArray array];
+  [result addObject:@{ @"items" : _sectionsOfItems }];
+  [result addObject:@{ @"supplementaryElements" : _supplementaryElements }];
+  return result;
+}
+
+#pragma mark - Internal
+
+/**
+ * Fails assert + return NO if section is out of bounds.
+ */
+- (BOOL)sectionIndexIsValid:(NSInteger)section assert:(BOOL)assert
+{
+  NSInteger sectionCount = _sectionsOfItems.count;
+  if (section >= sectionCount || section < 0) {
+    if (assert) {
+      ASDisplayNodeFailAssert(@"Invalid section index %ld when there are only %ld sections!", (long)section, (long)sectionCount);
+    }
+    return NO;
+  } else {
+    return YES;
+  }
+}
+
+/**
+ * If indexPath is nil, just returns NO.
+ * If indexPath is invalid, fails assertion and returns NO.
+ * Otherwise returns YES and sets the item & section.
+ */
+- (BOOL)itemIndexPathIsValid:(NSIndexPath *)indexPath assert:(BOOL)assert item:(out NSInteger *)outItem section:(out NSInteger *)outSection
+{
+  if (indexPath == nil) {
+    return NO;
+  }
+
+  NSInteger section = indexPath.section;
+  if (![self sectionIndexIsValid:section assert:assert]) {
+    return NO;
+  }
+
+  NSInteger itemCount = _sectionsOfItems[section].count;
+  NSInteger item = indexPath.item;
+  if (item >= itemCount || item < 0) {
+    if (assert) {
+      ASDisplayNodeFailAssert(@"Invalid item index %ld in section %ld which only has %ld items!", (long)item, (long)section, (long)itemCount);
+    }
+    return NO;
+  }
+  *outItem = item;
+  *outSection = section;
+  return YES;
+}
+
+@end
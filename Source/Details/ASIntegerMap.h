@@ -16,7 +16,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
- * An objective-C wrapper for unordered_map.
+ * An objective-C wrapper for unordered_map. Maps created for an update store ranges of shifted indexes instead.
  */
 AS_SUBCLASSING_RESTRICTED
 @interface ASIntegerMap : NSObject <NSCopying>
@@ -26,6 +26,9 @@ AS_SUBCLASSING_RESTRICTED
  *
  * If oldCount is 0, returns the empty map.
  * If deleted and inserted are empty, returns the identity map.
+ *
+ * The map takes memory proportional to the number of deleted and inserted ranges, and lookups are a binary search
+ * over them, regardless of oldCount.
  */
 + (ASIntegerMap *)mapForUpdateWithOldCount:(NSInteger)oldCount
                                    deleted:(nullable NSIndexSet *)deleted
@@ -63,7 +66,8 @@ AS_SUBCLASSING_RESTRICTED
 - (void)setInteger:(NSInteger)value forKey:(NSInteger)key;
 
 /**
- * Create and return a map with the inverse mapping.
+ * Create and return a map with the inverse mapping. The inverse of a map created for an update takes time
+ * proportional to its number of ranges.
  */
 - (ASIntegerMap *)inverseMap;
 
@@ -12,18 +12,37 @@
 
 #import "ASIntegerMap.h"
 #import <AsyncDisplayKit/ASAssert.h>
+#import <algorithm>
 #import <unordered_map>
+#import <vector>
 #import <AsyncDisplayKit/NSIndexSet+ASHelpers.h>
 #import <AsyncDisplayKit/ASObjectDescriptionHelpers.h>
 
 /**
- * This is just a friendly Objective-C interface to unordered_map<NSInteger, NSInteger>
+ * A run of consecutive keys that map to consecutive values: key + i -> value + i for 0 <= i < length.
+ */
+struct ASIntegerMapRun {
+  NSInteger key;
+  NSInteger value;
+  NSInteger length;
+
+  bool operator==(const ASIntegerMapRun &other) const
+  {
+    return key == other.key && value == other.value && length == other.length;
+  }
+};
+
+/**
+ * This is a friendly Objective-C interface to unordered_map<NSInteger, NSInteger>. Maps created for an update
+ * store runs of shifted indexes instead, sorted by key, so they take memory proportional to the number of changed
+ * ranges rather than the number of items.
  */
 @interface ASIntegerMap () <ASDescriptionProvider>
 @end
 
 @implementation ASIntegerMap {
   std::unordered_map<NSInteger, NSInteger> _map;
+  std::vector<ASIntegerMapRun> _runs;
   BOOL _isIdentity;
   BOOL _isEmpty;
   BOOL _immutable; // identity map and empty mape are immutable.
@@ -65,32 +84,45 @@
     return ASIntegerMap.identityMap;
   }
 
+  // The surviving old indexes, in order, move to the new indexes that weren't inserted, in order. Walk the gaps
+  // between deleted ranges and the gaps between inserted ranges side by side and record a run for each overlap.
   ASIntegerMap *result = [[ASIntegerMap alloc] init];
-  // Start with the old indexes
-  NSMutableIndexSet *indexes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, oldCount)];
-
-  // Descending order, shift deleted ranges left
-  [deletions enumerateRangesWithOptions:NSEnumerationReverse usingBlock:^(NSRange range, BOOL * _Nonnull stop) {
-    [indexes shiftIndexesStartingAtIndex:NSMaxRange(range) by:-range.length];
+  std::vector<NSRange> deletedRanges, insertedRanges;
+  [deletions enumerateRangesUsingBlock:^(NSRange range, BOOL * _Nonnull stop) {
+    deletedRanges.push_back(range);
   }];
-
-  // Ascending order, shift inserted ranges right
   [insertions enumerateRangesUsingBlock:^(NSRange range, BOOL * _Nonnull stop) {
-    [indexes shiftIndexesStartingAtIndex:range.location by:range.length];
+    insertedRanges.push_back(range);
   }];
 
-  __block NSInteger oldIndex = 0;
-  [indexes enumerateRangesUsingBlock:^(NSRange range, BOOL * _Nonnull stop) {
-    // Note we advance oldIndex unconditionally, not newIndex
-    for (NSInteger newIndex = range.location; newIndex < NSMaxRange(range); oldIndex++) {
-      if ([deletions containsIndex:oldIndex]) {
-        // index was deleted, do nothing, just let oldIndex advance.
-      } else {
-        // assign the next index for this item.
-        result->_map[oldIndex] = newIndex++;
-      }
+  NSInteger oldIndex = 0, newIndex = 0;
+  auto deleted = deletedRanges.cbegin();
+  auto inserted = insertedRanges.cbegin();
+  while (oldIndex < oldCount) {
+    // Skip deleted old indexes and inserted new indexes.
+    if (deleted != deletedRanges.cend() && oldIndex >= (NSInteger)deleted->location) {
+      oldIndex = MAX(oldIndex, (NSInteger)NSMaxRange(*deleted));
+      deleted++;
+      continue;
     }
-  }];
+    if (inserted != insertedRanges.cend() && newIndex >= (NSInteger)inserted->location) {
+      newIndex = MAX(newIndex, (NSInteger)NSMaxRange(*inserted));
+      inserted++;
+      continue;
+    }
+
+    // Both indexes are in a gap, the run lasts until either gap ends.
+    NSInteger length = oldCount - oldIndex;
+    if (deleted != deletedRanges.cend()) {
+      length = MIN(length, (NSInteger)deleted->location - oldIndex);
+    }
+    if (inserted != insertedRanges.cend()) {
+      length = MIN(length, (NSInteger)inserted->location - newIndex);
+    }
+    result->_runs.push_back({oldIndex, newIndex, length});
+    oldIndex += length;
+    newIndex += length;
+  }
   return result;
 }
 
@@ -102,6 +134,17 @@
     return NSNotFound;
   }
 
+  if (!_runs.empty()) {
+    // Find the last run that starts at or before the key.
+    let run = std::upper_bound(_runs.cbegin(), _runs.cend(), key, [](NSInteger key, const ASIntegerMapRun &run) {
+      return key < run.key;
+    });
+    if (run == _runs.cbegin() || key >= (run - 1)->key + (run - 1)->length) {
+      return NSNotFound;
+    }
+    return (run - 1)->value + (key - (run - 1)->key);
+  }
+
   let result = _map.find(key);
   return result != _map.end() ? result->second : NSNotFound;
 }
@@ -113,6 +156,7 @@
     return;
   }
 
+  [self _materializeRuns];
   _map[key] = value;
 }
 
@@ -123,7 +167,12 @@
   }
 
   let result = [[ASIntegerMap alloc] init];
-  
+
+  // Runs map increasing keys to increasing values, so swapped runs stay sorted by key.
+  result->_runs.reserve(_runs.size());
+  for (let &run : _runs) {
+    result->_runs.push_back({run.value, run.key, run.length});
+  }
   for (let &e : _map) {
     result->_map[e.second] = e.first;
   }
@@ -140,9 +189,25 @@
 
   let newMap = [[ASIntegerMap allocWithZone:zone] init];
   newMap->_map = _map;
+  newMap->_runs = _runs;
   return newMap;
 }
 
+#pragma mark - Private
+
+/**
+ * Moves the entries of the runs into the unordered map, so that it can be mutated.
+ */
+- (void)_materializeRuns
+{
+  for (let &run : _runs) {
+    for (NSInteger i = 0; i < run.length; i++) {
+      _map[run.key + i] = run.value + i;
+    }
+  }
+  _runs.clear();
+}
+
 #pragma mark - Description
 
 - (NSMutableArray<NSDictionary *> *)propertiesForDescription
@@ -156,6 +221,13 @@
   } else {
     // { 1->2 3->4 5->6 }
     NSMutableString *str = [NSMutableString string];
+    for (let &run : _runs) {
+      if (run.length == 1) {
+        [str appendFormat:@" %ld->%ld", (long)run.key, (long)run.value];
+      } else {
+        [str appendFormat:@" %ld...%ld->%ld...%ld", (long)run.key, (long)(run.key + run.length - 1), (long)run.value, (long)(run.value + run.length - 1)];
+      }
+    }
     for (let &e : _map) {
       [str appendFormat:@" %ld->%ld", (long)e.first, (long)e.second];
     }
@@ -181,7 +253,15 @@
   }
 
   if (let otherMap = ASDynamicCast(object, ASIntegerMap)) {
-    return otherMap->_map == _map;
+    if (_map.empty() && otherMap->_map.empty()) {
+      return otherMap->_runs == _runs;
+    }
+    // Compare the entries of both maps, whichever way they are stored.
+    let map = (ASIntegerMap *)[self copy];
+    let alsoMap = (ASIntegerMap *)[otherMap copy];
+    [map _materializeRuns];
+    [alsoMap _materializeRuns];
+    return alsoMap->_map == map->_map;
   }
   return NO;
 }
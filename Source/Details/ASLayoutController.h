@@ -43,6 +43,12 @@ typedef struct ASDirectionalScreenfulBuffer ASDirectionalScreenfulBuffer;
 
 @optional
 
+/**
+ * A factor applied to the leading and trailing buffers of the tuning parameters when computing range bounds.
+ * Range controllers adjust it to the frame budget if the exp_adaptive_ranges experiment is enabled. Defaults to 1.
+ */
+@property (nonatomic) CGFloat bufferScale;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -189,6 +189,12 @@ AS_SUBCLASSING_RESTRICTED
 
 @end
 
+/**
+ * Returns the buffer scale for the next window of frames, given the current one and the frames dropped during the window.
+ * Used by range controllers if the exp_adaptive_ranges experiment is enabled.
+ */
+AS_EXTERN CGFloat ASRangeBufferScaleAfterFrameWindow(CGFloat bufferScale, NSUInteger droppedFrameCount, NSUInteger frameCount);
+
 @interface ASRangeController (DebugInternal)
 
 + (void)layoutDebugOverlayIfNeeded;
@@ -21,28 +21,157 @@
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASCellNode+Internal.h>
 #import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
+#import <AsyncDisplayKit/ASDisplayNode+Beta.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h> // Required for interfaceState and hierarchyState setter methods.
 #import <AsyncDisplayKit/ASElementMap.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
+#import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASSignpost.h>
 #import <AsyncDisplayKit/ASTwoDimensionalArrayUtils.h>
+#import <AsyncDisplayKit/ASWeakProxy.h>
 #import <AsyncDisplayKit/ASWeakSet.h>
 
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
 #import <AsyncDisplayKit/AsyncDisplayKit+Debug.h>
 
+#import <objc/runtime.h>
+
+#import <algorithm>
+#import <utility>
+#import <vector>
+
 #define AS_RANGECONTROLLER_LOG_UPDATE_FREQ 0
 
 #ifndef ASRangeControllerAutomaticLowMemoryHandling
 #define ASRangeControllerAutomaticLowMemoryHandling 1
 #endif
 
+/**
+ * A set of item positions, in the order of the items of an element map across sections, kept as sorted disjoint
+ * half-open intervals. Ranges cover mostly contiguous items, so they take a handful of intervals each.
+ */
+class ASRangeIntervals {
+public:
+  ASRangeIntervals() {}
+
+  /// Builds the intervals from positions in any order, possibly with duplicates.
+  explicit ASRangeIntervals(std::vector<NSInteger> positions)
+  {
+    std::sort(positions.begin(), positions.end());
+    for (NSInteger position : positions) {
+      if (!_intervals.empty() && position <= _intervals.back().second) {
+        _intervals.back().second = MAX(_intervals.back().second, position + 1);
+      } else {
+        _intervals.emplace_back(position, position + 1);
+      }
+    }
+  }
+
+  bool contains(NSInteger position) const
+  {
+    // The first interval that ends after the position.
+    let it = std::upper_bound(_intervals.begin(), _intervals.end(), position, [](NSInteger p, const std::pair<NSInteger, NSInteger> &interval) {
+      return p < interval.second;
+    });
+    return it != _intervals.end() && it->first <= position;
+  }
+
+  template <typename F>
+  void forEach(F body) const
+  {
+    for (let &interval : _intervals) {
+      for (NSInteger position = interval.first; position < interval.second; position++) {
+        body(position);
+      }
+    }
+  }
+
+  /// Calls body with the positions that are in exactly one of the two sets, in increasing order.
+  template <typename F>
+  void forEachInSymmetricDifference(const ASRangeIntervals &other, F body) const
+  {
+    // Sweep over the boundaries of both sets, tracking which set the current stretch of positions is in.
+    std::vector<NSInteger> boundaries;
+    boundaries.reserve(2 * (_intervals.size() + other._intervals.size()));
+    for (let &interval : _intervals) {
+      boundaries.push_back(interval.first);
+      boundaries.push_back(interval.second);
+    }
+    for (let &interval : other._intervals) {
+      boundaries.push_back(interval.first);
+      boundaries.push_back(interval.second);
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+    for (NSUInteger i = 0; i + 1 < boundaries.size(); i++) {
+      NSInteger start = boundaries[i];
+      if (contains(start) != other.contains(start)) {
+        for (NSInteger position = start; position < boundaries[i + 1]; position++) {
+          body(position);
+        }
+      }
+    }
+  }
+
+  /// The distance from the position to the closest position in the set, or NSIntegerMax if the set is empty.
+  NSInteger distance(NSInteger position) const
+  {
+    let it = std::upper_bound(_intervals.begin(), _intervals.end(), position, [](NSInteger p, const std::pair<NSInteger, NSInteger> &interval) {
+      return p < interval.second;
+    });
+    NSInteger distance = NSIntegerMax;
+    if (it != _intervals.end()) {
+      distance = MAX(it->first - position, 0);
+    }
+    if (it != _intervals.begin()) {
+      distance = MIN(distance, position - (std::prev(it)->second - 1));
+    }
+    return distance;
+  }
+
+  bool empty() const { return _intervals.empty(); }
+
+private:
+  std::vector<std::pair<NSInteger, NSInteger>> _intervals;
+};
+
+/**
+ * An item a range controller would like to keep in its display or preload range, for the memory budget shared by all
+ * range controllers. Candidates are admitted in order of tier, then distance.
+ */
+struct ASRangeMemoryCandidate {
+  /// 0 for the visible items of visible range controllers, which are always admitted. Then display, then preload.
+  NSInteger tier;
+  /// The distance in items from the visible items of the range controller.
+  NSInteger distance;
+  /// The estimated bytes of the decoded backing stores and the layout of the item's node.
+  NSUInteger cost;
+  NSInteger position;
+};
+
 @interface ASRangeController ()
 {
   BOOL _rangeIsValid;
   BOOL _needsRangeUpdate;
-  NSSet<NSIndexPath *> *_allPreviousIndexPaths;
+
+  // The ranges of the last update, as positions of items in _rangesMap.
+  // Updates of the same map only visit the items that entered or exited a range since.
+  __weak ASElementMap *_rangesMap;
+  std::vector<NSInteger> _rangesMapSectionStarts;
+  ASInterfaceState _rangesInterfaceState;
+  ASLayoutRangeMode _rangesMode;
+  ASRangeIntervals _visiblePositions;
+  ASRangeIntervals _displayPositions;
+  ASRangeIntervals _preloadPositions;
+  // Items in range whose nodes weren't allocated yet when they were visited. They are visited again until they are.
+  std::vector<NSInteger> _unallocatedPositions;
+
+  // The candidates of the last update for the memory budget in priority order, and how many of them were admitted.
+  std::vector<ASRangeMemoryCandidate> _memoryCandidates;
+  NSUInteger _admittedMemoryCandidateCount;
+
   NSHashTable<ASCellNode *> *_visibleNodes;
   ASLayoutRangeMode _currentRangeMode;
   BOOL _contentHasBeenScrolled;
@@ -62,10 +191,117 @@
 #endif
 }
 
+/// Applies the buffer scale to the layout controllers of all range controllers.
++ (void)setBufferScale:(CGFloat)bufferScale;
+
+/**
+ * Admits the memory candidates of all range controllers in priority order until the memory budget is spent.
+ * Range controllers other than the given one, if any, are updated if their admitted candidates changed.
+ */
++ (void)arbitrateMemoryBudgetForRangeController:(ASRangeController *)rangeController;
+
 @end
 
 static UIApplicationState __ApplicationState = UIApplicationStateActive;
 
+#pragma mark - Frame Budget Tuning
+
+static CGFloat const kMinimumBufferScale = 0.25;
+static CGFloat const kMaximumBufferScale = 2.0;
+static CGFloat const kBufferScaleIncrement = 0.1;
+static CGFloat const kBufferScaleDecreaseFactor = 0.75;
+static NSUInteger const kFrameWindowLength = 30;
+static CFTimeInterval const kFrameBudgetMonitorIdleInterval = 1.0;
+
+static CGFloat __rangeBufferScale = 1.0;
+static __weak id<ASRangeTuningDelegate> __rangeTuningDelegate;
+
+CGFloat ASRangeBufferScaleAfterFrameWindow(CGFloat bufferScale, NSUInteger droppedFrameCount, NSUInteger frameCount)
+{
+  // Grow slowly while there is slack, back off quickly once more than 1 frame in 20 is dropped.
+  if (droppedFrameCount == 0) {
+    return MIN(bufferScale + kBufferScaleIncrement, kMaximumBufferScale);
+  } else if (droppedFrameCount * 20 > frameCount) {
+    return MAX(bufferScale * kBufferScaleDecreaseFactor, kMinimumBufferScale);
+  }
+  return bufferScale;
+}
+
+/**
+ * Counts dropped frames with a display link while range controllers are updating their ranges, and adjusts the buffer
+ * scale of all range controllers after every window of frames. The display link is paused while ranges are idle.
+ */
+@interface ASRangeFrameBudgetMonitor : NSObject
++ (ASRangeFrameBudgetMonitor *)sharedMonitor;
+- (void)rangeControllerDidUpdateRanges;
+@end
+
+@implementation ASRangeFrameBudgetMonitor {
+  CADisplayLink *_displayLink;
+  CFTimeInterval _lastFrameTimestamp;
+  CFTimeInterval _lastRangeUpdateTime;
+  NSUInteger _frameCount;
+  NSUInteger _droppedFrameCount;
+}
+
++ (ASRangeFrameBudgetMonitor *)sharedMonitor
+{
+  static ASRangeFrameBudgetMonitor *monitor;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    monitor = [[ASRangeFrameBudgetMonitor alloc] init];
+  });
+  return monitor;
+}
+
+- (void)rangeControllerDidUpdateRanges
+{
+  ASDisplayNodeAssertMainThread();
+  _lastRangeUpdateTime = CACurrentMediaTime();
+  if (_displayLink == nil) {
+    _displayLink = [CADisplayLink displayLinkWithTarget:[ASWeakProxy weakProxyWithTarget:self] selector:@selector(displayLinkDidFire:)];
+    _displayLink.paused = YES;
+    [_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+  }
+  if (_displayLink.paused) {
+    _lastFrameTimestamp = 0;
+    _displayLink.paused = NO;
+  }
+}
+
+- (void)displayLinkDidFire:(CADisplayLink *)displayLink
+{
+  CFTimeInterval timestamp = displayLink.timestamp;
+  if (_lastFrameTimestamp > 0 && displayLink.duration > 0) {
+    // A frame that took n frame durations means n - 1 frames were dropped.
+    NSUInteger frames = MAX((NSUInteger)1, (NSUInteger)lround((timestamp - _lastFrameTimestamp) / displayLink.duration));
+    _frameCount += frames;
+    _droppedFrameCount += frames - 1;
+  }
+  _lastFrameTimestamp = timestamp;
+
+  if (_frameCount >= kFrameWindowLength) {
+    CGFloat previousBufferScale = __rangeBufferScale;
+    CGFloat bufferScale = ASRangeBufferScaleAfterFrameWindow(previousBufferScale, _droppedFrameCount, _frameCount);
+    if (bufferScale != previousBufferScale) {
+      [ASRangeController setBufferScale:bufferScale];
+    }
+    [__rangeTuningDelegate rangeTuningDidUpdateBufferScale:bufferScale
+                                       previousBufferScale:previousBufferScale
+                                         droppedFrameCount:_droppedFrameCount
+                                                frameCount:_frameCount];
+    _frameCount = 0;
+    _droppedFrameCount = 0;
+  }
+
+  // Idle frames say nothing about the cost of range updates. Keep the partial window for the next time ranges update.
+  if (CACurrentMediaTime() - _lastRangeUpdateTime > kFrameBudgetMonitorIdleInterval) {
+    displayLink.paused = YES;
+  }
+}
+
+@end
+
 @implementation ASRangeController
 
 #pragma mark - Lifecycle
@@ -77,6 +313,7 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   }
   
   _rangeIsValid = YES;
+  _rangesMapSectionStarts.assign(1, 0);
   _currentRangeMode = ASLayoutRangeModeUnspecified;
   _contentHasBeenScrolled = NO;
   _preserveCurrentRangeMode = NO;
@@ -177,6 +414,9 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
 - (void)setLayoutController:(id<ASLayoutController>)layoutController
 {
   _layoutController = layoutController;
+  if (ASActivateExperimentalFeature(ASExperimentalAdaptiveRanges) && [layoutController respondsToSelector:@selector(setBufferScale:)]) {
+    layoutController.bufferScale = __rangeBufferScale;
+  }
   if (layoutController && _dataSource) {
     [self updateIfNeeded];
   }
@@ -221,6 +461,10 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   _updateCountThisFrame += 1;
 #endif
   
+  if (ASActivateExperimentalFeature(ASExperimentalAdaptiveRanges)) {
+    [[ASRangeFrameBudgetMonitor sharedMonitor] rangeControllerDidUpdateRanges];
+  }
+
   ASElementMap *map = [_dataSource elementMapForRangeController:self];
 
   // TODO: Consider if we need to use this codepath, or can rely on something more similar to the data & display ranges
@@ -301,63 +545,143 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
     }
   }
   
-  // For now we are only interested in items. Filter-map out from element to item-index-path.
-  NSSet<NSIndexPath *> *visibleIndexPaths = ASSetByFlatMapping(visibleElements, ASCollectionElement *element, [map indexPathForElementIfCell:element]);
-  NSSet<NSIndexPath *> *displayIndexPaths = ASSetByFlatMapping(displayElements, ASCollectionElement *element, [map indexPathForElementIfCell:element]);
-  NSSet<NSIndexPath *> *preloadIndexPaths = ASSetByFlatMapping(preloadElements, ASCollectionElement *element, [map indexPathForElementIfCell:element]);
-
-  // Prioritize the order in which we visit each.  Visible nodes should be updated first so they are enqueued on
-  // the network or display queues before preloading (offscreen) nodes are enqueued.
-  NSMutableOrderedSet<NSIndexPath *> *allIndexPaths = [[NSMutableOrderedSet alloc] initWithSet:visibleIndexPaths];
-  
-  // Typically the preloadIndexPaths will be the largest, and be a superset of the others, though it may be disjoint.
-  // Because allIndexPaths is an NSMutableOrderedSet, this adds the non-duplicate items /after/ the existing items.
-  // This means that during iteration, we will first visit visible, then display, then preload nodes.
-  [allIndexPaths unionSet:displayIndexPaths];
-  [allIndexPaths unionSet:preloadIndexPaths];
-  
-  // Add anything we had applied interfaceState to in the last update, but is no longer in range, so we can clear any
-  // range flags it still has enabled.  Most of the time, all but a few elements are equal; a large programmatic
-  // scroll or major main thread stall could cause entirely disjoint sets.  In either case we must visit all.
-  // Calling "-set" on NSMutableOrderedSet just references the underlying mutable data store, so we must copy it.
-  NSSet<NSIndexPath *> *allCurrentIndexPaths = [[allIndexPaths set] copy];
-  [allIndexPaths unionSet:_allPreviousIndexPaths];
-  _allPreviousIndexPaths = allCurrentIndexPaths;
-  
+  // For now we are only interested in items. Map elements to the positions of their items across sections.
+  BOOL mapChanged = (map != _rangesMap);
+  if (mapChanged) {
+    _rangesMap = map;
+    NSInteger sectionCount = map.numberOfSections;
+    _rangesMapSectionStarts.assign(sectionCount + 1, 0);
+    for (NSInteger section = 0; section < sectionCount; section++) {
+      _rangesMapSectionStarts[section + 1] = _rangesMapSectionStarts[section] + [map numberOfItemsInSection:section];
+    }
+  }
+  NSInteger itemCount = _rangesMapSectionStarts.back();
+  let positionsOfElements = [&](NSHashTable<ASCollectionElement *> *elements) {
+    std::vector<NSInteger> positions;
+    positions.reserve(elements.count);
+    for (ASCollectionElement *element in elements) {
+      if (NSIndexPath *indexPath = [map indexPathForElementIfCell:element]) {
+        positions.push_back(_rangesMapSectionStarts[indexPath.section] + indexPath.item);
+      }
+    }
+    return ASRangeIntervals(std::move(positions));
+  };
+  var visiblePositions = positionsOfElements(visibleElements);
+  var displayPositions = (displayElements == visibleElements ? visiblePositions : positionsOfElements(displayElements));
+  var preloadPositions = (preloadElements == displayElements ? displayPositions : positionsOfElements(preloadElements));
+
+  // Keep only the items admitted by the memory budget shared with all other range controllers in the ranges.
+  if (ASActivateExperimentalFeature(ASExperimentalRangeMemoryBudget)) {
+    [self _updateMemoryCandidatesWithMap:map
+                        visiblePositions:visiblePositions
+                        displayPositions:displayPositions
+                        preloadPositions:preloadPositions
+                          interfaceState:selfInterfaceState];
+    [ASRangeController arbitrateMemoryBudgetForRangeController:self];
+
+    std::vector<NSInteger> admitted;
+    admitted.reserve(_admittedMemoryCandidateCount);
+    for (NSUInteger i = 0; i < _admittedMemoryCandidateCount; i++) {
+      admitted.push_back(_memoryCandidates[i].position);
+    }
+    let admittedPositions = ASRangeIntervals(std::move(admitted));
+    let admittedPositionsIn = [&admittedPositions](const ASRangeIntervals &positions) {
+      std::vector<NSInteger> result;
+      positions.forEach([&](NSInteger position) {
+        if (admittedPositions.contains(position)) {
+          result.push_back(position);
+        }
+      });
+      return ASRangeIntervals(std::move(result));
+    };
+    visiblePositions = admittedPositionsIn(visiblePositions);
+    displayPositions = admittedPositionsIn(displayPositions);
+    preloadPositions = admittedPositionsIn(preloadPositions);
+  }
+
+  // Collect the items to visit along with a priority: visible nodes should be updated first so they are enqueued on
+  // the network or display queues before preloading (offscreen) nodes are enqueued. Then display, preload and the rest.
+  //
+  // If the map, our interface state and range mode are the same as in the last update, the state of an item can only
+  // change if it entered or exited a range, so the cost of an update scales with the number of those items.
+  // Otherwise we visit everything in the current and previous ranges, to clear any range flags items still have enabled.
+  // If the data changed, we visit all items.
+  std::vector<std::pair<NSInteger, NSInteger>> visits;
+  let visitWithPriority = [&visits](NSInteger priority) {
+    return [&visits, priority](NSInteger position) { visits.emplace_back(position, priority); };
+  };
+  BOOL visitsAllItems = (!_rangeIsValid || mapChanged);
+  BOOL visitsAllRanges = (visitsAllItems
+                          || selfInterfaceState != _rangesInterfaceState
+                          || (rangeMode == ASLayoutRangeModeLowMemory) != (_rangesMode == ASLayoutRangeModeLowMemory));
+  if (visitsAllRanges) {
+    visiblePositions.forEach(visitWithPriority(0));
+    displayPositions.forEach(visitWithPriority(1));
+    preloadPositions.forEach(visitWithPriority(2));
+    if (visitsAllItems) {
+      for (NSInteger position = 0; position < itemCount; position++) {
+        visits.emplace_back(position, 3);
+      }
+    } else {
+      _visiblePositions.forEach(visitWithPriority(3));
+      _displayPositions.forEach(visitWithPriority(3));
+      _preloadPositions.forEach(visitWithPriority(3));
+    }
+  } else {
+    visiblePositions.forEachInSymmetricDifference(_visiblePositions, visitWithPriority(0));
+    displayPositions.forEachInSymmetricDifference(_displayPositions, visitWithPriority(1));
+    preloadPositions.forEachInSymmetricDifference(_preloadPositions, visitWithPriority(2));
+    for (NSInteger position : _unallocatedPositions) {
+      visits.emplace_back(position, 3);
+    }
+  }
+  // Visit each item once, with its highest priority.
+  std::sort(visits.begin(), visits.end());
+  visits.erase(std::unique(visits.begin(), visits.end(), [](const std::pair<NSInteger, NSInteger> &a, const std::pair<NSInteger, NSInteger> &b) {
+    return a.first == b.first;
+  }), visits.end());
+  std::stable_sort(visits.begin(), visits.end(), [](const std::pair<NSInteger, NSInteger> &a, const std::pair<NSInteger, NSInteger> &b) {
+    return a.second < b.second;
+  });
+
   _currentRangeMode = rangeMode;
   _preserveCurrentRangeMode = NO;
   
-  if (!_rangeIsValid) {
-    [allIndexPaths addObjectsFromArray:map.itemIndexPaths];
-  }
-  
 #if ASRangeControllerLoggingEnabled
-  ASDisplayNodeAssertTrue([visibleIndexPaths isSubsetOfSet:displayIndexPaths]);
+  BOOL visibleIsSubsetOfDisplay = YES;
+  visiblePositions.forEach([&](NSInteger position) { visibleIsSubsetOfDisplay = visibleIsSubsetOfDisplay && displayPositions.contains(position); });
+  ASDisplayNodeAssertTrue(visibleIsSubsetOfDisplay);
   NSMutableArray<NSIndexPath *> *modifiedIndexPaths = (ASRangeControllerLoggingEnabled ? [NSMutableArray array] : nil);
 #endif
 
-  for (NSIndexPath *indexPath in allIndexPaths) {
+  std::vector<NSInteger> unallocatedPositions;
+  for (let &visit : visits) {
+    NSInteger position = visit.first;
+    if (position >= itemCount) {
+      continue;
+    }
+
     // Before a node / indexPath is exposed to ASRangeController, ASDataController should have already measured it.
     // For consistency, make sure each node knows that it should measure itself if something changes.
     ASInterfaceState interfaceState = ASInterfaceStateMeasureLayout;
     
     if (ASInterfaceStateIncludesVisible(selfInterfaceState)) {
-      if ([visibleIndexPaths containsObject:indexPath]) {
+      if (visiblePositions.contains(position)) {
         interfaceState |= (ASInterfaceStateVisible | ASInterfaceStateDisplay | ASInterfaceStatePreload);
       } else {
-        if ([preloadIndexPaths containsObject:indexPath]) {
+        if (preloadPositions.contains(position)) {
           interfaceState |= ASInterfaceStatePreload;
         }
-        if ([displayIndexPaths containsObject:indexPath]) {
+        if (displayPositions.contains(position)) {
           interfaceState |= ASInterfaceStateDisplay;
         }
       }
     } else {
-      // If selfInterfaceState isn't visible, then visibleIndexPaths represents what /will/ be immediately visible at the
+      // If selfInterfaceState isn't visible, then visiblePositions represents what /will/ be immediately visible at the
       // instant we come onscreen.  So, preload and display all of those things, but don't waste resources preloading yet.
       // We handle this as a separate case to minimize set operations for offscreen preloading, including containsObject:.
       
-      if ([allCurrentIndexPaths containsObject:indexPath]) {
+      if (visiblePositions.contains(position) || displayPositions.contains(position) || preloadPositions.contains(position)) {
         // DO NOT set Visible: even though these elements are in the visible range / "viewport",
         // our overall container object is itself not visible yet.  The moment it becomes visible, we will run the condition above
         
@@ -367,38 +691,55 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
         if (rangeMode != ASLayoutRangeModeLowMemory) {
           // Add Display.
           // We might be looking at an indexPath that was previously in-range, but now we need to clear it.
-          // In that case we'll just set it back to MeasureLayout.  Only set Display | Preload if in allCurrentIndexPaths.
+          // In that case we'll just set it back to MeasureLayout.  Only set Display | Preload if in range.
           interfaceState |= ASInterfaceStateDisplay;
         }
       }
     }
 
+    NSIndexPath *indexPath = [self _indexPathForItemAtPosition:position];
     ASCellNode *node = [map elementForItemAtIndexPath:indexPath].nodeIfAllocated;
-    if (node != nil) {
-      ASDisplayNodeAssert(node.hierarchyState & ASHierarchyStateRangeManaged, @"All nodes reaching this point should be range-managed, or interfaceState may be incorrectly reset.");
-      if (ASInterfaceStateIncludesVisible(interfaceState)) {
-        [newVisibleNodes addObject:node];
+    if (node == nil) {
+      if (interfaceState != ASInterfaceStateMeasureLayout) {
+        unallocatedPositions.push_back(position);
       }
-      // Skip the many method calls of the recursive operation if the top level cell node already has the right interfaceState.
-      if (node.pendingInterfaceState != interfaceState) {
+      continue;
+    }
+
+    ASDisplayNodeAssert(node.hierarchyState & ASHierarchyStateRangeManaged, @"All nodes reaching this point should be range-managed, or interfaceState may be incorrectly reset.");
+    // Skip the many method calls of the recursive operation if the top level cell node already has the right interfaceState.
+    if (node.pendingInterfaceState != interfaceState) {
 #if ASRangeControllerLoggingEnabled
-        [modifiedIndexPaths addObject:indexPath];
+      [modifiedIndexPaths addObject:indexPath];
 #endif
 
-        BOOL nodeShouldScheduleDisplay = [node shouldScheduleDisplayWithNewInterfaceState:interfaceState];
-        [node recursivelySetInterfaceState:interfaceState];
+      BOOL nodeShouldScheduleDisplay = [node shouldScheduleDisplayWithNewInterfaceState:interfaceState];
+      [node recursivelySetInterfaceState:interfaceState];
 
-        if (nodeShouldScheduleDisplay) {
-          [self registerForNodeDisplayNotificationsForInterfaceStateIfNeeded:selfInterfaceState];
-          if (_didRegisterForNodeDisplayNotifications) {
-            _pendingDisplayNodesTimestamp = CACurrentMediaTime();
-          }
+      if (nodeShouldScheduleDisplay) {
+        [self registerForNodeDisplayNotificationsForInterfaceStateIfNeeded:selfInterfaceState];
+        if (_didRegisterForNodeDisplayNotifications) {
+          _pendingDisplayNodesTimestamp = CACurrentMediaTime();
         }
       }
     }
   }
 
+  if (ASInterfaceStateIncludesVisible(selfInterfaceState)) {
+    visiblePositions.forEach([&](NSInteger position) {
+      if (ASCellNode *node = [map elementForItemAtIndexPath:[self _indexPathForItemAtPosition:position]].nodeIfAllocated) {
+        [newVisibleNodes addObject:node];
+      }
+    });
+  }
   [self _setVisibleNodes:newVisibleNodes];
+
+  _visiblePositions = visiblePositions;
+  _displayPositions = displayPositions;
+  _preloadPositions = preloadPositions;
+  _unallocatedPositions = std::move(unallocatedPositions);
+  _rangesInterfaceState = selfInterfaceState;
+  _rangesMode = rangeMode;
   
   // TODO: This code is for debugging only, but would be great to clean up with a delegate method implementation.
   if (ASDisplayNode.shouldShowRangeDebugOverlay) {
@@ -436,6 +777,66 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   ASSignpostEnd(ASSignpostRangeControllerUpdate);
 }
 
+#pragma mark - Memory Budget
+
+/**
+ * The estimated bytes a cell node retains while it is in range: its decoded backing stores, which roughly cover the
+ * cell once at 4 bytes per pixel, and its layout. Nodes that aren't allocated yet don't retain anything.
+ */
+static NSUInteger ASRangeMemoryCostOfNode(ASCellNode *node)
+{
+  if (node == nil) {
+    return 0;
+  }
+  static let layoutSize = class_getInstanceSize([ASLayout class]);
+  CGSize size = node.calculatedSize;
+  CGFloat scale = ASScreenScale();
+  NSUInteger bitmapCost = (NSUInteger)ceil(size.width * scale) * (NSUInteger)ceil(size.height * scale) * 4;
+  NSUInteger layoutCost = (1 + node.calculatedLayout.sublayouts.count) * layoutSize;
+  return bitmapCost + layoutCost;
+}
+
+- (void)_updateMemoryCandidatesWithMap:(ASElementMap *)map
+                      visiblePositions:(const ASRangeIntervals &)visiblePositions
+                      displayPositions:(const ASRangeIntervals &)displayPositions
+                      preloadPositions:(const ASRangeIntervals &)preloadPositions
+                        interfaceState:(ASInterfaceState)interfaceState
+{
+  // The items of range controllers that aren't visible, e.g. of a collection nested in a cell that is only in the
+  // preload range of the outer collection, rank after the display ranges of visible range controllers.
+  NSInteger tierOffset = (ASInterfaceStateIncludesVisible(interfaceState) ? 0 : 1);
+
+  std::vector<NSInteger> positions;
+  let addPosition = [&positions](NSInteger position) { positions.push_back(position); };
+  visiblePositions.forEach(addPosition);
+  displayPositions.forEach(addPosition);
+  preloadPositions.forEach(addPosition);
+  std::sort(positions.begin(), positions.end());
+  positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+  _memoryCandidates.clear();
+  _memoryCandidates.reserve(positions.size());
+  for (NSInteger position : positions) {
+    NSInteger tier = (visiblePositions.contains(position) ? 0 : (displayPositions.contains(position) ? 1 : 2));
+    ASCellNode *node = [map elementForItemAtIndexPath:[self _indexPathForItemAtPosition:position]].nodeIfAllocated;
+    _memoryCandidates.push_back({ tier + tierOffset, visiblePositions.distance(position), ASRangeMemoryCostOfNode(node), position });
+  }
+  std::stable_sort(_memoryCandidates.begin(), _memoryCandidates.end(), [](const ASRangeMemoryCandidate &a, const ASRangeMemoryCandidate &b) {
+    return a.tier < b.tier || (a.tier == b.tier && a.distance < b.distance);
+  });
+}
+
+/**
+ * Returns the index path of the item at the given position across the sections of the map of the last update.
+ */
+- (NSIndexPath *)_indexPathForItemAtPosition:(NSInteger)position
+{
+  // The last section that starts at or before the position. Empty sections start where the next one does.
+  let it = std::upper_bound(_rangesMapSectionStarts.begin(), _rangesMapSectionStarts.end(), position);
+  NSInteger section = (it - _rangesMapSectionStarts.begin()) - 1;
+  return [NSIndexPath indexPathForItem:(position - _rangesMapSectionStarts[section]) inSection:section];
+}
+
 #pragma mark - Notification observers
 
 /**
@@ -526,6 +927,8 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
 // Skip the many method calls of the recursive operation if the top level cell node already has the right interfaceState.
 - (void)clearContents
 {
+  // Nodes in range need to be visited again on the next update, even if the ranges don't change.
+  _rangeIsValid = NO;
   for (ASCollectionElement *element in [_dataSource elementMapForRangeController:self]) {
     ASCellNode *node = element.nodeIfAllocated;
     if (ASInterfaceStateIncludesDisplay(node.interfaceState)) {
@@ -536,6 +939,10 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
 
 - (void)clearPreloadedData
 {
+  // Nodes in range need to be visited again on the next update, even if the ranges don't change.
+  _rangeIsValid = NO;
+  // Nothing is retained for the memory budget until the next update.
+  _memoryCandidates.clear();
   for (ASCollectionElement *element in [_dataSource elementMapForRangeController:self]) {
     ASCellNode *node = element.nodeIfAllocated;
     if (ASInterfaceStateIncludesPreload(node.interfaceState)) {
@@ -628,6 +1035,86 @@ static ASLayoutRangeMode __rangeModeForMemoryWarnings = ASLayoutRangeModeLowMemo
 #endif
 }
 
+#pragma mark - Class Methods (Frame Budget Tuning)
+
++ (void)setTuningDelegate:(id<ASRangeTuningDelegate>)delegate
+{
+  __rangeTuningDelegate = delegate;
+}
+
++ (void)setBufferScale:(CGFloat)bufferScale
+{
+  ASDisplayNodeAssertMainThread();
+  __rangeBufferScale = bufferScale;
+  for (ASRangeController *rangeController in [[self allRangeControllersWeakSet] allObjects]) {
+    id<ASLayoutController> layoutController = rangeController->_layoutController;
+    if ([layoutController respondsToSelector:@selector(setBufferScale:)]) {
+      layoutController.bufferScale = bufferScale;
+      [rangeController setNeedsUpdate];
+    }
+  }
+}
+
+#pragma mark - Class Methods (Memory Budget)
+
+static NSUInteger __rangeMemoryBudget = (NSUInteger)([NSProcessInfo processInfo].physicalMemory / 8);
+
++ (NSUInteger)memoryBudget
+{
+  return __rangeMemoryBudget;
+}
+
++ (void)setMemoryBudget:(NSUInteger)memoryBudget
+{
+  ASDisplayNodeAssertMainThread();
+  __rangeMemoryBudget = memoryBudget;
+  [self arbitrateMemoryBudgetForRangeController:nil];
+}
+
++ (void)arbitrateMemoryBudgetForRangeController:(ASRangeController *)rangeController
+{
+  ASDisplayNodeAssertMainThread();
+  struct Claim {
+    NSInteger tier;
+    NSInteger distance;
+    NSUInteger cost;
+    NSUInteger owner;
+  };
+  NSArray<ASRangeController *> *rangeControllers = [[self allRangeControllersWeakSet] allObjects];
+  std::vector<Claim> claims;
+  for (NSUInteger owner = 0; owner < rangeControllers.count; owner++) {
+    for (let &candidate : rangeControllers[owner]->_memoryCandidates) {
+      claims.push_back({ candidate.tier, candidate.distance, candidate.cost, owner });
+    }
+  }
+
+  // Candidates of each range controller are already in priority order, so every range controller is admitted a prefix
+  // of its candidates. Admission stops at the first candidate that doesn't fit, so a large item close to the viewport
+  // is never passed over for smaller ones further away.
+  std::stable_sort(claims.begin(), claims.end(), [](const Claim &a, const Claim &b) {
+    return a.tier < b.tier || (a.tier == b.tier && a.distance < b.distance);
+  });
+  std::vector<NSUInteger> admittedCounts(rangeControllers.count, 0);
+  NSUInteger totalCost = 0;
+  for (let &claim : claims) {
+    if (claim.tier > 0 && totalCost + claim.cost > __rangeMemoryBudget) {
+      break;
+    }
+    totalCost += claim.cost;
+    admittedCounts[claim.owner]++;
+  }
+
+  for (NSUInteger owner = 0; owner < rangeControllers.count; owner++) {
+    ASRangeController *owningRangeController = rangeControllers[owner];
+    if (owningRangeController->_admittedMemoryCandidateCount != admittedCounts[owner]) {
+      owningRangeController->_admittedMemoryCandidateCount = admittedCounts[owner];
+      if (owningRangeController != rangeController) {
+        [owningRangeController setNeedsUpdate];
+      }
+    }
+  }
+}
+
 #pragma mark - Debugging
 
 #if AS_RANGECONTROLLER_LOG_UPDATE_FREQ
@@ -656,7 +1143,18 @@ static ASLayoutRangeMode __rangeModeForMemoryWarnings = ASLayoutRangeModeLowMemo
 
 - (NSString *)description
 {
-  NSArray<NSIndexPath *> *indexPaths = [[_allPreviousIndexPaths allObjects] sortedArrayUsingSelector:@selector(compare:)];
+  std::vector<NSInteger> positions;
+  let addPosition = [&positions](NSInteger position) { positions.push_back(position); };
+  _visiblePositions.forEach(addPosition);
+  _displayPositions.forEach(addPosition);
+  _preloadPositions.forEach(addPosition);
+  std::sort(positions.begin(), positions.end());
+  positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+  NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:positions.size()];
+  for (NSInteger position : positions) {
+    [indexPaths addObject:[self _indexPathForItemAtPosition:position]];
+  }
   return [self descriptionWithIndexPaths:indexPaths];
 }
 
@@ -669,4 +1167,19 @@ static ASLayoutRangeMode __rangeModeForMemoryWarnings = ASLayoutRangeModeLowMemo
   [ASRangeController setRangeModeForMemoryWarnings:rangeMode];
 }
 
++ (void)setRangeTuningDelegate:(id<ASRangeTuningDelegate>)delegate
+{
+  [ASRangeController setTuningDelegate:delegate];
+}
+
++ (NSUInteger)rangeMemoryBudget
+{
+  return [ASRangeController memoryBudget];
+}
+
++ (void)setRangeMemoryBudget:(NSUInteger)rangeMemoryBudget
+{
+  [ASRangeController setMemoryBudget:rangeMemoryBudget];
+}
+
 @end
@@ -20,7 +20,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class UITableView;
+@class ASCellNode, ASElementMap, UITableView;
 
 /**
  *  A layout controller designed for use with UITableView.
@@ -32,6 +32,25 @@ AS_SUBCLASSING_RESTRICTED
 
 - (instancetype)initWithTableView:(UITableView *)tableView;
 
+/**
+ * Returns the index paths of the rows of the map that intersect the rect.
+ *
+ * If the exp_table_row_offsets experiment is enabled, the rows are found by binary search in an index of the row
+ * heights of the map's nodes instead of asking the table view. The index is kept across maps for the sections whose
+ * items didn't change.
+ */
+- (NSArray<NSIndexPath *> *)indexPathsForRowsInRect:(CGRect)rect map:(ASElementMap *)map;
+
+/**
+ * Updates the row heights of the nodes in the index after they were measured again.
+ */
+- (void)nodesDidRelayout:(NSArray<ASCellNode *> *)nodes;
+
+/**
+ * Discards the index, e.g. after all nodes were measured again.
+ */
+- (void)invalidateRowOffsets;
+
 @end
 
 NS_ASSUME_NONNULL_END
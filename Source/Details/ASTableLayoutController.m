@@ -1,62 +0,0 @@
-//
-//  ASTableLayoutController.m
-//  Texture
-//
-//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
-//  This source code is licensed under the BSD-style license found in the
-//  LICENSE file in the /ASDK-Licenses directory of this source tree. An additional
-//  grant of patent rights can be found in the PATENTS file in the same directory.
-//
-//  Modifications to this file made after 4/13/2017 are: Copyright (c) 2017-present,
-//  Pinterest, Inc.  Licensed under the Apache License, Version 2.0 (the "License");
-//  you may not use this file except in compliance with the License.
-//  You may obtain a copy of the License at
-//
-//      http://www.apache.org/licenses/LICENSE-2.0
-//
-
-#import <AsyncDisplayKit/ASTableLayoutController.h>
-
-#import <UIKit/UIKit.h>
-
-#import <AsyncDisplayKit/ASAssert.h>
-#import <AsyncDisplayKit/ASElementMap.h>
-
-@interface ASTableLayoutController()
-@end
-
-@implementation ASTableLayoutController
-
-- (instancetype)initWithTableView:(UITableView *)tableView
-{
-  if (!(self = [super init])) {
-    return nil;
-  }
-  _tableView = tableView;
-  return self;
-}
-
-#pragma mark - ASLayoutController
-
-- (NSHashTable<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType map:(ASElementMap *)map
-{
-  CGRect bounds = _tableView.bounds;
-
-  ASRangeTuningParameters tuningParameters = [self tuningParametersForRangeMode:rangeMode rangeType:rangeType];
-  CGRect rangeBounds = CGRectExpandToRangeWithScrollableDirections(bounds, tuningParameters, ASScrollDirectionVerticalDirections, scrollDirection);
-  NSArray *array = [_tableView indexPathsForRowsInRect:rangeBounds];
-  return ASPointerTableByFlatMapping(array, NSIndexPath *indexPath, [map elementForItemAtIndexPath:indexPath]);
-}
-
-- (void)allElementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode displaySet:(NSHashTable<ASCollectionElement *> *__autoreleasing  _Nullable *)displaySet preloadSet:(NSHashTable<ASCollectionElement *> *__autoreleasing  _Nullable *)preloadSet map:(ASElementMap *)map
-{
-  if (displaySet == NULL || preloadSet == NULL) {
-    return;
-  }
-
-  *displaySet = [self elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay map:map];
-  *preloadSet = [self elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypePreload map:map];
-  return;
-}
-
-@end
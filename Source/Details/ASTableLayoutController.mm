@@ -0,0 +1,268 @@
+//
+//  ASTableLayoutController.mm
+//  Texture
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the /ASDK-Licenses directory of this source tree. An additional
+//  grant of patent rights can be found in the PATENTS file in the same directory.
+//
+//  Modifications to this file made after 4/13/2017 are: Copyright (c) 2017-present,
+//  Pinterest, Inc.  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <AsyncDisplayKit/ASTableLayoutController.h>
+
+#import <UIKit/UIKit.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASCellNode+Internal.h>
+#import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
+#import <AsyncDisplayKit/ASElementMap.h>
+#import <AsyncDisplayKit/ASInternalHelpers.h>
+
+#import <algorithm>
+#import <unordered_map>
+#import <vector>
+
+/**
+ * The offsets of the rows of a section from its first row, as a Fenwick tree over the row heights.
+ * Offsets, height updates and the search for the row at an offset take O(log n).
+ */
+class ASTableRowOffsets {
+public:
+  explicit ASTableRowOffsets(std::vector<CGFloat> heights) : _heights(std::move(heights)), _tree(_heights.size() + 1, 0)
+  {
+    NSInteger count = this->count();
+    for (NSInteger i = 1; i <= count; i++) {
+      _tree[i] += _heights[i - 1];
+      NSInteger parent = i + (i & -i);
+      if (parent <= count) {
+        _tree[parent] += _tree[i];
+      }
+    }
+  }
+
+  NSInteger count() const { return (NSInteger)_heights.size(); }
+
+  /// The sum of the heights of the rows before the row.
+  CGFloat offsetOfRow(NSInteger row) const
+  {
+    CGFloat offset = 0;
+    for (NSInteger i = row; i > 0; i -= (i & -i)) {
+      offset += _tree[i];
+    }
+    return offset;
+  }
+
+  void setHeightOfRow(NSInteger row, CGFloat height)
+  {
+    CGFloat delta = height - _heights[row];
+    _heights[row] = height;
+    for (NSInteger i = row + 1; i <= count(); i += (i & -i)) {
+      _tree[i] += delta;
+    }
+  }
+
+  /// The first row that ends after the offset, or count() if there is none.
+  NSInteger rowAtOffset(CGFloat offset) const
+  {
+    NSInteger count = this->count();
+    NSInteger step = 1;
+    while (step * 2 <= count) {
+      step *= 2;
+    }
+    // Descend the tree, skipping every block of rows that ends at or before the offset.
+    NSInteger row = 0;
+    for (; step > 0; step /= 2) {
+      if (row + step <= count && _tree[row + step] <= offset) {
+        row += step;
+        offset -= _tree[row];
+      }
+    }
+    return row;
+  }
+
+private:
+  std::vector<CGFloat> _heights;
+  std::vector<CGFloat> _tree;
+};
+
+struct ASTableSectionRowOffsets {
+  /// The items of the section. Sections of later maps with the identical array have the same rows.
+  NSArray<ASCollectionElement *> *elements;
+  ASTableRowOffsets rowOffsets;
+  /// The offset of the first row in the table view, after the section header.
+  CGFloat origin;
+};
+
+@interface ASTableLayoutController()
+@end
+
+@implementation ASTableLayoutController {
+  // The row offset index of the last queried map.
+  __weak ASElementMap *_indexedMap;
+  std::vector<ASTableSectionRowOffsets> _sections;
+  BOOL _sectionOriginsValid;
+  // The content height of the table view when the section origins were requested.
+  CGFloat _sectionOriginsContentHeight;
+}
+
+- (instancetype)initWithTableView:(UITableView *)tableView
+{
+  if (!(self = [super init])) {
+    return nil;
+  }
+  _tableView = tableView;
+  return self;
+}
+
+#pragma mark - ASLayoutController
+
+- (NSHashTable<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType map:(ASElementMap *)map
+{
+  ASRangeTuningParameters tuningParameters = [self tuningParametersForRangeMode:rangeMode rangeType:rangeType];
+  CGRect rangeBounds = [self rangeBoundsOfScrollView:_tableView
+                                scrollableDirections:ASScrollDirectionVerticalDirections
+                                     scrollDirection:scrollDirection
+                               rangeTuningParameters:tuningParameters];
+  NSArray *array = [self indexPathsForRowsInRect:rangeBounds map:map];
+  return ASPointerTableByFlatMapping(array, NSIndexPath *indexPath, [map elementForItemAtIndexPath:indexPath]);
+}
+
+- (void)allElementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode displaySet:(NSHashTable<ASCollectionElement *> *__autoreleasing  _Nullable *)displaySet preloadSet:(NSHashTable<ASCollectionElement *> *__autoreleasing  _Nullable *)preloadSet map:(ASElementMap *)map
+{
+  if (displaySet == NULL || preloadSet == NULL) {
+    return;
+  }
+
+  *displaySet = [self elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay map:map];
+  *preloadSet = [self elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypePreload map:map];
+  return;
+}
+
+#pragma mark - Row Offsets
+
+- (NSArray<NSIndexPath *> *)indexPathsForRowsInRect:(CGRect)rect map:(ASElementMap *)map
+{
+  ASDisplayNodeAssertMainThread();
+  // The section origins come from the table view, so it must be showing the map.
+  if (!ASActivateExperimentalFeature(ASExperimentalTableRowOffsets) || map == nil || _tableView.numberOfSections != map.numberOfSections) {
+    return [_tableView indexPathsForRowsInRect:rect];
+  }
+  [self _updateRowOffsetsForMap:map];
+
+  NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray array];
+  if (CGRectIsEmpty(rect)) {
+    return indexPaths;
+  }
+  CGFloat minY = CGRectGetMinY(rect);
+  CGFloat maxY = CGRectGetMaxY(rect);
+  // Start at the last section whose rows start at or before the rect, if any.
+  let firstSectionAfter = std::upper_bound(_sections.begin(), _sections.end(), minY, [](CGFloat y, const ASTableSectionRowOffsets &section) {
+    return y < section.origin;
+  });
+  NSInteger firstSection = MAX((NSInteger)(firstSectionAfter - _sections.begin()) - 1, (NSInteger)0);
+  for (NSInteger section = firstSection; section < (NSInteger)_sections.size() && _sections[section].origin < maxY; section++) {
+    let &rowOffsets = _sections[section].rowOffsets;
+    CGFloat origin = _sections[section].origin;
+    NSInteger firstRow = rowOffsets.rowAtOffset(minY - origin);
+    NSInteger endRow = rowOffsets.rowAtOffset(maxY - origin);
+    if (endRow < rowOffsets.count() && rowOffsets.offsetOfRow(endRow) < maxY - origin) {
+      endRow++;
+    }
+    for (NSInteger row = firstRow; row < endRow; row++) {
+      [indexPaths addObject:[NSIndexPath indexPathForRow:row inSection:section]];
+    }
+  }
+  return indexPaths;
+}
+
+- (void)nodesDidRelayout:(NSArray<ASCellNode *> *)nodes
+{
+  ASDisplayNodeAssertMainThread();
+  ASElementMap *map = _indexedMap;
+  if (map == nil) {
+    return;
+  }
+  CGFloat separatorHeight = [self _separatorHeight];
+  for (ASCellNode *node in nodes) {
+    NSIndexPath *indexPath = [map indexPathForElementIfCell:node.collectionElement];
+    if (indexPath != nil && indexPath.section < (NSInteger)_sections.size() && indexPath.row < _sections[indexPath.section].rowOffsets.count()) {
+      _sections[indexPath.section].rowOffsets.setHeightOfRow(indexPath.row, node.calculatedSize.height + separatorHeight);
+      // The sections after it moved.
+      _sectionOriginsValid = NO;
+    }
+  }
+}
+
+- (void)invalidateRowOffsets
+{
+  _indexedMap = nil;
+  _sections.clear();
+}
+
+/**
+ * UITableView expects row heights to include the separator, see -tableView:heightForRowAtIndexPath: in ASTableView.
+ */
+- (CGFloat)_separatorHeight
+{
+#if TARGET_OS_IOS
+  if (_tableView.separatorStyle != UITableViewCellSeparatorStyleNone) {
+    return 1.0 / ASScreenScale();
+  }
+#endif
+  return 0;
+}
+
+- (void)_updateRowOffsetsForMap:(ASElementMap *)map
+{
+  if (map != _indexedMap) {
+    // Keep the offsets of the sections whose items didn't change, and index the others.
+    std::unordered_map<const void *, NSUInteger> previousSections;
+    for (NSUInteger i = 0; i < _sections.size(); i++) {
+      previousSections[(__bridge const void *)_sections[i].elements] = i;
+    }
+    CGFloat separatorHeight = [self _separatorHeight];
+    std::vector<ASTableSectionRowOffsets> sections;
+    NSInteger sectionCount = map.numberOfSections;
+    sections.reserve(sectionCount);
+    for (NSInteger section = 0; section < sectionCount; section++) {
+      NSArray<ASCollectionElement *> *elements = [map itemElementsInSection:section];
+      let previousSection = previousSections.find((__bridge const void *)elements);
+      if (previousSection != previousSections.end()) {
+        sections.push_back(std::move(_sections[previousSection->second]));
+        previousSections.erase(previousSection);
+        continue;
+      }
+      std::vector<CGFloat> heights;
+      heights.reserve(elements.count);
+      for (ASCollectionElement *element in elements) {
+        heights.push_back(element.nodeIfAllocated.calculatedSize.height + separatorHeight);
+      }
+      sections.push_back({ elements, ASTableRowOffsets(std::move(heights)), 0 });
+    }
+    _sections = std::move(sections);
+    _indexedMap = map;
+    _sectionOriginsValid = NO;
+  }
+
+  // Section origins include the table header and the section headers and footers, which only the table view knows.
+  // They are requested again after rows changed, or if the content height changed without them, e.g. because the
+  // table header or a section header or footer was resized.
+  CGFloat contentHeight = _tableView.contentSize.height;
+  if (!_sectionOriginsValid || contentHeight != _sectionOriginsContentHeight) {
+    for (NSInteger section = 0; section < (NSInteger)_sections.size(); section++) {
+      _sections[section].origin = CGRectGetMinY([_tableView rectForSection:section]) + CGRectGetHeight([_tableView rectForHeaderInSection:section]);
+    }
+    _sectionOriginsValid = YES;
+    _sectionOriginsContentHeight = contentHeight;
+  }
+}
+
+@end
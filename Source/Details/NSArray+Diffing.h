@@ -76,25 +76,37 @@
 /**
  * @abstract Compares two arrays, providing the insertion and deletion indexes needed to transform into the target array.
  * @discussion This compares the equality of each object with `isEqual:`.
- * This diffing algorithm uses a bottom-up memoized longest common subsequence solution to identify differences.
- * It runs in O(mn) complexity.
+ * This diffing algorithm finds a longest common subsequence with Myers' linear space O(ND) algorithm, so it runs in
+ * O((m + n) d) time for d differences and linear memory. Common prefixes and suffixes are matched in linear time.
  */
 - (void)asdk_diffWithArray:(NSArray *)array insertions:(NSIndexSet **)insertions deletions:(NSIndexSet **)deletions;
 
 /**
  * @abstract Compares two arrays, providing the insertion and deletion indexes needed to transform into the target array.
  * @discussion The `compareBlock` is used to identify the equality of the objects within the arrays.
- * This diffing algorithm uses a bottom-up memoized longest common subsequence solution to identify differences.
- * It runs in O(mn) complexity.
+ * This diffing algorithm finds a longest common subsequence with Myers' linear space O(ND) algorithm, so it runs in
+ * O((m + n) d) time for d differences and linear memory. Common prefixes and suffixes are matched in linear time.
  */
 - (void)asdk_diffWithArray:(NSArray *)array insertions:(NSIndexSet **)insertions deletions:(NSIndexSet **)deletions compareBlock:(BOOL (^)(id lhs, id rhs))comparison;
 
 /**
  * @abstract Compares two arrays, providing the insertion, deletion, and move indexes needed to transform into the target array.
  * @discussion This compares the equality of each object with `isEqual:`.
- * This diffing algorithm uses a bottom-up memoized longest common subsequence solution to identify differences.
- * It runs in O(mn) complexity.
+ * This diffing algorithm finds a longest common subsequence with Myers' linear space O(ND) algorithm, so it runs in
+ * O((m + n) d) time for d differences and linear memory. Common prefixes and suffixes are matched in linear time.
  * The moves are returned in ascending order of their destination index.
  */
 - (void)asdk_diffWithArray:(NSArray *)array insertions:(NSIndexSet **)insertions deletions:(NSIndexSet **)deletions moves:(NSArray<NSIndexPath *> **)moves;
+
+/**
+ * @abstract Compares two arrays of distinct objects by pointer identity, providing the insertion, deletion, and move
+ * indexes needed to transform into the target array.
+ * @discussion Unlike the methods above, elements that are not reported as moved keep their relative order but may
+ * shift. To transform `self` into `array`: remove the deleted and moved-from elements, then insert the inserted and
+ * moved-to elements in ascending order of their destination index. Only the elements outside of the longest run that is
+ * in the same relative order in both arrays are reported as moves.
+ * Matching is hash-based, so this runs in O(m + n) plus O(k log k) for the k common elements, with linear memory.
+ * The moves are returned in ascending order of their destination index.
+ */
+- (void)asdk_diffByIdentityWithArray:(NSArray *)array insertions:(NSIndexSet **)insertions deletions:(NSIndexSet **)deletions moves:(NSArray<NSIndexPath *> **)moves;
 @end
@@ -18,12 +18,189 @@
 #import <AsyncDisplayKit/NSArray+Diffing.h>
 #import <UIKit/NSIndexPath+UIKitAdditions.h>
 #import <AsyncDisplayKit/ASAssert.h>
+#import <algorithm>
 #import <unordered_map>
-
-@implementation NSArray (Diffing)
+#import <vector>
 
 typedef BOOL (^compareBlock)(id _Nonnull lhs, id _Nonnull rhs);
 
+#pragma mark - Longest Common Subsequence
+
+/**
+ * Finds a longest common subsequence of two sequences with the linear space variant of Myers' "An O(ND) Difference
+ * Algorithm and Its Variations": the middle snake of the shortest edit script splits the problem in two halves, which
+ * are solved recursively. Common prefixes and suffixes are matched up front, so mostly equal sequences are cheap.
+ *
+ * Equal(i, j) compares element i of the first sequence with element j of the second. The second sequence's indexes of
+ * the common elements are appended to `common` in ascending order.
+ */
+template <typename Equal>
+class ASDiffLongestCommonSubsequence {
+public:
+  ASDiffLongestCommonSubsequence(NSInteger count1, NSInteger count2, const Equal &equal, std::vector<NSInteger> &common)
+  : _equal(equal), _common(common), _forward(count1 + count2 + 4), _backward(count1 + count2 + 4) {}
+
+  void find(NSInteger start1, NSInteger end1, NSInteger start2, NSInteger end2)
+  {
+    while (start1 < end1 && start2 < end2 && _equal(start1, start2)) {
+      _common.push_back(start2);
+      start1++;
+      start2++;
+    }
+    NSInteger suffixCount = 0;
+    while (start1 < end1 && start2 < end2 && _equal(end1 - 1, end2 - 1)) {
+      end1--;
+      end2--;
+      suffixCount++;
+    }
+
+    NSInteger split1, split2;
+    if (start1 < end1 && start2 < end2 && findSplit(start1, end1, start2, end2, &split1, &split2)) {
+      find(start1, start1 + split1, start2, start2 + split2);
+      find(start1 + split1, end1, start2 + split2, end2);
+    }
+
+    for (NSInteger i = 0; i < suffixCount; i++) {
+      _common.push_back(end2 + i);
+    }
+  }
+
+private:
+  /**
+   * Extends the furthest reaching paths from both corners until they overlap, and returns where they do. Returns false
+   * if the sequences have nothing in common. The path buffers are shared by all recursion levels, since a split is
+   * always found before recursing.
+   */
+  bool findSplit(NSInteger start1, NSInteger end1, NSInteger start2, NSInteger end2, NSInteger *split1, NSInteger *split2)
+  {
+    let count1 = end1 - start1;
+    let count2 = end2 - start2;
+    let maxD = (count1 + count2 + 1) / 2;
+    let offset = maxD;
+    let length = 2 * maxD + 2;
+    std::fill(_forward.begin(), _forward.begin() + length, -1);
+    std::fill(_backward.begin(), _backward.begin() + length, -1);
+    _forward[offset + 1] = 0;
+    _backward[offset + 1] = 0;
+
+    let delta = count1 - count2;
+    // If the total length is odd, the forward path reaches the overlap first.
+    let checkForward = (delta % 2 != 0);
+    // Diagonals that left the edit graph are skipped from then on.
+    NSInteger forwardStart = 0, forwardEnd = 0, backwardStart = 0, backwardEnd = 0;
+    for (NSInteger d = 0; d < maxD; d++) {
+      for (NSInteger k = -d + forwardStart; k <= d - forwardEnd; k += 2) {
+        let kOffset = offset + k;
+        NSInteger x = (k == -d || (k != d && _forward[kOffset - 1] < _forward[kOffset + 1]))
+                      ? _forward[kOffset + 1] : _forward[kOffset - 1] + 1;
+        NSInteger y = x - k;
+        while (x < count1 && y < count2 && _equal(start1 + x, start2 + y)) {
+          x++;
+          y++;
+        }
+        _forward[kOffset] = x;
+        if (x > count1) {
+          forwardEnd += 2;
+        } else if (y > count2) {
+          forwardStart += 2;
+        } else if (checkForward) {
+          let backwardOffset = offset + delta - k;
+          if (backwardOffset >= 0 && backwardOffset < length && _backward[backwardOffset] != -1
+              && x >= count1 - _backward[backwardOffset]) {
+            *split1 = x;
+            *split2 = y;
+            return true;
+          }
+        }
+      }
+
+      for (NSInteger k = -d + backwardStart; k <= d - backwardEnd; k += 2) {
+        let kOffset = offset + k;
+        NSInteger x = (k == -d || (k != d && _backward[kOffset - 1] < _backward[kOffset + 1]))
+                      ? _backward[kOffset + 1] : _backward[kOffset - 1] + 1;
+        NSInteger y = x - k;
+        while (x < count1 && y < count2 && _equal(end1 - x - 1, end2 - y - 1)) {
+          x++;
+          y++;
+        }
+        _backward[kOffset] = x;
+        if (x > count1) {
+          backwardEnd += 2;
+        } else if (y > count2) {
+          backwardStart += 2;
+        } else if (!checkForward) {
+          let forwardOffset = offset + delta - k;
+          if (forwardOffset >= 0 && forwardOffset < length && _forward[forwardOffset] != -1) {
+            let forwardX = _forward[forwardOffset];
+            if (forwardX >= count1 - x) {
+              *split1 = forwardX;
+              *split2 = offset + forwardX - forwardOffset;
+              return true;
+            }
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  const Equal &_equal;
+  std::vector<NSInteger> &_common;
+  std::vector<NSInteger> _forward;
+  std::vector<NSInteger> _backward;
+};
+
+/**
+ * Returns the ascending indexes into oldObjects of a longest common subsequence with newObjects. If comparison is nil,
+ * objects are compared with isEqual:.
+ *
+ * Both sequences are searched back to front with the new objects first. Ambiguous diffs, i.e. those with several longest
+ * common subsequences, always resolve the same way, but not necessarily like the LCS matrix that was used before
+ * did: [0,1,1] -> [0,1,0] keeps the old indexes {0,1} where the matrix kept {0,2}.
+ */
+static std::vector<NSUInteger> ASDiffCommonIndexes(const std::vector<unowned id> &oldObjects,
+                                                   const std::vector<unowned id> &newObjects,
+                                                   compareBlock comparison)
+{
+  let oldCount = (NSInteger)oldObjects.size();
+  let newCount = (NSInteger)newObjects.size();
+  std::vector<NSInteger> reversedCommon;
+
+  if (comparison == nil) {
+    // Equal objects have equal hashes, so comparing cached hashes first avoids most -isEqual: messages.
+    std::vector<NSUInteger> oldHashes(oldCount), newHashes(newCount);
+    for (NSInteger i = 0; i < oldCount; i++) {
+      oldHashes[i] = [oldObjects[i] hash];
+    }
+    for (NSInteger i = 0; i < newCount; i++) {
+      newHashes[i] = [newObjects[i] hash];
+    }
+    let equal = [&](NSInteger i, NSInteger j) {
+      let newIndex = newCount - 1 - i;
+      let oldIndex = oldCount - 1 - j;
+      return newHashes[newIndex] == oldHashes[oldIndex]
+             && (newObjects[newIndex] == oldObjects[oldIndex] || [newObjects[newIndex] isEqual:oldObjects[oldIndex]]);
+    };
+    ASDiffLongestCommonSubsequence<decltype(equal)>(newCount, oldCount, equal, reversedCommon).find(0, newCount, 0, oldCount);
+  } else {
+    let equal = [&](NSInteger i, NSInteger j) {
+      return (bool)comparison(oldObjects[oldCount - 1 - j], newObjects[newCount - 1 - i]);
+    };
+    ASDiffLongestCommonSubsequence<decltype(equal)>(newCount, oldCount, equal, reversedCommon).find(0, newCount, 0, oldCount);
+  }
+
+  std::vector<NSUInteger> common;
+  common.reserve(reversedCommon.size());
+  for (auto it = reversedCommon.rbegin(); it != reversedCommon.rend(); it++) {
+    common.push_back(oldCount - 1 - *it);
+  }
+  return common;
+}
+
+#pragma mark - Diffing
+
+@implementation NSArray (Diffing)
+
 - (void)asdk_diffWithArray:(NSArray *)array insertions:(NSIndexSet **)insertions deletions:(NSIndexSet **)deletions
 {
   [self asdk_diffWithArray:array insertions:insertions deletions:deletions moves:nil compareBlock:[NSArray defaultCompareBlock]];
@@ -57,113 +234,171 @@ typedef BOOL (^compareBlock)(id _Nonnull lhs, id _Nonnull rhs);
 
   NSAssert(comparison != nil, @"Comparison block is required");
   NSAssert(moves == nil || comparison == [NSArray defaultCompareBlock], @"move detection requires isEqual: and hash (no custom compare)");
-  NSMutableArray<NSIndexPath *> *moveIndexPaths = nil;
-  NSMutableIndexSet *insertionIndexes = nil, *deletionIndexes = nil;
-  if (moves) {
-    moveIndexPaths = [NSMutableArray new];
-  }
-  NSMutableIndexSet *commonIndexes = [self _asdk_commonIndexesWithArray:array compareBlock:comparison];
+  NSUInteger selfCount = self.count;
+  NSUInteger arrayCount = array.count;
+  std::vector<unowned id> selfObjects(selfCount), arrayObjects(arrayCount);
+  [self getObjects:selfObjects.data() range:NSMakeRange(0, selfCount)];
+  [array getObjects:arrayObjects.data() range:NSMakeRange(0, arrayCount)];
+  BOOL isDefaultComparison = (comparison == [NSArray defaultCompareBlock]);
+  std::vector<NSUInteger> commonIndexes = ASDiffCommonIndexes(selfObjects, arrayObjects, isDefaultComparison ? nil : comparison);
 
-  if (deletions || moves) {
-    deletionIndexes = [NSMutableIndexSet indexSet];
-    NSUInteger i = 0;
-    for (id element in self) {
-      if (![commonIndexes containsIndex:i]) {
-        [deletionIndexes addIndex:i];
-      }
-      if (moves) {
-        potentialMoves.insert(std::pair<id, NSUInteger>(element, i));
-      }
-      ++i;
+  // Position of each common index in commonIndexes, or NSNotFound.
+  std::vector<NSUInteger> commonPositions(selfCount, NSNotFound);
+  for (NSUInteger p = 0; p < commonIndexes.size(); p++) {
+    commonPositions[commonIndexes[p]] = p;
+  }
+  std::vector<bool> deleted(selfCount);
+  for (NSUInteger i = 0; i < selfCount; i++) {
+    deleted[i] = (commonPositions[i] == NSNotFound);
+    if (moves) {
+      potentialMoves.insert(std::pair<id, NSUInteger>(selfObjects[i], i));
     }
   }
 
-  if (insertions || moves) {
-    insertionIndexes = [NSMutableIndexSet indexSet];
-    NSArray *commonObjects = [self objectsAtIndexes:commonIndexes];
-    for (NSUInteger i = 0, j = 0; j < array.count; j++) {
-      auto moveFound = potentialMoves.find(array[j]);
-      NSUInteger movedFrom = NSNotFound;
-      if (moveFound != potentialMoves.end() && moveFound->second != j) {
-        movedFrom = moveFound->second;
-        potentialMoves.erase(moveFound);
-        [moveIndexPaths addObject:[NSIndexPath indexPathForItem:j inSection:movedFrom]];
-      }
-      if (i < commonObjects.count && j < array.count && comparison(commonObjects[i], array[j])) {
-        i++;
-      } else {
-        if (movedFrom != NSNotFound) {
-          // moves will coalesce a delete / insert - the insert is just not done, and here we remove the delete:
-          [deletionIndexes removeIndex:movedFrom];
-          // OR a move will have come from the LCS:
-          if ([commonIndexes containsIndex:movedFrom]) {
-            [commonIndexes removeIndex:movedFrom];
-            commonObjects = [self objectsAtIndexes:commonIndexes];
+  NSMutableArray<NSIndexPath *> *moveIndexPaths = moves ? [NSMutableArray new] : nil;
+  NSMutableIndexSet *insertionIndexes = [NSMutableIndexSet indexSet];
+  // Walk the common objects alongside the target array. A move out of the common subsequence removes that common
+  // object, so p always points at the next common object that hasn't been removed.
+  std::vector<bool> removedCommonPositions(commonIndexes.size());
+  let commonCount = commonIndexes.size();
+  let advance = [&](NSUInteger &p) {
+    do {
+      p++;
+    } while (p < commonCount && removedCommonPositions[p]);
+  };
+  NSUInteger p = 0;
+  for (NSUInteger j = 0; j < arrayCount; j++) {
+    auto moveFound = potentialMoves.find(arrayObjects[j]);
+    NSUInteger movedFrom = NSNotFound;
+    if (moveFound != potentialMoves.end() && moveFound->second != j) {
+      movedFrom = moveFound->second;
+      potentialMoves.erase(moveFound);
+      [moveIndexPaths addObject:[NSIndexPath indexPathForItem:j inSection:movedFrom]];
+    }
+    if (p < commonCount && comparison(selfObjects[commonIndexes[p]], arrayObjects[j])) {
+      advance(p);
+    } else {
+      if (movedFrom != NSNotFound) {
+        // moves will coalesce a delete / insert - the insert is just not done, and here we remove the delete:
+        deleted[movedFrom] = false;
+        // OR a move will have come from the LCS:
+        let position = commonPositions[movedFrom];
+        if (position != NSNotFound) {
+          commonPositions[movedFrom] = NSNotFound;
+          removedCommonPositions[position] = true;
+          if (position <= p) {
+            advance(p);
           }
-        } else {
-          [insertionIndexes addIndex:j];
         }
+      } else {
+        [insertionIndexes addIndex:j];
       }
     }
   }
 
   if (moves) {*moves = moveIndexPaths;}
-  if (deletions) {*deletions = deletionIndexes;}
+  if (deletions) {
+    NSMutableIndexSet *deletionIndexes = [NSMutableIndexSet indexSet];
+    for (NSUInteger i = 0; i < selfCount; i++) {
+      if (deleted[i]) {
+        [deletionIndexes addIndex:i];
+      }
+    }
+    *deletions = deletionIndexes;
+  }
   if (insertions) {*insertions = insertionIndexes;}
 }
 
-// https://github.com/raywenderlich/swift-algorithm-club/tree/master/Longest%20Common%20Subsequence is not exactly this code (obviously), but
-// is a good commentary on the algorithm.
-- (NSMutableIndexSet *)_asdk_commonIndexesWithArray:(NSArray *)array compareBlock:(BOOL (^)(id lhs, id rhs))comparison
+- (void)asdk_diffByIdentityWithArray:(NSArray *)array insertions:(NSIndexSet **)insertions deletions:(NSIndexSet **)deletions
+                               moves:(NSArray<NSIndexPath *> **)moves
 {
-  NSAssert(comparison != nil, @"Comparison block is required");
+  NSUInteger selfCount = self.count;
+  NSUInteger arrayCount = array.count;
 
-  NSInteger selfCount = self.count;
-  NSInteger arrayCount = array.count;
-
-  // Allocate the diff map in the heap so we don't blow the stack for large arrays.
-  NSInteger **lengths = NULL;
-  lengths = (NSInteger **)malloc(sizeof(NSInteger*) * (selfCount+1));
-  if (lengths == NULL) {
-    ASDisplayNodeFailAssert(@"Failed to allocate memory for diffing");
-    return nil;
-  }
-  // Fill in a LCS length matrix:
-  for (NSInteger i = 0; i <= selfCount; i++) {
-    lengths[i] = (NSInteger *)malloc(sizeof(NSInteger) * (arrayCount+1));
-    if (lengths[i] == NULL) {
-      ASDisplayNodeFailAssert(@"Failed to allocate memory for diffing");
-      return nil;
-    }
-    id selfObj = i > 0 ? self[i-1] : nil;
-    for (NSInteger j = 0; j <= arrayCount; j++) {
-      if (i == 0 || j == 0) {
-        lengths[i][j] = 0;
-      } else if (comparison(selfObj, array[j-1])) {
-        lengths[i][j] = 1 + lengths[i-1][j-1];
-      } else {
-        lengths[i][j] = MAX(lengths[i-1][j], lengths[i][j-1]);
-      }
+  // Old index of each object. If an object occurs more than once, only its first occurrence can be matched.
+  std::unordered_map<const void *, NSUInteger> oldIndexes;
+  oldIndexes.reserve(selfCount);
+  NSUInteger i = 0;
+  for (id object in self) {
+    oldIndexes.emplace((__bridge const void *)object, i++);
+  }
+
+  // Match every object of the target array against its old index.
+  NSMutableIndexSet *insertionIndexes = [NSMutableIndexSet indexSet];
+  std::vector<bool> matchedOldIndexes(selfCount, false);
+  std::vector<std::pair<NSUInteger, NSUInteger>> matches; // (from, to)
+  matches.reserve(MIN(selfCount, arrayCount));
+  NSUInteger j = 0;
+  for (id object in array) {
+    let it = oldIndexes.find((__bridge const void *)object);
+    if (it == oldIndexes.end()) {
+      [insertionIndexes addIndex:j];
+    } else {
+      matches.emplace_back(it->second, j);
+      matchedOldIndexes[it->second] = true;
+      oldIndexes.erase(it);
     }
+    j++;
   }
-  // Backtrack to fill in indices based on length matrix:
-  NSMutableIndexSet *common = [NSMutableIndexSet indexSet];
-  NSInteger i = selfCount, j = arrayCount;
-  while(i > 0 && j > 0) {
-    if (comparison(self[i-1], array[j-1])) {
-      [common addIndex:(i-1)];
-      i--; j--;
-    } else if (lengths[i-1][j] > lengths[i][j-1]) {
-      i--;
+
+  // Keep the longest run of matches that is increasing in both arrays in place (patience sorting), move the rest.
+  let matchCount = matches.size();
+  std::vector<NSUInteger> tails;          // Index into matches of the smallest tail of each run length.
+  std::vector<NSInteger> predecessors(matchCount, -1);
+  for (NSUInteger m = 0; m < matchCount; m++) {
+    let tail = std::lower_bound(tails.begin(), tails.end(), matches[m].first, [&](NSUInteger t, NSUInteger from) {
+      return matches[t].first < from;
+    });
+    if (tail != tails.begin()) {
+      predecessors[m] = *(tail - 1);
+    }
+    if (tail == tails.end()) {
+      tails.push_back(m);
     } else {
-      j--;
+      *tail = m;
     }
   }
+  std::vector<bool> unmoved(matchCount, false);
+  for (NSInteger m = tails.empty() ? -1 : tails.back(); m != -1; m = predecessors[m]) {
+    unmoved[m] = true;
+  }
 
-  for (NSInteger i = 0; i <= selfCount; i++) {
-    free(lengths[i]);
+  if (moves) {
+    NSMutableArray<NSIndexPath *> *moveIndexPaths = [NSMutableArray arrayWithCapacity:matchCount - tails.size()];
+    for (NSUInteger m = 0; m < matchCount; m++) {
+      if (!unmoved[m]) {
+        [moveIndexPaths addObject:[NSIndexPath indexPathForItem:matches[m].second inSection:matches[m].first]];
+      }
+    }
+    *moves = moveIndexPaths;
+  }
+  if (deletions) {
+    NSMutableIndexSet *deletionIndexes = [NSMutableIndexSet indexSet];
+    for (NSUInteger k = 0; k < selfCount; k++) {
+      if (!matchedOldIndexes[k]) {
+        [deletionIndexes addIndex:k];
+      }
+    }
+    *deletions = deletionIndexes;
+  }
+  if (insertions) {
+    *insertions = insertionIndexes;
+  }
+}
+
+- (NSMutableIndexSet *)_asdk_commonIndexesWithArray:(NSArray *)array compareBlock:(BOOL (^)(id lhs, id rhs))comparison
+{
+  NSAssert(comparison != nil, @"Comparison block is required");
+
+  std::vector<unowned id> selfObjects(self.count), arrayObjects(array.count);
+  [self getObjects:selfObjects.data() range:NSMakeRange(0, selfObjects.size())];
+  [array getObjects:arrayObjects.data() range:NSMakeRange(0, arrayObjects.size())];
+
+  NSMutableIndexSet *common = [NSMutableIndexSet indexSet];
+  BOOL isDefaultComparison = (comparison == [NSArray defaultCompareBlock]);
+  for (NSUInteger index : ASDiffCommonIndexes(selfObjects, arrayObjects, isDefaultComparison ? nil : comparison)) {
+    [common addIndex:index];
   }
-  free(lengths);
   return common;
 }
 
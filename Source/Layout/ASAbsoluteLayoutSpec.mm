@@ -75,13 +75,14 @@
   NSMutableArray *sublayouts = [NSMutableArray arrayWithCapacity:children.count];
 
   for (id<ASLayoutElement> child in children) {
-    CGPoint layoutPosition = child.style.layoutPosition;
+    const ASLayoutElementStyleValues style = child.style.values;
+    CGPoint layoutPosition = style.layoutPosition;
     CGSize autoMaxSize = {
       constrainedSize.max.width  - layoutPosition.x,
       constrainedSize.max.height - layoutPosition.y
     };
 
-    const ASSizeRange childConstraint = ASLayoutElementSizeResolveAutoSize(child.style.size, size, {{0,0}, autoMaxSize});
+    const ASSizeRange childConstraint = ASLayoutElementSizeResolveAutoSize(style.size, size, {{0,0}, autoMaxSize});
     
     ASLayout *sublayout = [child layoutThatFits:childConstraint parentSize:size];
     sublayout.position = layoutPosition;
@@ -18,6 +18,7 @@
 #import <AsyncDisplayKit/ASBackgroundLayoutSpec.h>
 
 #import <AsyncDisplayKit/ASLayoutSpec+Subclasses.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 
 #import <AsyncDisplayKit/ASAssert.h>
 
@@ -47,6 +48,11 @@ static NSUInteger const kBackgroundChildIndex = 1;
 
 #pragma mark - ASLayoutSpec
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  return ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASBackgroundLayoutSpec class]);
+}
+
 /**
  * First layout the contents, then fit the background image.
  */
@@ -18,6 +18,7 @@
 #import <AsyncDisplayKit/ASCenterLayoutSpec.h>
 
 #import <AsyncDisplayKit/ASLayout.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 
 @implementation ASCenterLayoutSpec
 {
@@ -63,6 +64,16 @@
   [self setSizingOption:sizingOptions];
 }
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  if (!ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASCenterLayoutSpec class])) {
+    return NO;
+  }
+  ASCenterLayoutSpec *centerLayoutSpec = (ASCenterLayoutSpec *)layoutSpec;
+  return _centeringOptions == centerLayoutSpec->_centeringOptions
+      && _sizingOptions == centerLayoutSpec->_sizingOptions;
+}
+
 - (ASRelativeLayoutSpecPosition)horizontalPositionFromCenteringOptions:(ASCenterLayoutSpecCenteringOptions)centeringOptions
 {
   if ((centeringOptions & ASCenterLayoutSpecCenteringX) != 0) {
@@ -20,9 +20,15 @@
 #import <AsyncDisplayKit/CoreGraphics+ASConvenience.h>
 
 #import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASLayoutEngineDimension.h>
 
 #pragma mark - ASDimension
 
+// The shared dimension math converts units with static_cast, so the values of both sides must match.
+static_assert((NSInteger)ASDimensionUnitAuto == (NSInteger)ASCore::DimensionUnit::Auto, "Dimension unit values must match the engine");
+static_assert((NSInteger)ASDimensionUnitPoints == (NSInteger)ASCore::DimensionUnit::Points, "Dimension unit values must match the engine");
+static_assert((NSInteger)ASDimensionUnitFraction == (NSInteger)ASCore::DimensionUnit::Fraction, "Dimension unit values must match the engine");
+
 ASDimension const ASDimensionAuto = {ASDimensionUnitAuto, 0};
 
 ASOVERLOADABLE ASDimension ASDimensionMake(NSString *dimension)
@@ -70,36 +76,9 @@ ASSizeRange const ASSizeRangeZero = {};
 
 ASSizeRange const ASSizeRangeUnconstrained = { {0, 0}, { INFINITY, INFINITY }};
 
-struct _Range {
-  CGFloat min;
-  CGFloat max;
-  
-  /**
-   Intersects another dimension range. If the other range does not overlap, this size range "wins" by returning a
-   single point within its own range that is closest to the non-overlapping range.
-   */
-  _Range intersect(const _Range &other) const
-  {
-  CGFloat newMin = MAX(min, other.min);
-  CGFloat newMax = MIN(max, other.max);
-  if (newMin <= newMax) {
-    return {newMin, newMax};
-  } else {
-    // No intersection. If we're before the other range, return our max; otherwise our min.
-    if (min < other.min) {
-      return {max, max};
-    } else {
-      return {min, min};
-    }
-  }
-  }
-};
-
 ASSizeRange ASSizeRangeIntersect(ASSizeRange sizeRange, ASSizeRange otherSizeRange)
 {
-  let w = _Range({sizeRange.min.width, sizeRange.max.width}).intersect({otherSizeRange.min.width, otherSizeRange.max.width});
-  let h = _Range({sizeRange.min.height, sizeRange.max.height}).intersect({otherSizeRange.min.height, otherSizeRange.max.height});
-  return {{w.min, h.min}, {w.max, h.max}};
+  return ASCore::SizeRangeIntersect(sizeRange, otherSizeRange);
 }
 
 NSString *NSStringFromASSizeRange(ASSizeRange sizeRange)
@@ -18,6 +18,7 @@
 #import <AsyncDisplayKit/ASInsetLayoutSpec.h>
 
 #import <AsyncDisplayKit/ASLayoutSpec+Subclasses.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
@@ -70,6 +71,12 @@ static CGFloat centerInset(CGFloat outer, CGFloat inner)
   _insets = insets;
 }
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  return ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASInsetLayoutSpec class])
+      && UIEdgeInsetsEqualToEdgeInsets(_insets, ((ASInsetLayoutSpec *)layoutSpec)->_insets);
+}
+
 /**
  Inset will compute a new constrained size for it's child after applying insets and re-positioning
  the child to respect the inset.
@@ -19,6 +19,7 @@
 
 #import <atomic>
 #import <queue>
+#import <vector>
 
 #import <AsyncDisplayKit/ASCollections.h>
 #import <AsyncDisplayKit/ASDimension.h>
@@ -61,6 +62,10 @@ ASDISPLAYNODE_INLINE AS_WARN_UNUSED_RESULT BOOL ASLayoutIsDisplayNodeType(ASLayo
 {
   ASLayoutElementType _layoutElementType;
   std::atomic_bool _retainSublayoutElements;
+  // The frames of the sublayouts at creation time, in the same order as the sublayouts.
+  std::vector<CGRect> _sublayoutFrames;
+  // Built from the sublayout frames on the first lookup, holds a +1 reference.
+  std::atomic<CFTypeRef> _elementToRectMap;
 }
 
 @property (nonatomic, readonly) ASRectMap *elementToRectMap;
@@ -119,10 +124,12 @@ static std::atomic_bool static_retainsSublayoutLayoutElements = ATOMIC_VAR_INIT(
 
     _sublayouts = [sublayouts copy] ?: @[];
 
+    // Most layouts never have their frames looked up, so only record the frames here and
+    // build the rect map lazily.
     if (_sublayouts.count > 0) {
-      _elementToRectMap = [ASRectMap rectMapForWeakObjectPointers];
-      for (ASLayout *layout in sublayouts) {
-        [_elementToRectMap setRect:layout.frame forKey:layout.layoutElement];
+      _sublayoutFrames.reserve(_sublayouts.count);
+      for (ASLayout *layout in _sublayouts) {
+        _sublayoutFrames.push_back(layout.frame);
       }
     }
     
@@ -167,6 +174,10 @@ static std::atomic_bool static_retainsSublayoutLayoutElements = ATOMIC_VAR_INIT(
 
 - (void)dealloc
 {
+  if (let elementToRectMap = _elementToRectMap.load()) {
+    CFRelease(elementToRectMap);
+  }
+
   if (_retainSublayoutElements.load()) {
     for (ASLayout *sublayout in _sublayouts) {
       // We retained this, so there's no risk of it deallocating on us.
@@ -300,9 +311,31 @@ static std::atomic_bool static_retainsSublayoutLayoutElements = ATOMIC_VAR_INIT(
   return _layoutElementType;
 }
 
+- (ASRectMap *)elementToRectMap
+{
+  CFTypeRef elementToRectMap = _elementToRectMap.load();
+  if (elementToRectMap == NULL && !_sublayoutFrames.empty()) {
+    ASRectMap *newElementToRectMap = [ASRectMap rectMapForWeakObjectPointers];
+    NSUInteger i = 0;
+    for (ASLayout *sublayout in _sublayouts) {
+      [newElementToRectMap setRect:_sublayoutFrames[i++] forKey:sublayout.layoutElement];
+    }
+    
+    CFTypeRef expected = NULL;
+    elementToRectMap = CFBridgingRetain(newElementToRectMap);
+    if (!_elementToRectMap.compare_exchange_strong(expected, elementToRectMap)) {
+      // Another thread built the map first, use that one.
+      CFRelease(elementToRectMap);
+      elementToRectMap = expected;
+    }
+  }
+  return (__bridge ASRectMap *)elementToRectMap;
+}
+
 - (CGRect)frameForElement:(id<ASLayoutElement>)layoutElement
 {
-  return _elementToRectMap ? [_elementToRectMap rectForKey:layoutElement] : CGRectNull;
+  ASRectMap *elementToRectMap = self.elementToRectMap;
+  return elementToRectMap ? [elementToRectMap rectForKey:layoutElement] : CGRectNull;
 }
 
 - (CGRect)frame
@@ -19,6 +19,7 @@
 #import <AsyncDisplayKit/ASAvailability.h>
 #import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASLayoutElement.h>
+#import <AsyncDisplayKit/ASLayoutElementStylePrivate.h>
 #import <AsyncDisplayKit/ASThread.h>
 #import <AsyncDisplayKit/ASObjectDescriptionHelpers.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
@@ -147,11 +148,49 @@ NSString * const ASYogaBorderProperty = @"ASYogaBorderProperty";
 NSString * const ASYogaAspectRatioProperty = @"ASYogaAspectRatioProperty";
 #endif
 
-#define ASLayoutElementStyleSetSizeWithScope(x) \
+static BOOL ASLayoutElementStyleValuesEqualIgnoringBaseline(const ASLayoutElementStyleValues &lhs, const ASLayoutElementStyleValues &rhs)
+{
+  if (!ASLayoutElementSizeEqualToLayoutElementSize(lhs.size, rhs.size)
+      || lhs.spacingBefore != rhs.spacingBefore
+      || lhs.spacingAfter != rhs.spacingAfter
+      || lhs.flexGrow != rhs.flexGrow
+      || lhs.flexShrink != rhs.flexShrink
+      || !ASDimensionEqualToDimension(lhs.flexBasis, rhs.flexBasis)
+      || lhs.alignSelf != rhs.alignSelf
+      || !CGPointEqualToPoint(lhs.layoutPosition, rhs.layoutPosition)) {
+    return NO;
+  }
+  for (int i = 0; i < kMaxLayoutElementBoolExtensions; i++) {
+    if (lhs.extensions.boolExtensions[i] != rhs.extensions.boolExtensions[i]) {
+      return NO;
+    }
+  }
+  for (int i = 0; i < kMaxLayoutElementStateIntegerExtensions; i++) {
+    if (lhs.extensions.integerExtensions[i] != rhs.extensions.integerExtensions[i]) {
+      return NO;
+    }
+  }
+  for (int i = 0; i < kMaxLayoutElementStateEdgeInsetExtensions; i++) {
+    if (!UIEdgeInsetsEqualToEdgeInsets(lhs.extensions.edgeInsetsExtensions[i], rhs.extensions.edgeInsetsExtensions[i])) {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+/**
+ * Writes to a style's values are serialized by its instance lock and use the version as a seqlock sequence: it is odd
+ * while a write is in progress and bumped to the next even value once the write is done.
+ */
+#define ASLayoutElementStyleSetValues(x) \
   __instanceLock__.lock(); \
-  ASLayoutElementSize newSize = _size.load(); \
-  { x } \
-  _size.store(newSize); \
+  { \
+    NSUInteger sequence = _version.load(std::memory_order_relaxed); \
+    _version.store(sequence + 1, std::memory_order_relaxed); \
+    std::atomic_thread_fence(std::memory_order_release); \
+    { x } \
+    _version.store(sequence + 2, std::memory_order_release); \
+  } \
   __instanceLock__.unlock();
 
 #define ASLayoutElementStyleCallDelegate(propertyName)\
@@ -160,20 +199,33 @@ do {\
   [_delegate style:self propertyDidChange:propertyName];\
 } while(0)
 
+/**
+ * Copies values of a style without taking its lock. Retries while a write is in progress or if one happened during
+ * the copy.
+ */
+template <typename F>
+ASDISPLAYNODE_INLINE auto ASLayoutElementStyleReadValues(const std::atomic<NSUInteger> &version, F copy) -> decltype(copy())
+{
+  while (true) {
+    NSUInteger sequence = version.load(std::memory_order_acquire);
+    if ((sequence & 1) == 0) {
+      let values = copy();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (version.load(std::memory_order_relaxed) == sequence) {
+        return values;
+      }
+    }
+  }
+}
+
 @implementation ASLayoutElementStyle {
   ASDN::RecursiveMutex __instanceLock__;
-  ASLayoutElementStyleExtensions _extensions;
   
-  std::atomic<ASLayoutElementSize> _size;
-  std::atomic<CGFloat> _spacingBefore;
-  std::atomic<CGFloat> _spacingAfter;
-  std::atomic<CGFloat> _flexGrow;
-  std::atomic<CGFloat> _flexShrink;
-  std::atomic<ASDimension> _flexBasis;
-  std::atomic<ASStackLayoutAlignSelf> _alignSelf;
-  std::atomic<CGFloat> _ascender;
-  std::atomic<CGFloat> _descender;
-  std::atomic<CGPoint> _layoutPosition;
+  // Protected by the seqlock, see ASLayoutElementStyleSetValues and ASLayoutElementStyleReadValues.
+  std::atomic<NSUInteger> _version;
+  // The part of the version that is due to writes of ascender and descender. Only written within the seqlock.
+  std::atomic<NSUInteger> _baselineVersion;
+  ASLayoutElementStyleValues _values;
 
 #if YOGA
   YGNodeRef _yogaNode;
@@ -209,24 +261,58 @@ do {\
 {
   self = [super init];
   if (self) {
-    _size = ASLayoutElementSizeMake();
+    _values.size = ASLayoutElementSizeMake();
   }
   return self;
 }
 
 ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
+#pragma mark - Versioning
+
+- (NSUInteger)version
+{
+  return _version.load();
+}
+
+- (NSUInteger)versionIgnoringBaseline
+{
+  return ASLayoutElementStyleReadValues(_version, [&]{
+    return _version.load(std::memory_order_relaxed) - _baselineVersion.load(std::memory_order_relaxed);
+  });
+}
+
+- (ASLayoutElementStyleValues)values
+{
+  return ASLayoutElementStyleReadValues(_version, [&]{
+    ASLayoutElementStyleValues values = _values;
+    values.version = _version.load(std::memory_order_relaxed);
+    return values;
+  });
+}
+
+- (BOOL)isEqualToStyleIgnoringBaseline:(ASLayoutElementStyle *)style
+{
+  if (style == self) {
+    return YES;
+  }
+  if (style == nil) {
+    return NO;
+  }
+  return ASLayoutElementStyleValuesEqualIgnoringBaseline(self.values, style.values);
+}
+
 #pragma mark - ASLayoutElementStyleSize
 
 - (ASLayoutElementSize)size
 {
-  return _size.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.size; });
 }
 
 - (void)setSize:(ASLayoutElementSize)size
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize = size;
+  ASLayoutElementStyleSetValues({
+    _values.size = size;
   });
   // No CallDelegate method as ASLayoutElementSize is currently internal.
 }
@@ -235,78 +321,78 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (ASDimension)width
 {
-  return _size.load().width;
+  return self.size.width;
 }
 
 - (void)setWidth:(ASDimension)width
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.width = width;
+  ASLayoutElementStyleSetValues({
+    _values.size.width = width;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleWidthProperty);
 }
 
 - (ASDimension)height
 {
-  return _size.load().height;
+  return self.size.height;
 }
 
 - (void)setHeight:(ASDimension)height
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.height = height;
+  ASLayoutElementStyleSetValues({
+    _values.size.height = height;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleHeightProperty);
 }
 
 - (ASDimension)minWidth
 {
-  return _size.load().minWidth;
+  return self.size.minWidth;
 }
 
 - (void)setMinWidth:(ASDimension)minWidth
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.minWidth = minWidth;
+  ASLayoutElementStyleSetValues({
+    _values.size.minWidth = minWidth;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMinWidthProperty);
 }
 
 - (ASDimension)maxWidth
 {
-  return _size.load().maxWidth;
+  return self.size.maxWidth;
 }
 
 - (void)setMaxWidth:(ASDimension)maxWidth
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.maxWidth = maxWidth;
+  ASLayoutElementStyleSetValues({
+    _values.size.maxWidth = maxWidth;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMaxWidthProperty);
 }
 
 - (ASDimension)minHeight
 {
-  return _size.load().minHeight;
+  return self.size.minHeight;
 }
 
 - (void)setMinHeight:(ASDimension)minHeight
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.minHeight = minHeight;
+  ASLayoutElementStyleSetValues({
+    _values.size.minHeight = minHeight;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMinHeightProperty);
 }
 
 - (ASDimension)maxHeight
 {
-  return _size.load().maxHeight;
+  return self.size.maxHeight;
 }
 
 - (void)setMaxHeight:(ASDimension)maxHeight
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.maxHeight = maxHeight;
+  ASLayoutElementStyleSetValues({
+    _values.size.maxHeight = maxHeight;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMaxHeightProperty);
 }
@@ -316,9 +402,9 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (void)setPreferredSize:(CGSize)preferredSize
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.width = ASDimensionMakeWithPoints(preferredSize.width);
-    newSize.height = ASDimensionMakeWithPoints(preferredSize.height);
+  ASLayoutElementStyleSetValues({
+    _values.size.width = ASDimensionMakeWithPoints(preferredSize.width);
+    _values.size.height = ASDimensionMakeWithPoints(preferredSize.height);
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleWidthProperty);
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleHeightProperty);
@@ -326,7 +412,7 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (CGSize)preferredSize
 {
-  ASLayoutElementSize size = _size.load();
+  ASLayoutElementSize size = self.size;
   if (size.width.unit == ASDimensionUnitFraction) {
     NSCAssert(NO, @"Cannot get preferredSize of element with fractional width. Width: %@.", NSStringFromASDimension(size.width));
     return CGSizeZero;
@@ -342,9 +428,9 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (void)setMinSize:(CGSize)minSize
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.minWidth = ASDimensionMakeWithPoints(minSize.width);
-    newSize.minHeight = ASDimensionMakeWithPoints(minSize.height);
+  ASLayoutElementStyleSetValues({
+    _values.size.minWidth = ASDimensionMakeWithPoints(minSize.width);
+    _values.size.minHeight = ASDimensionMakeWithPoints(minSize.height);
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMinWidthProperty);
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMinHeightProperty);
@@ -352,9 +438,9 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (void)setMaxSize:(CGSize)maxSize
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.maxWidth = ASDimensionMakeWithPoints(maxSize.width);
-    newSize.maxHeight = ASDimensionMakeWithPoints(maxSize.height);
+  ASLayoutElementStyleSetValues({
+    _values.size.maxWidth = ASDimensionMakeWithPoints(maxSize.width);
+    _values.size.maxHeight = ASDimensionMakeWithPoints(maxSize.height);
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMaxWidthProperty);
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMaxHeightProperty);
@@ -362,15 +448,15 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (ASLayoutSize)preferredLayoutSize
 {
-  ASLayoutElementSize size = _size.load();
+  ASLayoutElementSize size = self.size;
   return ASLayoutSizeMake(size.width, size.height);
 }
 
 - (void)setPreferredLayoutSize:(ASLayoutSize)preferredLayoutSize
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.width = preferredLayoutSize.width;
-    newSize.height = preferredLayoutSize.height;
+  ASLayoutElementStyleSetValues({
+    _values.size.width = preferredLayoutSize.width;
+    _values.size.height = preferredLayoutSize.height;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleWidthProperty);
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleHeightProperty);
@@ -378,15 +464,15 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (ASLayoutSize)minLayoutSize
 {
-  ASLayoutElementSize size = _size.load();
+  ASLayoutElementSize size = self.size;
   return ASLayoutSizeMake(size.minWidth, size.minHeight);
 }
 
 - (void)setMinLayoutSize:(ASLayoutSize)minLayoutSize
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.minWidth = minLayoutSize.width;
-    newSize.minHeight = minLayoutSize.height;
+  ASLayoutElementStyleSetValues({
+    _values.size.minWidth = minLayoutSize.width;
+    _values.size.minHeight = minLayoutSize.height;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMinWidthProperty);
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMinHeightProperty);
@@ -394,15 +480,15 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (ASLayoutSize)maxLayoutSize
 {
-  ASLayoutElementSize size = _size.load();
+  ASLayoutElementSize size = self.size;
   return ASLayoutSizeMake(size.maxWidth, size.maxHeight);
 }
 
 - (void)setMaxLayoutSize:(ASLayoutSize)maxLayoutSize
 {
-  ASLayoutElementStyleSetSizeWithScope({
-    newSize.maxWidth = maxLayoutSize.width;
-    newSize.maxHeight = maxLayoutSize.height;
+  ASLayoutElementStyleSetValues({
+    _values.size.maxWidth = maxLayoutSize.width;
+    _values.size.maxHeight = maxLayoutSize.height;
   });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMaxWidthProperty);
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleMaxHeightProperty);
@@ -412,103 +498,123 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 
 - (void)setSpacingBefore:(CGFloat)spacingBefore
 {
-  _spacingBefore.store(spacingBefore);
+  ASLayoutElementStyleSetValues({
+    _values.spacingBefore = spacingBefore;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleSpacingBeforeProperty);
 }
 
 - (CGFloat)spacingBefore
 {
-  return _spacingBefore.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.spacingBefore; });
 }
 
 - (void)setSpacingAfter:(CGFloat)spacingAfter
 {
-  _spacingAfter.store(spacingAfter);
+  ASLayoutElementStyleSetValues({
+    _values.spacingAfter = spacingAfter;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleSpacingAfterProperty);
 }
 
 - (CGFloat)spacingAfter
 {
-  return _spacingAfter.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.spacingAfter; });
 }
 
 - (void)setFlexGrow:(CGFloat)flexGrow
 {
-  _flexGrow.store(flexGrow);
+  ASLayoutElementStyleSetValues({
+    _values.flexGrow = flexGrow;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleFlexGrowProperty);
 }
 
 - (CGFloat)flexGrow
 {
-  return _flexGrow.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.flexGrow; });
 }
 
 - (void)setFlexShrink:(CGFloat)flexShrink
 {
-  _flexShrink.store(flexShrink);
+  ASLayoutElementStyleSetValues({
+    _values.flexShrink = flexShrink;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleFlexShrinkProperty);
 }
 
 - (CGFloat)flexShrink
 {
-  return _flexShrink.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.flexShrink; });
 }
 
 - (void)setFlexBasis:(ASDimension)flexBasis
 {
-  _flexBasis.store(flexBasis);
+  ASLayoutElementStyleSetValues({
+    _values.flexBasis = flexBasis;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleFlexBasisProperty);
 }
 
 - (ASDimension)flexBasis
 {
-  return _flexBasis.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.flexBasis; });
 }
 
 - (void)setAlignSelf:(ASStackLayoutAlignSelf)alignSelf
 {
-  _alignSelf.store(alignSelf);
+  ASLayoutElementStyleSetValues({
+    _values.alignSelf = alignSelf;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleAlignSelfProperty);
 }
 
 - (ASStackLayoutAlignSelf)alignSelf
 {
-  return _alignSelf.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.alignSelf; });
 }
 
 - (void)setAscender:(CGFloat)ascender
 {
-  _ascender.store(ascender);
+  ASLayoutElementStyleSetValues({
+    _values.ascender = ascender;
+    _baselineVersion.fetch_add(2, std::memory_order_relaxed);
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleAscenderProperty);
 }
 
 - (CGFloat)ascender
 {
-  return _ascender.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.ascender; });
 }
 
 - (void)setDescender:(CGFloat)descender
 {
-  _descender.store(descender);
+  ASLayoutElementStyleSetValues({
+    _values.descender = descender;
+    _baselineVersion.fetch_add(2, std::memory_order_relaxed);
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleDescenderProperty);
 }
 
 - (CGFloat)descender
 {
-  return _descender.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.descender; });
 }
 
 #pragma mark - ASAbsoluteLayoutElement
 
 - (void)setLayoutPosition:(CGPoint)layoutPosition
 {
-  _layoutPosition.store(layoutPosition);
+  ASLayoutElementStyleSetValues({
+    _values.layoutPosition = layoutPosition;
+  });
   ASLayoutElementStyleCallDelegate(ASLayoutElementStyleLayoutPositionProperty);
 }
 
 - (CGPoint)layoutPosition
 {
-  return _layoutPosition.load();
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.layoutPosition; });
 }
 
 #pragma mark - Extensions
@@ -517,48 +623,48 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 {
   NSCAssert(idx < kMaxLayoutElementBoolExtensions, @"Setting index outside of max bool extensions space");
   
-  ASDN::MutexLocker l(__instanceLock__);
-  _extensions.boolExtensions[idx] = value;
+  ASLayoutElementStyleSetValues({
+    _values.extensions.boolExtensions[idx] = value;
+  });
 }
 
 - (BOOL)layoutOptionExtensionBoolAtIndex:(int)idx\
 {
   NSCAssert(idx < kMaxLayoutElementBoolExtensions, @"Accessing index outside of max bool extensions space");
   
-  ASDN::MutexLocker l(__instanceLock__);
-  return _extensions.boolExtensions[idx];
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.extensions.boolExtensions[idx]; });
 }
 
 - (void)setLayoutOptionExtensionInteger:(NSInteger)value atIndex:(int)idx
 {
   NSCAssert(idx < kMaxLayoutElementStateIntegerExtensions, @"Setting index outside of max integer extensions space");
   
-  ASDN::MutexLocker l(__instanceLock__);
-  _extensions.integerExtensions[idx] = value;
+  ASLayoutElementStyleSetValues({
+    _values.extensions.integerExtensions[idx] = value;
+  });
 }
 
 - (NSInteger)layoutOptionExtensionIntegerAtIndex:(int)idx
 {
   NSCAssert(idx < kMaxLayoutElementStateIntegerExtensions, @"Accessing index outside of max integer extensions space");
   
-  ASDN::MutexLocker l(__instanceLock__);
-  return _extensions.integerExtensions[idx];
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.extensions.integerExtensions[idx]; });
 }
 
 - (void)setLayoutOptionExtensionEdgeInsets:(UIEdgeInsets)value atIndex:(int)idx
 {
   NSCAssert(idx < kMaxLayoutElementStateEdgeInsetExtensions, @"Setting index outside of max edge insets extensions space");
   
-  ASDN::MutexLocker l(__instanceLock__);
-  _extensions.edgeInsetsExtensions[idx] = value;
+  ASLayoutElementStyleSetValues({
+    _values.extensions.edgeInsetsExtensions[idx] = value;
+  });
 }
 
 - (UIEdgeInsets)layoutOptionExtensionEdgeInsetsAtIndex:(int)idx
 {
   NSCAssert(idx < kMaxLayoutElementStateEdgeInsetExtensions, @"Accessing index outside of max edge insets extensions space");
   
-  ASDN::MutexLocker l(__instanceLock__);
-  return _extensions.edgeInsetsExtensions[idx];
+  return ASLayoutElementStyleReadValues(_version, [&]{ return _values.extensions.edgeInsetsExtensions[idx]; });
 }
 
 #pragma mark - Debugging
@@ -755,6 +861,19 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 {
   if (_yogaNode == NULL) {
     _yogaNode = YGNodeNew();
+    // -propertyDidChange: only forwards changes to an existing node, so mirror everything that was set before it was
+    // created. From here on the node is kept in sync incrementally, and Yoga only dirties it for values that changed.
+    for (NSString *propertyName in @[ ASLayoutElementStyleWidthProperty, ASLayoutElementStyleMinWidthProperty,
+                                      ASLayoutElementStyleMaxWidthProperty, ASLayoutElementStyleHeightProperty,
+                                      ASLayoutElementStyleMinHeightProperty, ASLayoutElementStyleMaxHeightProperty,
+                                      ASLayoutElementStyleFlexGrowProperty, ASLayoutElementStyleFlexShrinkProperty,
+                                      ASLayoutElementStyleFlexBasisProperty, ASLayoutElementStyleAlignSelfProperty,
+                                      ASYogaFlexWrapProperty, ASYogaFlexDirectionProperty, ASYogaDirectionProperty,
+                                      ASYogaJustifyContentProperty, ASYogaAlignItemsProperty,
+                                      ASYogaPositionTypeProperty, ASYogaPositionProperty, ASYogaMarginProperty,
+                                      ASYogaPaddingProperty, ASYogaBorderProperty, ASYogaAspectRatioProperty ]) {
+      [self propertyDidChange:propertyName];
+    }
   }
   return _yogaNode;
 }
@@ -787,47 +906,69 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
 - (CGFloat)aspectRatio                        { return _aspectRatio.load(); }
 
 - (void)setFlexWrap:(YGWrap)flexWrap {
-  _flexWrap.store(flexWrap);
+  ASLayoutElementStyleSetValues({
+    _flexWrap.store(flexWrap);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaFlexWrapProperty);
 }
 - (void)setFlexDirection:(ASStackLayoutDirection)flexDirection {
-  _flexDirection.store(flexDirection);
+  ASLayoutElementStyleSetValues({
+    _flexDirection.store(flexDirection);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaFlexDirectionProperty);
 }
 - (void)setDirection:(YGDirection)direction {
-  _direction.store(direction);
+  ASLayoutElementStyleSetValues({
+    _direction.store(direction);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaDirectionProperty);
 }
 - (void)setJustifyContent:(ASStackLayoutJustifyContent)justify {
-  _justifyContent.store(justify);
+  ASLayoutElementStyleSetValues({
+    _justifyContent.store(justify);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaJustifyContentProperty);
 }
 - (void)setAlignItems:(ASStackLayoutAlignItems)alignItems {
-  _alignItems.store(alignItems);
+  ASLayoutElementStyleSetValues({
+    _alignItems.store(alignItems);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaAlignItemsProperty);
 }
 - (void)setPositionType:(YGPositionType)positionType {
-  _positionType.store(positionType);
+  ASLayoutElementStyleSetValues({
+    _positionType.store(positionType);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaPositionTypeProperty);
 }
 - (void)setPosition:(ASEdgeInsets)position {
-  _position.store(position);
+  ASLayoutElementStyleSetValues({
+    _position.store(position);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaPositionProperty);
 }
 - (void)setMargin:(ASEdgeInsets)margin {
-  _margin.store(margin);
+  ASLayoutElementStyleSetValues({
+    _margin.store(margin);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaMarginProperty);
 }
 - (void)setPadding:(ASEdgeInsets)padding {
-  _padding.store(padding);
+  ASLayoutElementStyleSetValues({
+    _padding.store(padding);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaPaddingProperty);
 }
 - (void)setBorder:(ASEdgeInsets)border {
-  _border.store(border);
+  ASLayoutElementStyleSetValues({
+    _border.store(border);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaBorderProperty);
 }
 - (void)setAspectRatio:(CGFloat)aspectRatio {
-  _aspectRatio.store(aspectRatio);
+  ASLayoutElementStyleSetValues({
+    _aspectRatio.store(aspectRatio);
+  });
   ASLayoutElementStyleCallDelegate(ASYogaAspectRatioProperty);
 }
 
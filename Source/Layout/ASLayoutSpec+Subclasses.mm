@@ -49,6 +49,12 @@
   return [ASLayout layoutWithLayoutElement:self size:CGSizeZero];
 }
 
+- (BOOL)adoptCachedLayoutsFromLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  // The null spec is a shared placeholder without any layout state of its own.
+  return layoutSpec == self;
+}
+
 @end
 
 
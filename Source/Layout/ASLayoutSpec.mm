@@ -21,6 +21,8 @@
 #import <AsyncDisplayKit/ASLayoutSpec+Subclasses.h>
 
 #import <AsyncDisplayKit/ASCollections.h>
+#import <AsyncDisplayKit/ASConfigurationInternal.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
 #import <AsyncDisplayKit/ASLayoutElementStylePrivate.h>
 #import <AsyncDisplayKit/ASTraitCollection.h>
 #import <AsyncDisplayKit/ASEqualityHelpers.h>
@@ -30,6 +32,53 @@
 #import <map>
 #import <vector>
 
+#pragma mark - ASLayoutSpecCachedLayout
+
+/// Parent sizes are often undefined (NaN), which must compare equal to itself.
+ASDISPLAYNODE_INLINE BOOL ASLayoutSpecParentDimensionsEqual(CGFloat lhs, CGFloat rhs)
+{
+  return lhs == rhs || (isnan(lhs) && isnan(rhs));
+}
+
+BOOL ASLayoutSpecCachedLayout::isValid(ASSizeRange theConstrainedSize, CGSize theParentSize, ASPrimitiveTraitCollection theTraitCollection, NSUInteger theDependencyVersion)
+{
+  return layout != nil
+      && dependencyVersion == theDependencyVersion
+      && ASLayoutSpecParentDimensionsEqual(parentSize.width, theParentSize.width)
+      && ASLayoutSpecParentDimensionsEqual(parentSize.height, theParentSize.height)
+      && ASSizeRangeEqualToSizeRange(constrainedSize, theConstrainedSize)
+      && ASPrimitiveTraitCollectionIsEqualToASPrimitiveTraitCollection(traitCollection, theTraitCollection);
+}
+
+NSUInteger ASLayoutSpecLayoutCache::indexOfValidLayout(ASSizeRange constrainedSize, CGSize parentSize, ASPrimitiveTraitCollection traitCollection, NSUInteger dependencyVersion)
+{
+  for (NSUInteger i = 0; i < layouts.size(); i++) {
+    if (layouts[i].isValid(constrainedSize, parentSize, traitCollection, dependencyVersion)) {
+      return i;
+    }
+  }
+  return NSNotFound;
+}
+
+void ASLayoutSpecLayoutCache::use(NSUInteger index, const ASLayoutSpecCachedLayout &layout)
+{
+  if (index == 0) {
+    return;
+  }
+  const NSUInteger last = (index == NSNotFound ? layouts.size() - 1 : index);
+  for (NSUInteger i = last; i > 0; i--) {
+    layouts[i] = layouts[i - 1];
+  }
+  layouts[0] = layout;
+}
+
+void ASLayoutSpecLayoutCache::shiftDependencyVersions(NSUInteger delta)
+{
+  for (auto &layout : layouts) {
+    layout.dependencyVersion += delta;
+  }
+}
+
 @implementation ASLayoutSpec
 
 // Dynamic properties for ASLayoutElements
@@ -85,7 +134,112 @@
 
 #pragma mark - Layout
 
-ASLayoutElementLayoutCalculationDefaults
+/**
+ * Sums up the style versions of the given layout spec and all layout specs within its subtree. Ascender and descender
+ * are ignored because specs write them during layout; they are restored from the cache instead.
+ */
+static NSUInteger ASLayoutSpecGetStyleVersion(ASLayoutSpec *layoutSpec)
+{
+  NSUInteger version = layoutSpec.style.versionIgnoringBaseline;
+  for (id<ASLayoutElement> child in layoutSpec->_childrenArray) {
+    if (ASLayoutSpec *childSpec = ASDynamicCast(child, ASLayoutSpec)) {
+      version += ASLayoutSpecGetStyleVersion(childSpec);
+    }
+  }
+  return version;
+}
+
+/**
+ * Sums up the layout and style versions of all display nodes within the subtree of the given layout spec, and the
+ * style versions of the spec itself and all layout specs within its subtree. All of them only ever increase, so for
+ * an unchanged tree the sum changes if and only if one of the elements was invalidated or restyled.
+ *
+ * @return NO if the subtree contains an element whose layout can't be tracked this way.
+ */
+static BOOL ASLayoutSpecGetDependencyVersion(ASLayoutSpec *layoutSpec, NSUInteger *version)
+{
+  *version += layoutSpec.style.versionIgnoringBaseline;
+  for (id<ASLayoutElement> child in layoutSpec->_childrenArray) {
+    if (ASLayoutSpec *childSpec = ASDynamicCast(child, ASLayoutSpec)) {
+      if (!ASLayoutSpecGetDependencyVersion(childSpec, version)) {
+        return NO;
+      }
+    } else if (ASDisplayNode *node = ASDynamicCast(child, ASDisplayNode)) {
+      *version += node.layoutVersion + node.style.version;
+    } else {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+- (ASLayout *)layoutThatFits:(ASSizeRange)constrainedSize
+{
+  return [self layoutThatFits:constrainedSize parentSize:constrainedSize.max];
+}
+
+- (ASLayout *)layoutThatFits:(ASSizeRange)constrainedSize parentSize:(CGSize)parentSize
+{
+  NSUInteger dependencyVersion = 0;
+  if (!ASActivateExperimentalFeature(ASExperimentalLayoutSpecCache)
+      || !ASLayoutSpecGetDependencyVersion(self, &dependencyVersion)) {
+    return [self calculateLayoutThatFits:constrainedSize restrictedToSize:self.style.size relativeToParentSize:parentSize];
+  }
+  
+  ASLayoutElementStyle *style = self.style;
+  ASPrimitiveTraitCollection traitCollection = self.primitiveTraitCollection;
+  ASLayoutSpecCachedLayout cachedLayout;
+  BOOL isEmpty;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    NSUInteger index = _layoutCache.indexOfValidLayout(constrainedSize, parentSize, traitCollection, dependencyVersion);
+    if (index != NSNotFound) {
+      cachedLayout = _layoutCache.layouts[index];
+      _layoutCache.use(index, cachedLayout);
+    }
+    isEmpty = _layoutCache.isEmpty();
+  }
+  
+  if (cachedLayout.layout != nil) {
+    // The ascender and descender are outputs of the calculation (see ASStackLayoutSpec) that parents may rely on.
+    if (style.ascender != cachedLayout.ascender) {
+      style.ascender = cachedLayout.ascender;
+    }
+    if (style.descender != cachedLayout.descender) {
+      style.descender = cachedLayout.descender;
+    }
+    return cachedLayout.layout;
+  }
+  
+  const CGFloat initialAscender = style.ascender;
+  const CGFloat initialDescender = style.descender;
+  ASLayout *layout = [self calculateLayoutThatFits:constrainedSize restrictedToSize:style.size relativeToParentSize:parentSize];
+  
+  cachedLayout.layout = layout;
+  cachedLayout.constrainedSize = constrainedSize;
+  cachedLayout.parentSize = parentSize;
+  cachedLayout.traitCollection = traitCollection;
+  cachedLayout.dependencyVersion = dependencyVersion;
+  cachedLayout.ascender = style.ascender;
+  cachedLayout.descender = style.descender;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    if (isEmpty) {
+      _layoutCache.initialAscender = initialAscender;
+      _layoutCache.initialDescender = initialDescender;
+    }
+    _layoutCache.use(NSNotFound, cachedLayout);
+  }
+  return layout;
+}
+
+- (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
+                     restrictedToSize:(ASLayoutElementSize)size
+                 relativeToParentSize:(CGSize)parentSize
+{
+  const ASSizeRange resolvedRange = ASSizeRangeIntersect(constrainedSize, ASLayoutElementSizeResolve(self.style.size, parentSize));
+  return [self calculateLayoutThatFits:resolvedRange];
+}
 
 - (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
 {
@@ -182,6 +336,60 @@ ASLayoutElementStyleExtensibilityForwarding
 
 #pragma mark - Framework Private
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  return NO;
+}
+
+- (BOOL)adoptCachedLayoutsFromLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  // A spec that is reused across layout passes may have been mutated in between, so its layouts can't be trusted.
+  if (layoutSpec == self) {
+    layoutSpec = nil;
+  }
+  
+  // Visit the whole subtree even if it already differs, so stale layouts of reused specs are always dropped.
+  NSArray<id<ASLayoutElement>> *previousChildren = layoutSpec ? layoutSpec->_childrenArray : nil;
+  BOOL equivalent = (layoutSpec != nil && _childrenArray.count == previousChildren.count);
+  NSUInteger i = 0;
+  for (id<ASLayoutElement> child in _childrenArray) {
+    id<ASLayoutElement> previousChild = (i < previousChildren.count) ? previousChildren[i] : nil;
+    if (ASLayoutSpec *childSpec = ASDynamicCast(child, ASLayoutSpec)) {
+      BOOL childEquivalent = [childSpec adoptCachedLayoutsFromLayoutSpec:ASDynamicCast(previousChild, ASLayoutSpec)];
+      equivalent = equivalent && childEquivalent;
+    } else {
+      equivalent = equivalent && (child == previousChild);
+    }
+    i += 1;
+  }
+  
+  ASLayoutSpecLayoutCache layoutCache;
+  if (equivalent) {
+    ASDN::MutexLocker l(layoutSpec->__instanceLock__);
+    layoutCache = layoutSpec->_layoutCache;
+  }
+  
+  // The cached ascender and descender are restored on reuse, which is only correct if the client configured the
+  // same baseline for both specs.
+  ASLayoutElementStyle *style = self.style;
+  equivalent = equivalent
+      && !layoutCache.isEmpty()
+      && [self isLayoutConfigurationEqualToLayoutSpec:layoutSpec]
+      && [style isEqualToStyleIgnoringBaseline:layoutSpec.style]
+      && style.ascender == layoutCache.initialAscender
+      && style.descender == layoutCache.initialDescender;
+  
+  // The nodes are shared between both trees but the specs are not, so the cached dependency versions are moved from
+  // the style versions of the previous specs to those of the receiver's. The styles are equal, see above.
+  if (equivalent) {
+    layoutCache.shiftDependencyVersions(ASLayoutSpecGetStyleVersion(self) - ASLayoutSpecGetStyleVersion(layoutSpec));
+  }
+  
+  ASDN::MutexLocker l(__instanceLock__);
+  _layoutCache = equivalent ? layoutCache : ASLayoutSpecLayoutCache();
+  return equivalent;
+}
+
 #if AS_DEDUPE_LAYOUT_SPEC_TREE
 - (nullable NSHashTable<id<ASLayoutElement>> *)findDuplicatedElementsInSubtree
 {
@@ -296,6 +504,11 @@ ASSynthesizeLockingMethodsWithMutex(__instanceLock__)
   return self;
 }
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  return ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASWrapperLayoutSpec class]);
+}
+
 - (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
 {
   NSArray *children = self.children;
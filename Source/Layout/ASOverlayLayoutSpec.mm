@@ -17,6 +17,7 @@
 
 #import <AsyncDisplayKit/ASOverlayLayoutSpec.h>
 #import <AsyncDisplayKit/ASLayoutSpec+Subclasses.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 #import <AsyncDisplayKit/ASAssert.h>
 
 static NSUInteger const kUnderlayChildIndex = 0;
@@ -69,6 +70,11 @@ static NSUInteger const kOverlayChildIndex = 1;
 
 #pragma mark - ASLayoutSpec
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  return ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASOverlayLayoutSpec class]);
+}
+
 /**
  First layout the contents, then fit the overlay on top of it.
  */
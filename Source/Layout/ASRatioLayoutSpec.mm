@@ -22,6 +22,7 @@
 #import <vector>
 
 #import <AsyncDisplayKit/ASLayoutSpec+Subclasses.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
@@ -62,6 +63,14 @@
   _ratio = ratio;
 }
 
+#pragma mark - ASLayoutSpec
+
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  return ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASRatioLayoutSpec class])
+      && _ratio == ((ASRatioLayoutSpec *)layoutSpec)->_ratio;
+}
+
 #pragma mark - ASLayoutElement
 
 - (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
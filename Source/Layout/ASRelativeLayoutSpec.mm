@@ -18,6 +18,7 @@
 #import <AsyncDisplayKit/ASRelativeLayoutSpec.h>
 
 #import <AsyncDisplayKit/ASLayoutSpec+Subclasses.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 
@@ -58,6 +59,17 @@
   _sizingOption = sizingOption;
 }
 
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  if (!ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASRelativeLayoutSpec class])) {
+    return NO;
+  }
+  ASRelativeLayoutSpec *relativeLayoutSpec = (ASRelativeLayoutSpec *)layoutSpec;
+  return _horizontalPosition == relativeLayoutSpec->_horizontalPosition
+      && _verticalPosition == relativeLayoutSpec->_verticalPosition
+      && _sizingOption == relativeLayoutSpec->_sizingOption;
+}
+
 - (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
 {
   // If we have a finite size in any direction, pass this so that the child can resolve percentages against it.
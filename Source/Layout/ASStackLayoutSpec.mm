@@ -20,10 +20,12 @@
 #import <numeric>
 #import <vector>
 
+#import <AsyncDisplayKit/ASCollections.h>
 #import <AsyncDisplayKit/ASDimension.h>
 #import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASLayoutElement.h>
 #import <AsyncDisplayKit/ASLayoutElementStylePrivate.h>
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
 #import <AsyncDisplayKit/ASLayoutSpecUtilities.h>
 #import <AsyncDisplayKit/ASLog.h>
 #import <AsyncDisplayKit/ASStackPositionedLayout.h>
@@ -144,10 +146,21 @@
   as_activity_scope_verbose(as_activity_create("Calculate stack layout", AS_ACTIVITY_CURRENT, OS_ACTIVITY_FLAG_DEFAULT));
   as_log_verbose(ASLayoutLog(), "Stack layout %@", self);
   // Accessing the style and size property is pretty costly we create layout spec children we use to figure
-  // out the layout for each child
+  // out the layout for each child. All style values are read in one snapshot.
   const auto stackChildren = AS::map(children, [&](const id<ASLayoutElement> child) -> ASStackLayoutSpecChild {
     ASLayoutElementStyle *style = child.style;
-    return {child, style, style.size};
+    const ASLayoutElementStyleValues values = style.values;
+    return {
+      .element = child,
+      .style = style,
+      .size = values.size,
+      .spacingBefore = values.spacingBefore,
+      .spacingAfter = values.spacingAfter,
+      .flexGrow = values.flexGrow,
+      .flexShrink = values.flexShrink,
+      .flexBasis = values.flexBasis,
+      .alignSelf = values.alignSelf
+    };
   });
   
   const ASStackLayoutSpecStyle style = {.direction = _direction, .spacing = _spacing, .justifyContent = _justifyContent, .alignItems = _alignItems, .flexWrap = _flexWrap, .alignContent = _alignContent, .lineSpacing = _lineSpacing};
@@ -160,12 +173,32 @@
     self.style.descender = stackChildren.back().style.descender;
   }
   
-  const auto sublayouts = [[NSMutableArray<ASLayout *> alloc] init];
+  // The engine works on the sizes and positions stored in the items, apply them to the layouts only now.
+  std::vector<ASLayout *> sublayouts;
+  sublayouts.reserve(positionedLayout.items.size());
   for (const auto &item : positionedLayout.items) {
-    [sublayouts addObject:item.layout];
+    ASLayout *sublayout = item.layout ?: [ASLayout layoutWithLayoutElement:item.child.element size:item.size];
+    sublayout.position = item.position;
+    sublayouts.push_back(sublayout);
   }
 
-  return [ASLayout layoutWithLayoutElement:self size:positionedLayout.size sublayouts:sublayouts];
+  NSArray<ASLayout *> *sublayoutsArray = [NSArray arrayByTransferring:sublayouts.data() count:sublayouts.size()];
+  return [ASLayout layoutWithLayoutElement:self size:positionedLayout.size sublayouts:sublayoutsArray];
+}
+
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec
+{
+  if (!ASLayoutSpecIsMemberOfClass(self, layoutSpec, [ASStackLayoutSpec class])) {
+    return NO;
+  }
+  ASStackLayoutSpec *stackLayoutSpec = (ASStackLayoutSpec *)layoutSpec;
+  return _direction == stackLayoutSpec->_direction
+      && _spacing == stackLayoutSpec->_spacing
+      && _justifyContent == stackLayoutSpec->_justifyContent
+      && _alignItems == stackLayoutSpec->_alignItems
+      && _flexWrap == stackLayoutSpec->_flexWrap
+      && _alignContent == stackLayoutSpec->_alignContent
+      && _lineSpacing == stackLayoutSpec->_lineSpacing;
 }
 
 - (void)resolveHorizontalAlignment
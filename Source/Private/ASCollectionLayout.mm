@@ -17,6 +17,7 @@
 
 #import <AsyncDisplayKit/ASCollectionLayout.h>
 
+#import <AsyncDisplayKit/_ASHierarchyChangeSet.h>
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASAbstractLayoutController.h>
 #import <AsyncDisplayKit/ASCellNode.h>
@@ -30,7 +31,6 @@
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
 #import <AsyncDisplayKit/ASElementMap.h>
 #import <AsyncDisplayKit/ASEqualityHelpers.h>
-#import <AsyncDisplayKit/ASPageTable.h>
 
 static const ASRangeTuningParameters kASDefaultMeasureRangeTuningParameters = {
   .leadingBufferScreenfuls = 2.0,
@@ -67,6 +67,13 @@ static const ASScrollDirection kASStaticScrollDirection = (ASScrollDirectionRigh
 #pragma mark - ASDataControllerLayoutDelegate
 
 - (ASCollectionLayoutContext *)layoutContextWithElements:(ASElementMap *)elements
+{
+  return [self layoutContextWithElements:elements previousElements:nil changeSet:nil];
+}
+
+- (ASCollectionLayoutContext *)layoutContextWithElements:(ASElementMap *)elements
+                                        previousElements:(ASElementMap *)previousElements
+                                               changeSet:(_ASHierarchyChangeSet *)changeSet
 {
   ASDisplayNodeAssertMainThread();
 
@@ -92,13 +99,20 @@ static const ASScrollDirection kASStaticScrollDirection = (ASScrollDirectionRigh
     additionalInfo = [_layoutDelegate additionalInfoForLayoutWithElements:elements];
   }
 
+  NSUInteger unchangedLeadingItemCount = 0;
+  NSUInteger unchangedTrailingItemCount = 0;
+  [changeSet getUnchangedLeadingItemCount:&unchangedLeadingItemCount trailingItemCount:&unchangedTrailingItemCount];
+
   return [[ASCollectionLayoutContext alloc] initWithViewportSize:viewportSize
                                             initialContentOffset:contentOffset
                                             scrollableDirections:scrollableDirections
                                                         elements:elements
                                              layoutDelegateClass:layoutDelegateClass
                                                      layoutCache:layoutCache
-                                                  additionalInfo:additionalInfo];
+                                                  additionalInfo:additionalInfo
+                                                previousElements:previousElements
+                                       unchangedLeadingItemCount:unchangedLeadingItemCount
+                                      unchangedTrailingItemCount:unchangedTrailingItemCount];
 }
 
 + (ASCollectionLayoutState *)calculateLayoutWithContext:(ASCollectionLayoutContext *)context
@@ -107,7 +121,10 @@ static const ASScrollDirection kASStaticScrollDirection = (ASScrollDirectionRigh
     return [[ASCollectionLayoutState alloc] initWithContext:context];
   }
 
-  ASCollectionLayoutState *layout = [context.layoutDelegateClass calculateLayoutWithContext:context];
+  ASCollectionLayoutState *layout = [ASCollectionLayout _updatedLayoutWithContext:context];
+  if (layout == nil) {
+    layout = [context.layoutDelegateClass calculateLayoutWithContext:context];
+  }
   [context.layoutCache setLayout:layout forContext:context];
 
   // Measure elements in the measure range ahead of time
@@ -146,6 +163,7 @@ static const ASScrollDirection kASStaticScrollDirection = (ASScrollDirectionRigh
     // A new layout is needed now. Calculate and apply it immediately
     _layout = [ASCollectionLayout calculateLayoutWithContext:context];
   }
+  [_layoutCache markLayoutAsCurrentForContext:context];
 }
 
 - (void)invalidateLayout
@@ -277,6 +295,39 @@ static const ASScrollDirection kASStaticScrollDirection = (ASScrollDirectionRigh
   return result;
 }
 
+/**
+ * Asks the layout delegate to update the cached layout of the elements the context's elements were updated from, if
+ * it can. Returns nil otherwise.
+ */
++ (ASCollectionLayoutState *)_updatedLayoutWithContext:(ASCollectionLayoutContext *)context
+{
+  Class<ASCollectionLayoutDelegate> layoutDelegateClass = context.layoutDelegateClass;
+  ASElementMap *previousElements = context.previousElements;
+  if (previousElements == nil
+      || (context.unchangedLeadingItemCount == 0 && context.unchangedTrailingItemCount == 0)
+      || ![layoutDelegateClass respondsToSelector:@selector(calculateLayoutWithContext:previousLayout:unchangedLeadingItemCount:unchangedTrailingItemCount:)]) {
+    return nil;
+  }
+
+  // The previous layout must have been calculated for the same viewport and additional info.
+  ASCollectionLayoutContext *previousContext = [[ASCollectionLayoutContext alloc] initWithViewportSize:context.viewportSize
+                                                                                  initialContentOffset:context.initialContentOffset
+                                                                                  scrollableDirections:context.scrollableDirections
+                                                                                              elements:previousElements
+                                                                                   layoutDelegateClass:layoutDelegateClass
+                                                                                           layoutCache:context.layoutCache
+                                                                                        additionalInfo:context.additionalInfo];
+  ASCollectionLayoutState *previousLayout = [context.layoutCache layoutForContext:previousContext];
+  if (previousLayout == nil) {
+    return nil;
+  }
+
+  return [layoutDelegateClass calculateLayoutWithContext:context
+                                          previousLayout:previousLayout
+                                unchangedLeadingItemCount:context.unchangedLeadingItemCount
+                               unchangedTrailingItemCount:context.unchangedTrailingItemCount];
+}
+
 /**
  * Measures all elements in the specified rect and blocks the calling thread while measuring those in the blocking rect.
  */
@@ -304,44 +355,30 @@ static const ASScrollDirection kASStaticScrollDirection = (ASScrollDirectionRigh
   }
 
   // Step 2: Get layout attributes of all elements within the specified outer rect
-  ASPageToLayoutAttributesTable *attrsTable = [layout getAndRemoveUnmeasuredLayoutAttributesPageTableInRect:rect];
-  if (attrsTable.count == 0) {
+  NSArray<UICollectionViewLayoutAttributes *> *attrsInRect = [layout getAndRemoveUnmeasuredLayoutAttributesInRect:rect];
+  if (attrsInRect.count == 0) {
     // No elements in this rect! Bail early
     return;
   }
 
   // Step 3: Split all those attributes into blocking and non-blocking buckets
-  // Use ordered sets here because some items may span multiple pages, and the sets will be accessed by indexes later on.
-  ASCollectionLayoutContext *context = layout.context;
-  CGSize pageSize = context.viewportSize;
-  NSMutableOrderedSet<UICollectionViewLayoutAttributes *> *blockingAttrs = hasBlockingRect ? [NSMutableOrderedSet orderedSet] : nil;
-  NSMutableOrderedSet<UICollectionViewLayoutAttributes *> *nonBlockingAttrs = [NSMutableOrderedSet orderedSet];
-  for (id pagePtr in attrsTable) {
-    ASPageCoordinate page = (ASPageCoordinate)pagePtr;
-    NSArray<UICollectionViewLayoutAttributes *> *attrsInPage = [attrsTable objectForPage:page];
-    // Calculate the page's rect but only if it's going to be used.
-    CGRect pageRect = hasBlockingRect ? ASPageCoordinateGetPageRect(page, pageSize) : CGRectZero;
-
-    if (hasBlockingRect && CGRectContainsRect(blockingRect, pageRect)) {
-      // The page fits well within the blocking rect. All attributes in this page are blocking.
-      [blockingAttrs addObjectsFromArray:attrsInPage];
-    } else if (hasBlockingRect && CGRectIntersectsRect(blockingRect, pageRect)) {
-      // The page intersects the blocking rect. Some elements in this page are blocking, some are not.
-      for (UICollectionViewLayoutAttributes *attrs in attrsInPage) {
-        if (CGRectIntersectsRect(blockingRect, attrs.frame)) {
-          [blockingAttrs addObject:attrs];
-        } else {
-          [nonBlockingAttrs addObject:attrs];
-        }
+  NSMutableArray<UICollectionViewLayoutAttributes *> *blockingAttrs = nil;
+  NSArray<UICollectionViewLayoutAttributes *> *nonBlockingAttrs = attrsInRect;
+  if (hasBlockingRect) {
+    blockingAttrs = [[NSMutableArray alloc] init];
+    let mutableNonBlockingAttrs = [[NSMutableArray<UICollectionViewLayoutAttributes *> alloc] init];
+    for (UICollectionViewLayoutAttributes *attrs in attrsInRect) {
+      if (CGRectIntersectsRect(blockingRect, attrs.frame)) {
+        [blockingAttrs addObject:attrs];
+      } else {
+        [mutableNonBlockingAttrs addObject:attrs];
       }
-    } else {
-      // The page doesn't intersect the blocking rect. All elements in this page are non-blocking.
-      [nonBlockingAttrs addObjectsFromArray:attrsInPage];
     }
+    nonBlockingAttrs = mutableNonBlockingAttrs;
   }
 
   // Step 4: Allocate and measure blocking elements' node
-  ASElementMap *elements = context.elements;
+  ASElementMap *elements = layout.context.elements;
   dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
   if (NSUInteger count = blockingAttrs.count) {
     ASDispatchApply(count, queue, 0, ^(size_t i) {
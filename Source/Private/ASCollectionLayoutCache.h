@@ -17,18 +17,65 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class ASCollectionLayoutContext, ASCollectionLayoutState;
 
-/// A thread-safe cache for ASCollectionLayoutContext-ASCollectionLayoutState pairs
+/// The default cost limit of layout caches, in bytes.
+AS_EXTERN NSUInteger const ASCollectionLayoutCacheDefaultCostLimit;
+
+/**
+ * A thread-safe cache for ASCollectionLayoutContext-ASCollectionLayoutState pairs.
+ *
+ * The cache evicts the least recently used layouts once the approximate memory cost of all cached layouts
+ * exceeds its cost limit, and drops layouts whose element maps no longer exist.
+ * It also trims itself when the application receives a memory warning.
+ *
+ * The current layout and the pending ones, i.e. those that were stored after it but not yet marked as current, are
+ * not evicted to stay within the cost limit. Updates are prepared ahead of the one on screen, and evicting their
+ * layouts would force the collection layout to calculate them again on the main thread. Layouts stored before the
+ * current one will not be applied anymore, so they are evictable. Memory warnings evict pending layouts too.
+ */
 AS_SUBCLASSING_RESTRICTED
 @interface ASCollectionLayoutCache : NSObject
 
+/// Creates a cache with ASCollectionLayoutCacheDefaultCostLimit.
+- (instancetype)init;
+
+- (instancetype)initWithCostLimit:(NSUInteger)costLimit NS_DESIGNATED_INITIALIZER;
+
+/// The maximum total cost of the cached layouts, in bytes. The current and pending layouts may exceed it.
+@property (readonly) NSUInteger costLimit;
+
+/// The approximate total cost of the cached layouts, in bytes.
+@property (readonly) NSUInteger totalCost;
+
+/// The number of lookups that found a layout.
+@property (readonly) NSUInteger hitCount;
+
+/// The number of lookups that didn't find a layout.
+@property (readonly) NSUInteger missCount;
+
+/// The number of layouts that were evicted to stay within the cost limit or because of a memory warning.
+@property (readonly) NSUInteger evictionCount;
+
 - (nullable ASCollectionLayoutState *)layoutForContext:(ASCollectionLayoutContext *)context;
 
 - (void)setLayout:(ASCollectionLayoutState *)layout forContext:(ASCollectionLayoutContext *)context;
 
+/**
+ * Marks the layout of the given context as the one on screen. Neither it nor the layouts stored before it are
+ * pending anymore, and the previous current layout becomes evictable.
+ */
+- (void)markLayoutAsCurrentForContext:(ASCollectionLayoutContext *)context;
+
 - (void)removeLayoutForContext:(ASCollectionLayoutContext *)context;
 
 - (void)removeAllLayouts;
 
+/**
+ * Evicts all layouts but the current one, including pending ones.
+ *
+ * @discussion The cache calls this itself when the application receives a memory warning.
+ */
+- (void)didReceiveMemoryWarning;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -12,37 +12,85 @@
 
 #import <AsyncDisplayKit/ASCollectionLayoutCache.h>
 
+#import <UIKit/UIApplication.h>
+
 #import <AsyncDisplayKit/ASCollectionLayoutContext.h>
 #import <AsyncDisplayKit/ASCollectionLayoutState.h>
+#import <AsyncDisplayKit/ASCollectionLayoutState+Private.h>
 #import <AsyncDisplayKit/ASElementMap.h>
 #import <AsyncDisplayKit/ASThread.h>
 
+#import <list>
+
+NSUInteger const ASCollectionLayoutCacheDefaultCostLimit = 8 * 1024 * 1024;
+
+namespace {
+  struct Entry {
+    ASCollectionLayoutContext *context;
+    ASCollectionLayoutState *layout;
+    NSUInteger cost;
+    // Increases with every store, so that entries stored before the current one can be told apart.
+    NSUInteger sequence;
+    // Stored, but not yet applied by the collection layout. Usually the layout of an update that is in flight.
+    bool pending;
+    // The layout that was applied last, i.e. the one on screen.
+    bool current;
+
+    bool isEvictable(bool evictPending) const { return !current && (evictPending || !pending); }
+  };
+}
+
 @implementation ASCollectionLayoutCache {
   ASDN::Mutex __instanceLock__;
 
   /**
-   * The underlying data structure of this cache.
+   * The underlying data structure of this cache, from the most to the least recently used entry.
    *
-   * The outer map table is a weak to strong table. That is because ASCollectionLayoutContext doesn't (and shouldn't) 
-   * hold a strong reference on its element map. As a result, this cache should handle the case in which 
-   * an element map no longer exists and all contexts and layouts associated with it should be cleared.
+   * ASCollectionLayoutContext doesn't (and shouldn't) hold a strong reference on its element map. As a result,
+   * this cache should handle the case in which an element map no longer exists and all contexts and layouts
+   * associated with it should be cleared. Such entries are dropped whenever they are walked past.
    *
-   * The inner map table is a standard strong to strong map.
-   * Since different ASCollectionLayoutContext objects with the same content are considered equal, 
-   * "object pointer personality" can't be used as a key option.
+   * Since different ASCollectionLayoutContext objects with the same content are considered equal, entries are
+   * found by equality. A collection layout only keeps a handful of layouts within the cost limit,
+   * so a linear search is cheaper than maintaining a hash table next to the list.
+   *
+   * The current and pending layouts are not evicted to stay within the cost limit. Evicting them would make the
+   * collection layout calculate them again, synchronously, once it applies them. A pending layout that was stored
+   * before the current one will never be applied, e.g. the one of a superseded update, so it stops being pending
+   * once a later layout becomes current.
    */
-  NSMapTable<ASElementMap *, NSMapTable<ASCollectionLayoutContext *, ASCollectionLayoutState *> *> *_map;
+  std::list<Entry> _entries;
+  NSUInteger _nextSequence;
+  NSUInteger _costLimit;
+  NSUInteger _totalCost;
+  NSUInteger _hitCount;
+  NSUInteger _missCount;
+  NSUInteger _evictionCount;
 }
 
 - (instancetype)init
+{
+  return [self initWithCostLimit:ASCollectionLayoutCacheDefaultCostLimit];
+}
+
+- (instancetype)initWithCostLimit:(NSUInteger)costLimit
 {
   self = [super init];
   if (self) {
-    _map = [NSMapTable mapTableWithKeyOptions:(NSMapTableWeakMemory | NSMapTableObjectPointerPersonality) valueOptions:NSMapTableStrongMemory];
+    _costLimit = costLimit;
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(didReceiveMemoryWarning)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
   }
   return self;
 }
 
+- (void)dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 - (ASCollectionLayoutState *)layoutForContext:(ASCollectionLayoutContext *)context
 {
   ASElementMap *elements = context.elements;
@@ -51,7 +99,14 @@
   }
 
   ASDN::MutexLocker l(__instanceLock__);
-  return [[_map objectForKey:elements] objectForKey:context];
+  let it = [self _findEntryForContext:context elements:elements];
+  if (it == _entries.end()) {
+    _missCount++;
+    return nil;
+  }
+  _hitCount++;
+  _entries.splice(_entries.begin(), _entries, it);
+  return it->layout;
 }
 
 - (void)setLayout:(ASCollectionLayoutState *)layout forContext:(ASCollectionLayoutContext *)context
@@ -62,12 +117,45 @@
   }
 
   ASDN::MutexLocker l(__instanceLock__);
-  var innerMap = [_map objectForKey:elements];
-  if (innerMap == nil) {
-    innerMap = [NSMapTable strongToStrongObjectsMapTable];
-    [_map setObject:innerMap forKey:elements];
+  bool current = false;
+  let it = [self _findEntryForContext:context elements:elements];
+  if (it != _entries.end()) {
+    current = it->current;
+    _totalCost -= it->cost;
+    _entries.erase(it);
   }
-  [innerMap setObject:layout forKey:context];
+
+  // Always store the newest layout, even if it exceeds the cost limit on its own.
+  NSUInteger cost = layout.cost;
+  _entries.push_front({context, layout, cost, _nextSequence++, true, current});
+  _totalCost += cost;
+  [self _evictEntriesUntilCost:_costLimit evictingPending:NO];
+}
+
+- (void)markLayoutAsCurrentForContext:(ASCollectionLayoutContext *)context
+{
+  ASElementMap *elements = context.elements;
+  if (elements == nil) {
+    return;
+  }
+
+  ASDN::MutexLocker l(__instanceLock__);
+  let it = [self _findEntryForContext:context elements:elements];
+  for (auto &entry : _entries) {
+    entry.current = false;
+  }
+  if (it != _entries.end()) {
+    it->current = true;
+    it->pending = false;
+    // Layouts stored before this one belong to older updates or contexts and won't be applied anymore.
+    let sequence = it->sequence;
+    for (auto &entry : _entries) {
+      if (entry.sequence < sequence) {
+        entry.pending = false;
+      }
+    }
+  }
+  [self _evictEntriesUntilCost:_costLimit evictingPending:NO];
 }
 
 - (void)removeLayoutForContext:(ASCollectionLayoutContext *)context
@@ -78,13 +166,94 @@
   }
 
   ASDN::MutexLocker l(__instanceLock__);
-  [[_map objectForKey:elements] removeObjectForKey:context];
+  let it = [self _findEntryForContext:context elements:elements];
+  if (it != _entries.end()) {
+    _totalCost -= it->cost;
+    _entries.erase(it);
+  }
 }
 
 - (void)removeAllLayouts
 {
   ASDN::MutexLocker l(__instanceLock__);
-  [_map removeAllObjects];
+  _entries.clear();
+  _totalCost = 0;
+}
+
+- (void)didReceiveMemoryWarning
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  [self _evictEntriesUntilCost:0 evictingPending:YES];
+}
+
+- (NSUInteger)costLimit
+{
+  return _costLimit;
+}
+
+- (NSUInteger)totalCost
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _totalCost;
+}
+
+- (NSUInteger)hitCount
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _hitCount;
+}
+
+- (NSUInteger)missCount
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _missCount;
+}
+
+- (NSUInteger)evictionCount
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _evictionCount;
+}
+
+#pragma mark - Private
+
+/**
+ * Returns the entry of the given context, or the end of the list. Drops the entries of dead element maps along the way.
+ *
+ * @precondition The instance lock is held.
+ */
+- (std::list<Entry>::iterator)_findEntryForContext:(ASCollectionLayoutContext *)context elements:(ASElementMap *)elements
+{
+  for (auto it = _entries.begin(); it != _entries.end();) {
+    ASElementMap *entryElements = it->context.elements;
+    if (entryElements == nil) {
+      _totalCost -= it->cost;
+      it = _entries.erase(it);
+    } else if (entryElements == elements && [it->context isEqualToContext:context]) {
+      return it;
+    } else {
+      ++it;
+    }
+  }
+  return _entries.end();
+}
+
+/**
+ * Evicts the least recently used entries until the total cost is at most the given cost or only the current entry
+ * and, unless evictPending is YES, the pending entries are left.
+ *
+ * @precondition The instance lock is held.
+ */
+- (void)_evictEntriesUntilCost:(NSUInteger)cost evictingPending:(BOOL)evictPending
+{
+  for (auto it = _entries.end(); _totalCost > cost && it != _entries.begin();) {
+    --it;
+    if (it->isEvictable(evictPending)) {
+      _totalCost -= it->cost;
+      it = _entries.erase(it);
+      _evictionCount++;
+    }
+  }
 }
 
 @end
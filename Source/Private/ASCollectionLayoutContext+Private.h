@@ -27,6 +27,15 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) Class<ASCollectionLayoutDelegate> layoutDelegateClass;
 @property (nonatomic, weak, readonly) ASCollectionLayoutCache *layoutCache;
 
+/// The elements an update produced the elements of this context from, if any. Its layout can be updated instead of calculated.
+@property (nonatomic, weak, readonly, nullable) ASElementMap *previousElements;
+
+/// The number of items at the start of the elements that are the same as at the start of the previous elements.
+@property (nonatomic, readonly) NSUInteger unchangedLeadingItemCount;
+
+/// The number of items at the end of the elements that are the same as at the end of the previous elements.
+@property (nonatomic, readonly) NSUInteger unchangedTrailingItemCount;
+
 - (instancetype)initWithViewportSize:(CGSize)viewportSize
                 initialContentOffset:(CGPoint)initialContentOffset
                 scrollableDirections:(ASScrollDirection)scrollableDirections
@@ -35,6 +44,17 @@ NS_ASSUME_NONNULL_BEGIN
                          layoutCache:(ASCollectionLayoutCache *)layoutCache
                       additionalInfo:(nullable id)additionalInfo;
 
+- (instancetype)initWithViewportSize:(CGSize)viewportSize
+                initialContentOffset:(CGPoint)initialContentOffset
+                scrollableDirections:(ASScrollDirection)scrollableDirections
+                            elements:(ASElementMap *)elements
+                 layoutDelegateClass:(Class<ASCollectionLayoutDelegate>)layoutDelegateClass
+                         layoutCache:(ASCollectionLayoutCache *)layoutCache
+                      additionalInfo:(nullable id)additionalInfo
+                    previousElements:(nullable ASElementMap *)previousElements
+           unchangedLeadingItemCount:(NSUInteger)unchangedLeadingItemCount
+          unchangedTrailingItemCount:(NSUInteger)unchangedTrailingItemCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
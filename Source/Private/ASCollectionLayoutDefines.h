@@ -13,11 +13,35 @@
 #import <UIKit/UIKit.h>
 
 #import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASCollectionLayoutState.h>
 #import <AsyncDisplayKit/ASDimension.h>
 #import <AsyncDisplayKit/ASScrollDirection.h>
 
+@class ASCollectionElement;
+@protocol ASLayoutElement;
+
 NS_ASSUME_NONNULL_BEGIN
 
+typedef id<ASLayoutElement> _Nonnull (^ASCollectionLayoutWrappingSpecBlock)(NSArray<ASCollectionElement *> *elements);
+
 AS_EXTERN ASSizeRange ASSizeRangeForCollectionLayoutThatFitsViewportSize(CGSize viewportSize, ASScrollDirection scrollableDirections) AS_WARN_UNUSED_RESULT;
 
+/**
+ * Updates a layout that wraps all items into lines across its only scrollable direction, like the flow and gallery
+ * layout delegates do. Items before the line of the first changed item keep their frames. Items from there up to the
+ * unchanged trailing items are laid out again, with the spec the block returns for them. The trailing items are
+ * shifted, if they still start a line. Otherwise they are laid out again as well.
+ *
+ * @param insets The insets around the lines.
+ *
+ * @return The updated layout, or nil if the layout can't be updated, e.g. because it scrolls in both directions.
+ */
+AS_EXTERN ASCollectionLayoutState * _Nullable ASCollectionLayoutStateByUpdatingWrappingLayout(ASCollectionLayoutContext *context,
+                                                                                            ASCollectionLayoutState *previousLayout,
+                                                                                            NSUInteger unchangedLeadingItemCount,
+                                                                                            NSUInteger unchangedTrailingItemCount,
+                                                                                            UIEdgeInsets insets,
+                                                                                            ASCollectionLayoutWrappingSpecBlock specBlock,
+                                                                                            ASCollectionLayoutStateGetElementBlock getElementBlock);
+
 NS_ASSUME_NONNULL_END
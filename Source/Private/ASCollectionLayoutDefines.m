@@ -12,6 +12,11 @@
 
 #import <AsyncDisplayKit/ASCollectionLayoutDefines.h>
 
+#import <AsyncDisplayKit/ASCollectionLayoutContext.h>
+#import <AsyncDisplayKit/ASElementMap.h>
+#import <AsyncDisplayKit/ASLayout.h>
+#import <AsyncDisplayKit/ASLayoutElement.h>
+
 ASSizeRange ASSizeRangeForCollectionLayoutThatFitsViewportSize(CGSize viewportSize, ASScrollDirection scrollableDirections)
 {
   ASSizeRange sizeRange = ASSizeRangeUnconstrained;
@@ -25,3 +30,243 @@ ASSizeRange ASSizeRangeForCollectionLayoutThatFitsViewportSize(CGSize viewportSi
   }
   return sizeRange;
 }
+
+#pragma mark - Wrapping layout updates
+
+static NSUInteger ASCollectionLayoutItemCount(ASElementMap *elements)
+{
+  NSUInteger count = 0;
+  NSInteger sectionCount = elements.numberOfSections;
+  for (NSInteger section = 0; section < sectionCount; section++) {
+    count += [elements numberOfItemsInSection:section];
+  }
+  return count;
+}
+
+/**
+ * Calls the block with the items at the given positions, counted in section order across sections.
+ */
+static void ASCollectionLayoutEnumerateItems(ASElementMap *elements, NSRange range, void(^block)(ASCollectionElement *element, NSIndexPath *indexPath))
+{
+  NSUInteger sectionStart = 0;
+  NSInteger sectionCount = elements.numberOfSections;
+  for (NSInteger section = 0; section < sectionCount && sectionStart < NSMaxRange(range); section++) {
+    NSUInteger sectionEnd = sectionStart + [elements numberOfItemsInSection:section];
+    for (NSUInteger position = MAX(sectionStart, range.location); position < MIN(sectionEnd, NSMaxRange(range)); position++) {
+      NSIndexPath *indexPath = [NSIndexPath indexPathForItem:(position - sectionStart) inSection:section];
+      block([elements elementForItemAtIndexPath:indexPath], indexPath);
+    }
+    sectionStart = sectionEnd;
+  }
+}
+
+static UICollectionViewLayoutAttributes *ASCollectionLayoutAttributesForItem(ASCollectionLayoutState *layout, NSUInteger position)
+{
+  __block UICollectionViewLayoutAttributes *result = nil;
+  ASCollectionLayoutEnumerateItems(layout.context.elements, NSMakeRange(position, 1), ^(ASCollectionElement *element, NSIndexPath *indexPath) {
+    result = [layout layoutAttributesForElement:element];
+  });
+  return result;
+}
+
+ASCollectionLayoutState *ASCollectionLayoutStateByUpdatingWrappingLayout(ASCollectionLayoutContext *context,
+                                                                         ASCollectionLayoutState *previousLayout,
+                                                                         NSUInteger unchangedLeadingItemCount,
+                                                                         NSUInteger unchangedTrailingItemCount,
+                                                                         UIEdgeInsets insets,
+                                                                         ASCollectionLayoutWrappingSpecBlock specBlock,
+                                                                         ASCollectionLayoutStateGetElementBlock getElementBlock)
+{
+  ASElementMap *elements = context.elements;
+  ASElementMap *previousElements = previousLayout.context.elements;
+  ASScrollDirection scrollableDirections = context.scrollableDirections;
+  BOOL vertical = ASScrollDirectionContainsVerticalDirection(scrollableDirections);
+  if (elements == nil || previousElements == nil || vertical == ASScrollDirectionContainsHorizontalDirection(scrollableDirections)) {
+    return nil;
+  }
+
+  NSUInteger count = ASCollectionLayoutItemCount(elements);
+  NSUInteger previousCount = ASCollectionLayoutItemCount(previousElements);
+  NSUInteger leadingCount = MIN(unchangedLeadingItemCount, MIN(count, previousCount));
+  NSUInteger trailingCount = MIN(unchangedTrailingItemCount, MIN(count, previousCount) - leadingCount);
+  if (count == 0 || (leadingCount == 0 && trailingCount == 0)) {
+    return nil;
+  }
+
+  // All items in a line start at the same position along the scrollable direction.
+  CGFloat (^lineOrigin)(CGRect) = ^CGFloat(CGRect frame) {
+    return vertical ? CGRectGetMinY(frame) : CGRectGetMinX(frame);
+  };
+
+  // Step 1: Find the start of the line the first changed item would go to. Everything before it stays as is.
+  NSUInteger firstPosition = 0;
+  CGFloat origin = vertical ? insets.top : insets.left;
+  if (leadingCount > 0) {
+    UICollectionViewLayoutAttributes *attrs = ASCollectionLayoutAttributesForItem(previousLayout, leadingCount - 1);
+    if (attrs == nil) {
+      return nil;
+    }
+    origin = lineOrigin(attrs.frame);
+    firstPosition = leadingCount - 1;
+    while (firstPosition > 0) {
+      attrs = ASCollectionLayoutAttributesForItem(previousLayout, firstPosition - 1);
+      if (attrs == nil) {
+        return nil;
+      }
+      if (lineOrigin(attrs.frame) != origin) {
+        break;
+      }
+      firstPosition--;
+    }
+  }
+
+  // Step 2: The trailing items can only be shifted if they start a line. Their first line is laid out again to check
+  // that it still does.
+  NSUInteger trailingPosition = count - trailingCount;
+  NSUInteger previousTrailingPosition = previousCount - trailingCount;
+  NSUInteger probeCount = 0;
+  CGFloat previousTrailingOrigin = 0;
+  if (trailingCount > 0) {
+    UICollectionViewLayoutAttributes *attrs = ASCollectionLayoutAttributesForItem(previousLayout, previousTrailingPosition);
+    if (attrs == nil) {
+      return nil;
+    }
+    previousTrailingOrigin = lineOrigin(attrs.frame);
+    BOOL startsLine = YES;
+    if (previousTrailingPosition > 0) {
+      UICollectionViewLayoutAttributes *previousAttrs = ASCollectionLayoutAttributesForItem(previousLayout, previousTrailingPosition - 1);
+      if (previousAttrs == nil) {
+        return nil;
+      }
+      startsLine = (lineOrigin(previousAttrs.frame) != previousTrailingOrigin);
+    }
+    if (startsLine) {
+      probeCount = 1;
+      while (probeCount < trailingCount) {
+        attrs = ASCollectionLayoutAttributesForItem(previousLayout, previousTrailingPosition + probeCount);
+        if (attrs == nil || lineOrigin(attrs.frame) != previousTrailingOrigin) {
+          break;
+        }
+        probeCount++;
+      }
+    }
+  }
+
+  // Step 3: Lay out the changed lines, at their place in the content.
+  ASSizeRange sizeRange = ASSizeRangeForCollectionLayoutThatFitsViewportSize(context.viewportSize, scrollableDirections);
+  CGFloat horizontalInsets = insets.left + insets.right;
+  CGFloat verticalInsets = insets.top + insets.bottom;
+  sizeRange.min = CGSizeMake(MAX(0, sizeRange.min.width - horizontalInsets), MAX(0, sizeRange.min.height - verticalInsets));
+  sizeRange.max = CGSizeMake(MAX(0, sizeRange.max.width - horizontalInsets), MAX(0, sizeRange.max.height - verticalInsets));
+  CGPoint offset = vertical ? CGPointMake(insets.left, origin) : CGPointMake(origin, insets.top);
+
+  __block ASLayout *layout;
+  NSMapTable<ASCollectionElement *, UICollectionViewLayoutAttributes *> *(^layoutItems)(NSUInteger) = ^(NSUInteger endPosition) {
+    NSMapTable<ASCollectionElement *, NSIndexPath *> *indexPaths = [NSMapTable mapTableWithKeyOptions:NSMapTableObjectPointerPersonality valueOptions:NSMapTableStrongMemory];
+    NSMutableArray<ASCollectionElement *> *children = [[NSMutableArray alloc] initWithCapacity:endPosition - firstPosition];
+    ASCollectionLayoutEnumerateItems(elements, NSMakeRange(firstPosition, endPosition - firstPosition), ^(ASCollectionElement *element, NSIndexPath *indexPath) {
+      [children addObject:element];
+      [indexPaths setObject:indexPath forKey:element];
+    });
+
+    layout = [specBlock(children) layoutThatFits:sizeRange];
+    NSMapTable *table = [NSMapTable elementToLayoutAttributesTable];
+    NSMutableArray<ASLayout *> *queue = [NSMutableArray arrayWithObject:layout];
+    NSMutableArray<NSValue *> *positions = [NSMutableArray arrayWithObject:[NSValue valueWithCGPoint:offset]];
+    for (NSUInteger i = 0; i < queue.count; i++) {
+      ASLayout *sublayout = queue[i];
+      CGPoint position = positions[i].CGPointValue;
+      ASCollectionElement *element = getElementBlock(sublayout);
+      NSIndexPath *indexPath = element ? [indexPaths objectForKey:element] : nil;
+      if (indexPath != nil) {
+        UICollectionViewLayoutAttributes *attrs = [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+        attrs.frame = (CGRect){ position, sublayout.size };
+        [table setObject:attrs forKey:element];
+        // Elements don't contain other elements.
+        continue;
+      }
+      for (ASLayout *child in sublayout.sublayouts) {
+        [queue addObject:child];
+        [positions addObject:[NSValue valueWithCGPoint:CGPointMake(position.x + child.position.x, position.y + child.position.y)]];
+      }
+    }
+    return table;
+  };
+
+  BOOL shiftsTrailingItems = (probeCount > 0);
+  NSMapTable<ASCollectionElement *, UICollectionViewLayoutAttributes *> *table = layoutItems(shiftsTrailingItems ? trailingPosition + probeCount : count);
+  CGFloat delta = 0;
+  if (shiftsTrailingItems) {
+    // The first line of the trailing items must have the same items at the same place across the line as before.
+    __block CGFloat trailingOrigin = 0;
+    __block BOOL sameLine = YES;
+    __block NSUInteger probeIndex = 0;
+    ASCollectionLayoutEnumerateItems(elements, NSMakeRange(trailingPosition, probeCount), ^(ASCollectionElement *element, NSIndexPath *indexPath) {
+      CGRect frame = [table objectForKey:element].frame;
+      CGRect previousFrame = [previousLayout layoutAttributesForElement:element].frame;
+      if (probeIndex == 0) {
+        trailingOrigin = lineOrigin(frame);
+      }
+      sameLine = sameLine && lineOrigin(frame) == trailingOrigin && (vertical ? CGRectGetMinX(frame) == CGRectGetMinX(previousFrame) : CGRectGetMinY(frame) == CGRectGetMinY(previousFrame));
+      probeIndex++;
+    });
+    if (trailingPosition > firstPosition) {
+      __block CGFloat lastOrigin = 0;
+      ASCollectionLayoutEnumerateItems(elements, NSMakeRange(trailingPosition - 1, 1), ^(ASCollectionElement *element, NSIndexPath *indexPath) {
+        lastOrigin = lineOrigin([table objectForKey:element].frame);
+      });
+      sameLine = sameLine && lastOrigin != trailingOrigin;
+    }
+    if (sameLine) {
+      delta = trailingOrigin - previousTrailingOrigin;
+    } else {
+      shiftsTrailingItems = NO;
+      table = layoutItems(count);
+    }
+  }
+
+  // Step 4: Put the unchanged items around the laid out ones.
+  __block BOOL missingAttributes = NO;
+  ASCollectionLayoutEnumerateItems(elements, NSMakeRange(0, firstPosition), ^(ASCollectionElement *element, NSIndexPath *indexPath) {
+    UICollectionViewLayoutAttributes *attrs = [previousLayout layoutAttributesForElement:element];
+    if (attrs == nil) {
+      missingAttributes = YES;
+      return;
+    }
+    [table setObject:attrs forKey:element];
+  });
+
+  CGSize contentSize;
+  if (shiftsTrailingItems) {
+    NSUInteger shiftedPosition = trailingPosition + probeCount;
+    ASCollectionLayoutEnumerateItems(elements, NSMakeRange(shiftedPosition, count - shiftedPosition), ^(ASCollectionElement *element, NSIndexPath *indexPath) {
+      UICollectionViewLayoutAttributes *attrs = [previousLayout layoutAttributesForElement:element];
+      if (attrs == nil) {
+        missingAttributes = YES;
+        return;
+      }
+      if (delta != 0 || ![attrs.indexPath isEqual:indexPath]) {
+        CGRect frame = attrs.frame;
+        attrs = [attrs copy];
+        attrs.indexPath = indexPath;
+        attrs.frame = CGRectOffset(frame, vertical ? 0 : delta, vertical ? delta : 0);
+      }
+      [table setObject:attrs forKey:element];
+    });
+    contentSize = previousLayout.contentSize;
+    if (vertical) {
+      contentSize.height += delta;
+    } else {
+      contentSize.width += delta;
+    }
+  } else if (vertical) {
+    contentSize = CGSizeMake(layout.size.width + horizontalInsets, origin + layout.size.height + insets.bottom);
+  } else {
+    contentSize = CGSizeMake(origin + layout.size.width + insets.right, layout.size.height + verticalInsets);
+  }
+
+  if (missingAttributes) {
+    return nil;
+  }
+  return [[ASCollectionLayoutState alloc] initWithContext:context contentSize:contentSize elementToLayoutAttributesTable:table];
+}
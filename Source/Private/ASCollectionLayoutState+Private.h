@@ -11,18 +11,22 @@
 //
 
 #import <AsyncDisplayKit/ASCollectionLayoutState.h>
-#import <AsyncDisplayKit/ASPageTable.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface ASCollectionLayoutState (Private)
 
+/**
+ * The approximate number of bytes taken by the layout attributes of this layout and the indexes over them.
+ */
+@property (readonly) NSUInteger cost;
+
 /**
  * Remove and returns layout attributes for unmeasured elements that intersect the specified rect
  *
  * @discussion This method is atomic and thread-safe
  */
-- (nullable ASPageToLayoutAttributesTable *)getAndRemoveUnmeasuredLayoutAttributesPageTableInRect:(CGRect)rect;
+- (nullable NSArray<UICollectionViewLayoutAttributes *> *)getAndRemoveUnmeasuredLayoutAttributesInRect:(CGRect)rect;
 
 @end
 
@@ -33,3 +33,16 @@ AS_EXTERN void ASDispatchApply(size_t iterationCount, dispatch_queue_t queue, NS
  * decides the system can't handle it. In reality this rarely happens.
  */
 AS_EXTERN void ASDispatchAsync(size_t iterationCount, dispatch_queue_t queue, NSUInteger threadCount, NS_NOESCAPE void(^work)(size_t i));
+
+/**
+ * Like ASDispatchApply, but safe to nest, e.g. for concurrent layout specs inside of concurrently laid out cells.
+ *
+ * The calling thread works through the iterations as well instead of just waiting. Helper threads are taken from a
+ * pool of one per active CPU that is shared by all callers, and a call that can't get any helpers (e.g. because it is
+ * nested in another one) runs on the calling thread. Calls with fewer than minimumConcurrentCount iterations always
+ * run on the calling thread.
+ *
+ * Note: work is never called after this returns, but a helper that starts late still retains it until it
+ * exits, so it is not a non-escaping block.
+ */
+AS_EXTERN void ASDispatchCooperativeApply(size_t iterationCount, dispatch_queue_t queue, size_t minimumConcurrentCount, void(^work)(size_t i));
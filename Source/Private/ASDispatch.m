@@ -57,3 +57,65 @@ void ASDispatchAsync(size_t iterationCount, dispatch_queue_t queue, NSUInteger t
   }
 };
 
+/**
+ * The number of helpers of ASDispatchCooperativeApply that are currently queued or running, across all callers.
+ */
+static atomic_size_t ASDispatchCooperativeHelperCount = ATOMIC_VAR_INIT(0);
+
+static BOOL ASDispatchReserveCooperativeHelper(size_t maxHelperCount) {
+  size_t helperCount = atomic_load(&ASDispatchCooperativeHelperCount);
+  while (helperCount < maxHelperCount) {
+    if (atomic_compare_exchange_weak(&ASDispatchCooperativeHelperCount, &helperCount, helperCount + 1)) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+void ASDispatchCooperativeApply(size_t iterationCount, dispatch_queue_t queue, size_t minimumConcurrentCount, void(^work)(size_t i)) {
+  if (iterationCount < MAX(minimumConcurrentCount, 2)) {
+    for (size_t i = 0; i < iterationCount; i++) {
+      work(i);
+    }
+    return;
+  }
+  
+  static size_t maxHelperCount;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    maxHelperCount = NSProcessInfo.processInfo.activeProcessorCount;
+  });
+  
+  __block atomic_size_t counter = ATOMIC_VAR_INIT(0);
+  __block atomic_size_t completedCount = ATOMIC_VAR_INIT(0);
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+  
+  for (size_t t = 0; t < iterationCount - 1 && ASDispatchReserveCooperativeHelper(maxHelperCount); t++) {
+    dispatch_async(queue, ^{
+      // If the helper starts late, the caller may have finished all the work already and returned. Then the helper
+      // only releases work and the counters.
+      size_t i;
+      while ((i = atomic_fetch_add(&counter, 1)) < iterationCount) {
+        work(i);
+        if (atomic_fetch_add(&completedCount, 1) + 1 == iterationCount) {
+          dispatch_semaphore_signal(semaphore);
+        }
+      }
+      atomic_fetch_sub(&ASDispatchCooperativeHelperCount, 1);
+    });
+  }
+  
+  BOOL completedLastIteration = NO;
+  size_t i;
+  while ((i = atomic_fetch_add(&counter, 1)) < iterationCount) {
+    work(i);
+    if (atomic_fetch_add(&completedCount, 1) + 1 == iterationCount) {
+      completedLastIteration = YES;
+    }
+  }
+  
+  // Only wait for iterations that helpers are running right now, never for helpers that haven't started yet.
+  if (completedLastIteration == NO) {
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+  }
+}
@@ -287,6 +287,12 @@ __unused static NSString * _Nonnull NSStringFromASHierarchyStateChange(ASHierarc
  */
 - (void)_layoutSublayouts;
 
+/**
+ * The current layout version of the node. It is incremented whenever the node's layout is invalidated and never
+ * decreases.
+ */
+@property (nonatomic, readonly) NSUInteger layoutVersion;
+
 @end
 
 @interface ASDisplayNode (ASLayoutTransitionInternal)
@@ -161,11 +161,19 @@ AS_EXTERN NSString * const ASRenderingEngineDidDisplayNodesScheduledBeforeTimest
   UIViewAnimationOptions _defaultLayoutTransitionOptions;
   
   ASLayoutSpecBlock _layoutSpecBlock;
+  
+  /// The layout spec of the last layout calculation. The next equivalent spec tree adopts its cached layouts.
+  /// This strongly retains the whole previous spec tree and its cached layouts until the next calculation replaces
+  /// it, which is the price of the reuse. Only set if ASExperimentalLayoutSpecCache is enabled.
+  ASLayoutSpec *_lastLayoutSpec;
 
   std::atomic<int32_t> _transitionID;
   
   std::atomic<int32_t> _pendingTransitionID;
   ASLayoutTransition *_pendingLayoutTransition;
+  /// A transition whose subnode operations are still being applied across frames.
+  /// Only set if ASExperimentalIncrementalLayoutTransitions is enabled.
+  ASLayoutTransition *_incrementalLayoutTransition;
   std::shared_ptr<ASDisplayNodeLayout> _calculatedDisplayNodeLayout;
   std::shared_ptr<ASDisplayNodeLayout> _pendingDisplayNodeLayout;
   
@@ -237,6 +245,8 @@ AS_EXTERN NSString * const ASRenderingEngineDidDisplayNodesScheduledBeforeTimest
   NSMutableArray<ASDisplayNode *> *_yogaChildren;
   __weak ASDisplayNode *_yogaParent;
   ASLayout *_yogaCalculatedLayout;
+  // The constrained size of the last Yoga pass calculated from this node as the root.
+  ASSizeRange _yogaRootConstrainedSize;
 #endif
   
   NSString *_debugName;
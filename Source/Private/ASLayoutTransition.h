@@ -95,6 +95,24 @@ AS_SUBCLASSING_RESTRICTED
  */
 - (void)applySubnodeRemovals;
 
+/**
+ * Applies the same subnode removals, insertions and moves as -commitTransition, in the same order, but spread over
+ * multiple CATransaction commits so that each one stays within a small time budget. The first chunk is applied
+ * immediately. Inserted and moved subnodes get their frame from the pending layout as they are added.
+ *
+ * @param completion Called on the main thread once every subnode operation has been applied.
+ *
+ * @discussion Must be called on the main thread. Use -finishIncrementalCommit to apply the remaining operations
+ * synchronously, e.g. before starting another transition on the same node.
+ */
+- (void)commitTransitionIncrementallyWithCompletion:(void(^)(void))completion;
+
+/**
+ * Synchronously applies the subnode operations an incremental commit has not applied yet. Does nothing if no
+ * incremental commit is in flight.
+ */
+- (void)finishIncrementalCommit;
+
 - (instancetype)init NS_UNAVAILABLE;
 - (instancetype)new NS_UNAVAILABLE;
 
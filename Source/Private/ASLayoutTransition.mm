@@ -23,6 +23,7 @@
 #import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h> // Required for _insertSubnode... / _removeFromSupernode.
 #import <AsyncDisplayKit/ASLog.h>
+#import <AsyncDisplayKit/ASRunLoopQueue.h>
 
 #import <queue>
 
@@ -60,6 +61,15 @@ static inline BOOL ASLayoutCanTransitionAsynchronous(ASLayout *layout) {
   return YES;
 }
 
+/**
+ * Time an incremental commit may spend applying subnode operations before yielding to the next CATransaction commit.
+ * A quarter of a 60 FPS frame leaves room for the layout and display work that follows in the same frame.
+ */
+static CFTimeInterval const kASLayoutTransitionIncrementalCommitBudget = 0.004;
+
+@interface ASLayoutTransition () <ASCATransactionQueueObserving>
+@end
+
 @implementation ASLayoutTransition {
   std::shared_ptr<ASDN::RecursiveMutex> __instanceLock__;
   
@@ -68,6 +78,13 @@ static inline BOOL ASLayoutCanTransitionAsynchronous(ASLayout *layout) {
   NSArray<ASDisplayNode *> *_removedSubnodes;
   std::vector<NSUInteger> _insertedSubnodePositions;
   std::vector<std::pair<ASDisplayNode *, NSUInteger>> _subnodeMoves;
+
+  // Incremental commit state. Only accessed on the main thread.
+  void (^_incrementalCommitCompletion)(void);
+  NSUInteger _appliedRemovalCount;
+  NSUInteger _appliedMoveRemovalCount;
+  NSUInteger _appliedInsertionCount;
+  NSUInteger _appliedMoveCount;
 }
 
 - (instancetype)initWithNode:(ASDisplayNode *)node
@@ -155,6 +172,125 @@ static inline BOOL ASLayoutCanTransitionAsynchronous(ASLayout *layout) {
   }
 }
 
+#pragma mark - Incremental Commit
+
+- (void)commitTransitionIncrementallyWithCompletion:(void(^)(void))completion
+{
+  ASDisplayNodeAssertMainThread();
+  ASDisplayNodeAssertNil(_incrementalCommitCompletion, @"An incremental commit is already in flight.");
+  _incrementalCommitCompletion = completion ?: ^{};
+  [self prepareForCATransactionCommit];
+}
+
+- (void)finishIncrementalCommit
+{
+  ASDisplayNodeAssertMainThread();
+  if (_incrementalCommitCompletion == nil) {
+    return;
+  }
+  [self applySubnodeOperationsUntilDeadline:INFINITY];
+  [self incrementalCommitDidFinish];
+}
+
+- (void)prepareForCATransactionCommit
+{
+  ASDisplayNodeAssertMainThread();
+  // The commit may have been finished synchronously since this chunk was scheduled.
+  if (_incrementalCommitCompletion == nil) {
+    return;
+  }
+
+  as_activity_create_for_scope("Apply incremental layout transition chunk");
+  if ([self applySubnodeOperationsUntilDeadline:CACurrentMediaTime() + kASLayoutTransitionIncrementalCommitBudget]) {
+    [self incrementalCommitDidFinish];
+    return;
+  }
+
+  // The queue applies enqueued objects right away while a commit is in progress, so hop to the next run loop turn
+  // before enqueueing the next chunk.
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [[ASCATransactionQueue sharedQueue] enqueue:self];
+  });
+}
+
+- (void)incrementalCommitDidFinish
+{
+  let completion = _incrementalCommitCompletion;
+  _incrementalCommitCompletion = nil;
+  completion();
+}
+
+/**
+ * Applies the subnode operations of -applySubnodeRemovals followed by -applySubnodeInsertionsAndMoves, resuming where
+ * the last call stopped. Always applies at least one operation.
+ *
+ * @return YES if every operation has been applied.
+ */
+- (BOOL)applySubnodeOperationsUntilDeadline:(CFTimeInterval)deadline
+{
+  ASDN::MutexSharedLocker l(__instanceLock__);
+  [self calculateSubnodeOperationsIfNeeded];
+
+  ASDisplayNode *node = _node;
+  if (node == nil) {
+    return YES;
+  }
+
+  ASLayout *pendingLayout = _pendingLayout->layout;
+  BOOL appliedOperation = NO;
+  let deadlinePassed = [&]{
+    return appliedOperation && CACurrentMediaTime() >= deadline;
+  };
+  let insertSubnode = [&](ASDisplayNode *subnode, NSUInteger index) {
+    [node _insertSubnode:subnode atIndex:index];
+    CGRect frame = [pendingLayout frameForElement:subnode];
+    if (!CGRectIsNull(frame)) {
+      subnode.frame = frame;
+    }
+    appliedOperation = YES;
+  };
+
+  BOOL automaticallyManagesSubnodes = node.automaticallyManagesSubnodes;
+  for (NSUInteger count = _removedSubnodes.count; _appliedRemovalCount < count; _appliedRemovalCount++) {
+    if (deadlinePassed()) {
+      return NO;
+    }
+    if (automaticallyManagesSubnodes) {
+      [_removedSubnodes[_appliedRemovalCount] _removeFromSupernodeIfEqualTo:node];
+    }
+    appliedOperation = YES;
+  }
+
+  for (; _appliedMoveRemovalCount < _subnodeMoves.size(); _appliedMoveRemovalCount++) {
+    if (deadlinePassed()) {
+      return NO;
+    }
+    [_subnodeMoves[_appliedMoveRemovalCount].first _removeFromSupernodeIfEqualTo:node];
+    appliedOperation = YES;
+  }
+
+  // Insert in ascending index order, exactly like -applySubnodeInsertionsAndMoves.
+  NSUInteger &i = _appliedInsertionCount;
+  NSUInteger &j = _appliedMoveCount;
+  while (i < _insertedSubnodePositions.size() || j < _subnodeMoves.size()) {
+    if (deadlinePassed()) {
+      return NO;
+    }
+    BOOL insertsNext = (j == _subnodeMoves.size()
+                        || (i < _insertedSubnodePositions.size() && _insertedSubnodePositions[i] < _subnodeMoves[j].second));
+    if (insertsNext) {
+      insertSubnode(_insertedSubnodes[i], _insertedSubnodePositions[i]);
+      i++;
+    } else {
+      insertSubnode(_subnodeMoves[j].first, _subnodeMoves[j].second);
+      j++;
+    }
+  }
+  return YES;
+}
+
+#pragma mark - Subnode Operations
+
 - (void)calculateSubnodeOperationsIfNeeded
 {
   ASDN::MutexSharedLocker l(__instanceLock__);
@@ -185,12 +321,13 @@ static inline BOOL ASLayoutCanTransitionAsynchronous(ASLayout *layout) {
 #else
     NSIndexSet *insertions, *deletions;
     NSArray<NSIndexPath *> *moves;
-    NSArray<ASDisplayNode *> *previousNodes = [previousLayout.sublayouts valueForKey:@"layoutElement"];
-    NSArray<ASDisplayNode *> *pendingNodes = [pendingLayout.sublayouts valueForKey:@"layoutElement"];
-    [previousNodes asdk_diffWithArray:pendingNodes
-                                       insertions:&insertions
-                                        deletions:&deletions
-                                            moves:&moves];
+    NSArray<ASDisplayNode *> *previousNodes = layoutElementsOfSublayouts(previousLayout);
+    NSArray<ASDisplayNode *> *pendingNodes = layoutElementsOfSublayouts(pendingLayout);
+    // Subnodes are distinct and compared by identity, so use the linear-time diff rather than the LCS-based one.
+    [previousNodes asdk_diffByIdentityWithArray:pendingNodes
+                                     insertions:&insertions
+                                      deletions:&deletions
+                                          moves:&moves];
 
     _insertedSubnodePositions = findNodesInLayoutAtIndexes(pendingLayout, insertions, &_insertedSubnodes);
     _removedSubnodes = [previousNodes objectsAtIndexes:deletions];
@@ -256,6 +393,16 @@ static inline BOOL ASLayoutCanTransitionAsynchronous(ASLayout *layout) {
 
 #pragma mark - Filter helpers
 
+static inline NSArray<ASDisplayNode *> *layoutElementsOfSublayouts(ASLayout *layout)
+{
+  NSArray<ASLayout *> *sublayouts = layout.sublayouts;
+  NSMutableArray<ASDisplayNode *> *layoutElements = [NSMutableArray arrayWithCapacity:sublayouts.count];
+  for (ASLayout *sublayout in sublayouts) {
+    [layoutElements addObject:(ASDisplayNode *)sublayout.layoutElement];
+  }
+  return layoutElements;
+}
+
 /**
  * @abstract Stores the nodes at the given indexes in the `storedNodes` array, storing indexes in a `storedPositions` c++ vector.
  */
@@ -35,6 +35,15 @@ AS_SUBCLASSING_RESTRICTED
 
 - (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements;
 
+/**
+ * Sections of items are shared with the given arrays and only copied when they are first modified. Unmodified sections
+ * keep their item index table (see ASElementMap), so copying the result back into an ASElementMap only indexes the
+ * sections that changed.
+ *
+ * @param itemIndexTables The item index table of each section, or NSNull if the section has none.
+ */
+- (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items itemIndexTables:(nullable NSArray *)itemIndexTables supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements;
+
 - (void)insertSection:(ASSection *)section atIndex:(NSInteger)index;
 
 - (void)removeAllSections;
@@ -65,6 +74,13 @@ AS_SUBCLASSING_RESTRICTED
 @end
 
 @interface ASElementMap (MutableCopying) <NSMutableCopying>
+
+/**
+ * Creates a map that reuses the given item index tables for the sections of items that are immutable. NSNull or
+ * missing tables are created.
+ */
+- (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items itemIndexTables:(nullable NSArray *)itemIndexTables supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -20,24 +20,40 @@
 #import <AsyncDisplayKit/ASCollectionElement.h>
 #import <AsyncDisplayKit/ASDataController.h>
 #import <AsyncDisplayKit/ASElementMap.h>
-#import <AsyncDisplayKit/ASTwoDimensionalArrayUtils.h>
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASInternalHelpers.h>
 #import <AsyncDisplayKit/NSIndexSet+ASHelpers.h>
 
-typedef NSMutableArray<NSMutableArray<ASCollectionElement *> *> ASMutableCollectionElementTwoDimensionalArray;
-
 typedef NSMutableDictionary<NSString *, NSMutableDictionary<NSIndexPath *, ASCollectionElement *> *> ASMutableSupplementaryElementDictionary;
 
 @implementation ASMutableElementMap {
   ASMutableSupplementaryElementDictionary *_supplementaryElements;
   NSMutableArray<ASSection *> *_sections;
-  ASMutableCollectionElementTwoDimensionalArray *_sectionsOfItems;
+  // Sections of items are shared with the source map until they are modified.
+  NSMutableArray<NSArray<ASCollectionElement *> *> *_sectionsOfItems;
+  // The item index table of each shared section of items, or NSNull.
+  NSMutableArray *_itemIndexTables;
+  // The sections of items that were copied by this map, and can be modified in place.
+  NSHashTable<NSMutableArray<ASCollectionElement *> *> *_ownedSectionsOfItems;
 }
 
 - (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements
+{
+  return [self initWithSections:sections items:items itemIndexTables:nil supplementaryElements:supplementaryElements];
+}
+
+- (instancetype)initWithSections:(NSArray<ASSection *> *)sections items:(ASCollectionElementTwoDimensionalArray *)items itemIndexTables:(NSArray *)itemIndexTables supplementaryElements:(ASSupplementaryElementDictionary *)supplementaryElements
 {
   if (self = [super init]) {
     _sections = [sections mutableCopy];
-    _sectionsOfItems = (id)ASTwoDimensionalArrayDeepMutableCopy(items);
+    // Copying an immutable array returns the same array, so this shares the sections of items and only copies mutable ones.
+    _sectionsOfItems = [[NSMutableArray alloc] initWithArray:items copyItems:YES];
+    _itemIndexTables = [[NSMutableArray alloc] initWithCapacity:items.count];
+    for (NSUInteger s = 0; s < items.count; s++) {
+      id table = itemIndexTables[s];
+      [_itemIndexTables addObject:(table && _sectionsOfItems[s] == items[s] ? table : [NSNull null])];
+    }
+    _ownedSectionsOfItems = [NSHashTable hashTableWithOptions:(NSHashTableStrongMemory | NSHashTableObjectPointerPersonality)];
     _supplementaryElements = [ASMutableElementMap deepMutableCopyOfElementsDictionary:supplementaryElements];
   }
   return self;
@@ -45,7 +61,7 @@ typedef NSMutableDictionary<NSString *, NSMutableDictionary<NSIndexPath *, ASCol
 
 - (id)copyWithZone:(NSZone *)zone
 {
-  return [[ASElementMap alloc] initWithSections:_sections items:_sectionsOfItems supplementaryElements:_supplementaryElements];
+  return [[ASElementMap alloc] initWithSections:_sections items:_sectionsOfItems itemIndexTables:_itemIndexTables supplementaryElements:_supplementaryElements];
 }
 
 - (void)removeAllSections
@@ -60,7 +76,25 @@ typedef NSMutableDictionary<NSString *, NSMutableDictionary<NSIndexPath *, ASCol
 
 - (void)removeItemsAtIndexPaths:(NSArray<NSIndexPath *> *)indexPaths
 {
-  ASDeleteElementsInTwoDimensionalArrayAtIndexPaths(_sectionsOfItems, indexPaths);
+#if ASDISPLAYNODE_ASSERTIONS_ENABLED
+  NSArray *sortedIndexPaths = [indexPaths sortedArrayUsingSelector:@selector(asdk_inverseCompare:)];
+  ASDisplayNodeAssert([sortedIndexPaths isEqualToArray:indexPaths], @"Expected array of index paths to be sorted in descending order.");
+#endif
+
+  for (NSIndexPath *indexPath in indexPaths) {
+    NSInteger section = indexPath.section;
+    if (section >= _sectionsOfItems.count) {
+      ASDisplayNodeFailAssert(@"Invalid section index %ld – only %ld sections", (long)section, (long)_sectionsOfItems.count);
+      continue;
+    }
+
+    NSInteger item = indexPath.item;
+    if (item >= _sectionsOfItems[section].count) {
+      ASDisplayNodeFailAssert(@"Invalid item index %ld – only %ld items in section %ld", (long)item, (long)_sectionsOfItems[section].count, (long)section);
+      continue;
+    }
+    [[self mutableItemsInSection:section] removeObjectAtIndex:item];
+  }
 }
 
 - (void)removeSectionsAtIndexes:(NSIndexSet *)indexes
@@ -76,18 +110,24 @@ typedef NSMutableDictionary<NSString *, NSMutableDictionary<NSIndexPath *, ASCol
 - (void)removeAllElements
 {
   [_sectionsOfItems removeAllObjects];
+  [_itemIndexTables removeAllObjects];
+  [_ownedSectionsOfItems removeAllObjects];
   [_supplementaryElements removeAllObjects];
 }
 
 - (void)removeSectionsOfItems:(NSIndexSet *)itemSections
 {
   [_sectionsOfItems removeObjectsAtIndexes:itemSections];
+  [_itemIndexTables removeObjectsAtIndexes:itemSections];
 }
 
 - (void)insertEmptySectionsOfItemsAtIndexes:(NSIndexSet *)sections
 {
   [sections enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL * _Nonnull stop) {
-    [_sectionsOfItems insertObject:[[NSMutableArray alloc] init]  atIndex:idx];
+    NSMutableArray *items = [[NSMutableArray alloc] init];
+    [_ownedSectionsOfItems addObject:items];
+    [_sectionsOfItems insertObject:items atIndex:idx];
+    [_itemIndexTables insertObject:[NSNull null] atIndex:idx];
   }];
 }
 
@@ -95,7 +135,7 @@ typedef NSMutableDictionary<NSString *, NSMutableDictionary<NSIndexPath *, ASCol
 {
   NSString *kind = element.supplementaryElementKind;
   if (kind == nil) {
-    [_sectionsOfItems[indexPath.section] insertObject:element atIndex:indexPath.item];
+    [[self mutableItemsInSection:indexPath.section] insertObject:element atIndex:indexPath.item];
   } else {
     NSMutableDictionary *supplementariesForKind = _supplementaryElements[kind];
     if (supplementariesForKind == nil) {
@@ -140,6 +180,21 @@ typedef NSMutableDictionary<NSString *, NSMutableDictionary<NSIndexPath *, ASCol
 
 #pragma mark - Helpers
 
+/**
+ * Returns the items of the given section, copying them first if they are still shared.
+ */
+- (NSMutableArray<ASCollectionElement *> *)mutableItemsInSection:(NSInteger)section
+{
+  NSMutableArray<ASCollectionElement *> *items = (NSMutableArray *)_sectionsOfItems[section];
+  if (![_ownedSectionsOfItems containsObject:items]) {
+    items = [items mutableCopy];
+    [_ownedSectionsOfItems addObject:items];
+    _sectionsOfItems[section] = items;
+    _itemIndexTables[section] = [NSNull null];
+  }
+  return items;
+}
+
 + (ASMutableSupplementaryElementDictionary *)deepMutableCopyOfElementsDictionary:(ASSupplementaryElementDictionary *)originalDict
 {
   NSMutableDictionary *deepCopy = [[NSMutableDictionary alloc] initWithCapacity:originalDict.count];
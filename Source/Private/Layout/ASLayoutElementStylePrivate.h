@@ -19,6 +19,25 @@
 
 #import <AsyncDisplayKit/ASObjectDescriptionHelpers.h>
 
+/**
+ * The layout values of an ASLayoutElementStyle, read in one go.
+ */
+typedef struct ASLayoutElementStyleValues {
+  /** The version of the style the values were read at. */
+  NSUInteger version;
+  ASLayoutElementSize size;
+  CGFloat spacingBefore;
+  CGFloat spacingAfter;
+  CGFloat flexGrow;
+  CGFloat flexShrink;
+  ASDimension flexBasis;
+  ASStackLayoutAlignSelf alignSelf;
+  CGFloat ascender;
+  CGFloat descender;
+  CGPoint layoutPosition;
+  ASLayoutElementStyleExtensions extensions;
+} ASLayoutElementStyleValues;
+
 @interface ASLayoutElementStyle () <ASDescriptionProvider>
 
 /**
@@ -33,4 +52,36 @@
  */
 @property (nonatomic, readonly) ASLayoutElementSize size;
 
+/**
+ * @abstract A counter that is incremented every time a property of the style changes.
+ *
+ * @discussion The version only ever increases, so layout caches can compare it to detect style changes cheaply.
+ * It doubles as the sequence of the lock-free reads of the style values: it is odd while a write is in progress.
+ */
+@property (nonatomic, readonly) NSUInteger version;
+
+/**
+ * @abstract The version without the increments of ascender and descender writes.
+ *
+ * @discussion Layout specs write their own ascender and descender during layout, so layout caches of specs compare
+ * this instead of the version.
+ */
+@property (nonatomic, readonly) NSUInteger versionIgnoringBaseline;
+
+/**
+ * @abstract A consistent snapshot of all layout values of the style and the version they belong to.
+ *
+ * @discussion Reading the snapshot doesn't take the style's lock, so layout code should prefer it over reading
+ * several properties one at a time.
+ */
+@property (nonatomic, readonly) ASLayoutElementStyleValues values;
+
+/**
+ * @abstract Returns whether all values that affect layout are equal to those of the given style, with the exception
+ * of ascender and descender.
+ *
+ * @discussion Layout specs compute their ascender and descender during layout, so they are compared separately.
+ */
+- (BOOL)isEqualToStyleIgnoringBaseline:(nullable ASLayoutElementStyle *)style;
+
 @end
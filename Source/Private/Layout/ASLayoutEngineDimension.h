@@ -0,0 +1,204 @@
+//
+//  ASLayoutEngineDimension.h
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#ifdef __OBJC__
+#import <AsyncDisplayKit/ASAssert.h>
+#define ASCoreAssert(condition, description) ASDisplayNodeCAssert(condition, @description)
+#else
+#include <cassert>
+#define ASCoreAssert(condition, description) assert((condition) && description)
+#endif
+
+/**
+ * The dimension math of the layout engine, in plain C++ so that it is shared by the framework (ASDimension.mm,
+ * ASDimensionInternal.mm) and the portable layout core in LayoutCore/.
+ *
+ * The functions are templated on the geometry types. They only need the fields the CoreGraphics structs have: a size
+ * has width and height, a point has x and y, a size range has min and max, a dimension has unit and value and an
+ * element size has width, height, minWidth, maxWidth, minHeight and maxHeight.
+ */
+namespace ASCore {
+
+/**
+ * Same values as ASDimensionUnit.
+ */
+enum class DimensionUnit {
+  /** This indicates a value that is automatically determined. */
+  Auto,
+  /** Just a number. It will always resolve to exactly this amount. */
+  Points,
+  /** Multiplied to a provided parent amount to resolve a final amount. */
+  Fraction,
+};
+
+/**
+ * Resolves the given dimension to a parent size. Auto dimensions resolve to autoSize.
+ */
+template <typename Dimension, typename Float>
+inline Float DimensionResolve(const Dimension &dimension, Float parentSize, Float autoSize)
+{
+  switch (static_cast<DimensionUnit>(dimension.unit)) {
+    case DimensionUnit::Auto:
+      return autoSize;
+    case DimensionUnit::Points:
+      return dimension.value;
+    case DimensionUnit::Fraction:
+      return dimension.value * parentSize;
+  }
+  return autoSize;
+}
+
+/**
+ * A size whose dimensions are both undefined, see ASLayoutElementParentSizeUndefined.
+ */
+template <typename Size>
+inline Size UndefinedParentSize()
+{
+  typedef decltype(std::declval<Size>().width) Float;
+  return {std::numeric_limits<Float>::quiet_NaN(), std::numeric_limits<Float>::quiet_NaN()};
+}
+
+/**
+ * The range from {0, 0} to {INFINITY, INFINITY}.
+ */
+template <typename SizeRange>
+inline SizeRange UnconstrainedSizeRange()
+{
+  return {{0, 0}, {INFINITY, INFINITY}};
+}
+
+/**
+ * MAX and MIN of Foundation. Unlike std::max and std::min they return the second value if the first one is NaN.
+ */
+template <typename Float>
+inline Float Max(Float a, Float b)
+{
+  return a > b ? a : b;
+}
+
+template <typename Float>
+inline Float Min(Float a, Float b)
+{
+  return a < b ? a : b;
+}
+
+/**
+ * Clamps the provided size to the range, see ASSizeRangeClamp.
+ */
+template <typename SizeRange, typename Size>
+inline Size SizeRangeClamp(const SizeRange &sizeRange, const Size &size)
+{
+  return {Max(sizeRange.min.width, Min(sizeRange.max.width, size.width)),
+          Max(sizeRange.min.height, Min(sizeRange.max.height, size.height))};
+}
+
+template <typename Float>
+struct DimensionRange {
+  Float min;
+  Float max;
+
+  /**
+   Intersects another dimension range. If the other range does not overlap, this size range "wins" by returning a
+   single point within its own range that is closest to the non-overlapping range.
+   */
+  DimensionRange intersect(const DimensionRange &other) const
+  {
+    const Float newMin = Max(min, other.min);
+    const Float newMax = Min(max, other.max);
+    if (newMin <= newMax) {
+      return {newMin, newMax};
+    } else {
+      // No intersection. If we're before the other range, return our max; otherwise our min.
+      if (min < other.min) {
+        return {max, max};
+      } else {
+        return {min, min};
+      }
+    }
+  }
+};
+
+/**
+ * Intersects another size range. If the other size range does not overlap in either dimension, this size range
+ * "wins" by returning a single point within its own range that is closest to the non-overlapping range.
+ */
+template <typename SizeRange>
+inline SizeRange SizeRangeIntersect(const SizeRange &sizeRange, const SizeRange &otherSizeRange)
+{
+  typedef DimensionRange<decltype(std::declval<SizeRange>().min.width)> Range;
+  const Range w = Range({sizeRange.min.width, sizeRange.max.width}).intersect({otherSizeRange.min.width, otherSizeRange.max.width});
+  const Range h = Range({sizeRange.min.height, sizeRange.max.height}).intersect({otherSizeRange.min.height, otherSizeRange.max.height});
+  return {{w.min, h.min}, {w.max, h.max}};
+}
+
+template <typename Float>
+inline void LayoutElementSizeConstrain(Float minVal, Float exactVal, Float maxVal, Float *outMin, Float *outMax)
+{
+  ASCoreAssert(!std::isnan(minVal), "minVal must not be NaN");
+  ASCoreAssert(!std::isnan(maxVal), "maxVal must not be NaN");
+  // Avoid use of min/max primitives since they're harder to reason
+  // about in the presence of NaN (in exactVal)
+  // Follow CSS: min overrides max overrides exact.
+
+  // Begin with the min/max range
+  *outMin = minVal;
+  *outMax = maxVal;
+  if (maxVal <= minVal) {
+    // min overrides max and exactVal is irrelevant
+    *outMax = minVal;
+    return;
+  }
+  if (std::isnan(exactVal)) {
+    // no exact value, so leave as a min/max range
+    return;
+  }
+  if (exactVal > maxVal) {
+    // clip to max value
+    *outMin = maxVal;
+  } else if (exactVal < minVal) {
+    // clip to min value
+    *outMax = minVal;
+  } else {
+    // use exact value
+    *outMin = *outMax = exactVal;
+  }
+}
+
+/**
+ * Resolves the given element size relative to a parent size and an auto size range, see
+ * ASLayoutElementSizeResolveAutoSize.
+ */
+template <typename ElementSize, typename Size, typename SizeRange>
+inline SizeRange LayoutElementSizeResolveAutoSize(const ElementSize &size, const Size &parentSize, const SizeRange &autoSizeRange)
+{
+  typedef decltype(std::declval<Size>().width) Float;
+  const Float nan = std::numeric_limits<Float>::quiet_NaN();
+  const Size resolvedExact = {DimensionResolve(size.width, parentSize.width, nan),
+                              DimensionResolve(size.height, parentSize.height, nan)};
+  const Size resolvedMin = {DimensionResolve(size.minWidth, parentSize.width, autoSizeRange.min.width),
+                            DimensionResolve(size.minHeight, parentSize.height, autoSizeRange.min.height)};
+  const Size resolvedMax = {DimensionResolve(size.maxWidth, parentSize.width, autoSizeRange.max.width),
+                            DimensionResolve(size.maxHeight, parentSize.height, autoSizeRange.max.height)};
+
+  Size rangeMin, rangeMax;
+  LayoutElementSizeConstrain(resolvedMin.width, resolvedExact.width, resolvedMax.width, &rangeMin.width, &rangeMax.width);
+  LayoutElementSizeConstrain(resolvedMin.height, resolvedExact.height, resolvedMax.height, &rangeMin.height, &rangeMax.height);
+  return {rangeMin, rangeMax};
+}
+
+} // namespace ASCore
@@ -15,8 +15,12 @@
 //      http://www.apache.org/licenses/LICENSE-2.0
 //
 
+#import <array>
+
+#import <AsyncDisplayKit/ASDimension.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 #import <AsyncDisplayKit/ASThread.h>
+#import <AsyncDisplayKit/ASTraitCollection.h>
 
 #if DEBUG
   #define AS_DEDUPE_LAYOUT_SPEC_TREE 1
@@ -26,13 +30,90 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class ASLayout;
+
+/*
+ * The result of a previous layout calculation of a layout spec, along with the inputs it was calculated for.
+ * Only used if ASExperimentalLayoutSpecCache is enabled.
+ */
+struct ASLayoutSpecCachedLayout {
+  ASLayout * _Nullable layout;
+  ASSizeRange constrainedSize;
+  CGSize parentSize;
+  ASPrimitiveTraitCollection traitCollection;
+  /// The sum of the layout and style versions of all display nodes within the spec's subtree and the style versions
+  /// of all specs within it, see ASLayoutSpecGetDependencyVersion.
+  NSUInteger dependencyVersion;
+  /// The spec's own ascender and descender after the calculation.
+  CGFloat ascender;
+  CGFloat descender;
+  
+  ASLayoutSpecCachedLayout()
+  : layout(nil), constrainedSize({{0, 0}, {0, 0}}), parentSize({0, 0}), traitCollection(ASPrimitiveTraitCollectionMakeDefault()),
+    dependencyVersion(0), ascender(0), descender(0) {};
+  
+  /*
+   * Returns whether this can be reused for the given constrained size, parent size, trait collection and
+   * dependency version
+   */
+  BOOL isValid(ASSizeRange constrainedSize, CGSize parentSize, ASPrimitiveTraitCollection traitCollection, NSUInteger dependencyVersion);
+};
+
+/*
+ * The most recent layouts of a layout spec. Specs that are flexed or stretched by their parent are laid out at two
+ * different sizes in every layout pass, so the last two layouts are kept, most recent first.
+ */
+struct ASLayoutSpecLayoutCache {
+  std::array<ASLayoutSpecCachedLayout, 2> layouts;
+  /// The spec's own ascender and descender before its first calculation, i.e. as configured by the client.
+  CGFloat initialAscender;
+  CGFloat initialDescender;
+  
+  ASLayoutSpecLayoutCache() : initialAscender(0), initialDescender(0) {};
+  
+  BOOL isEmpty() const { return layouts[0].layout == nil; }
+  
+  /*
+   * Returns the index of the layout that can be reused for the given inputs, or NSNotFound.
+   */
+  NSUInteger indexOfValidLayout(ASSizeRange constrainedSize, CGSize parentSize, ASPrimitiveTraitCollection traitCollection, NSUInteger dependencyVersion);
+  
+  /*
+   * Moves the layout at the given index to the front, or inserts a new one at the front if the index is NSNotFound.
+   */
+  void use(NSUInteger index, const ASLayoutSpecCachedLayout &layout);
+  
+  /*
+   * Adds the given delta to the dependency versions of all layouts. Unsigned overflow wraps around, so the delta
+   * may be "negative".
+   */
+  void shiftDependencyVersions(NSUInteger delta);
+};
+
 @interface ASLayoutSpec() {
   ASDN::RecursiveMutex __instanceLock__;
   std::atomic <ASPrimitiveTraitCollection> _primitiveTraitCollection;
   ASLayoutElementStyle *_style;
   NSMutableArray *_childrenArray;
+  ASLayoutSpecLayoutCache _layoutCache;
 }
 
+/**
+ * Returns whether the receiver would lay out its children exactly like the given layout spec does. Subclasses that
+ * add layout properties must override this and compare them. The default implementation returns NO, which opts the
+ * spec out of reusing cached layouts across layout passes.
+ */
+- (BOOL)isLayoutConfigurationEqualToLayoutSpec:(ASLayoutSpec *)layoutSpec;
+
+/**
+ * Takes over the cached layouts of a layout spec tree from a previous layout pass, for every subtree of the
+ * receiver that is equivalent to the corresponding subtree of the given spec. Cached layouts that can't be verified
+ * are dropped.
+ *
+ * @return YES if the whole subtree of the receiver is equivalent to the given layout spec and adopted its layouts.
+ */
+- (BOOL)adoptCachedLayoutsFromLayoutSpec:(nullable ASLayoutSpec *)layoutSpec;
+
 #if AS_DEDUPE_LAYOUT_SPEC_TREE
 /**
  * Recursively search the subtree for elements that occur more than once.
@@ -42,4 +123,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ * Returns whether both layout specs are instances of exactly the given class. Used by built-in specs to opt out of
+ * cross-pass layout caching for subclasses, which may have layout properties of their own.
+ */
+ASDISPLAYNODE_INLINE BOOL ASLayoutSpecIsMemberOfClass(ASLayoutSpec *lhs, ASLayoutSpec *rhs, Class c)
+{
+  return [lhs class] == c && [rhs class] == c;
+}
+
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,1151 @@
+//
+//  ASStackLayoutEngine.h
+//  Texture
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the /ASDK-Licenses directory of this source tree. An additional
+//  grant of patent rights can be found in the PATENTS file in the same directory.
+//
+//  Modifications to this file made after 4/13/2017 are: Copyright (c) 2017-present,
+//  Pinterest, Inc.  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "ASLayoutEngineDimension.h"
+
+/**
+ * The stack layout engine, in plain C++ so that it is shared by ASStackLayoutSpec and the portable layout core in
+ * LayoutCore/. It is templated on a traits type that adapts the children and layouts of either side:
+ *
+ *   struct Traits {
+ *     typedef ... Float, Size, Point, SizeRange; // CGFloat, CGSize, CGPoint and ASSizeRange in the framework
+ *     typedef ... Child;  // Has size, spacingBefore, spacingAfter, flexGrow, flexShrink, flexBasis and alignSelf
+ *     typedef ... Layout; // Value initialization gives an empty layout
+ *
+ *     static Layout layoutThatFits(const Child &child, const SizeRange &sizeRange, const Size &parentSize);
+ *     static Size layoutSize(const Layout &layout);
+ *     static Float ascender(const Child &child);
+ *     static Float descender(const Child &child);
+ *     static Float floorPixelValue(Float f);
+ *     // Calls work(i) for each i in [0, count), concurrently if allowed.
+ *     template <typename Work> static void apply(size_t count, bool concurrent, const Work &work);
+ *   };
+ *
+ * The style enums of either side must have the values of the enums below.
+ */
+namespace ASCore {
+
+/** Same values as ASStackLayoutDirection */
+enum class StackLayoutDirection {
+  Vertical,
+  Horizontal,
+};
+
+/** Same values as ASStackLayoutJustifyContent */
+enum class StackLayoutJustifyContent {
+  Start,
+  Center,
+  End,
+  SpaceBetween,
+  SpaceAround,
+};
+
+/** Same values as ASStackLayoutAlignItems */
+enum class StackLayoutAlignItems {
+  Start,
+  End,
+  Center,
+  Stretch,
+  BaselineFirst,
+  BaselineLast,
+  NotSet,
+};
+
+/** Same values as ASStackLayoutAlignSelf */
+enum class StackLayoutAlignSelf {
+  Auto,
+  Start,
+  End,
+  Center,
+  Stretch,
+};
+
+/** Same values as ASStackLayoutFlexWrap */
+enum class StackLayoutFlexWrap {
+  NoWrap,
+  Wrap,
+};
+
+/** Same values as ASStackLayoutAlignContent */
+enum class StackLayoutAlignContent {
+  Start,
+  Center,
+  End,
+  SpaceBetween,
+  SpaceAround,
+  Stretch,
+};
+
+/** The threshold that determines if a violation has actually occurred. */
+const double kViolationEpsilon = 0.01;
+
+template <typename Float>
+struct StackLayoutEngineStyle {
+  StackLayoutDirection direction;
+  Float spacing;
+  StackLayoutJustifyContent justifyContent;
+  StackLayoutAlignItems alignItems;
+  StackLayoutFlexWrap flexWrap;
+  StackLayoutAlignContent alignContent;
+  Float lineSpacing;
+};
+
+/**
+ * Converts a style with the same fields, e.g. ASStackLayoutSpecStyle, to the style the engine works with.
+ */
+template <typename Float, typename Style>
+inline StackLayoutEngineStyle<Float> StackLayoutEngineStyleMake(const Style &style)
+{
+  return {
+    static_cast<StackLayoutDirection>(style.direction),
+    style.spacing,
+    static_cast<StackLayoutJustifyContent>(style.justifyContent),
+    static_cast<StackLayoutAlignItems>(style.alignItems),
+    static_cast<StackLayoutFlexWrap>(style.flexWrap),
+    static_cast<StackLayoutAlignContent>(style.alignContent),
+    style.lineSpacing
+  };
+}
+
+template <typename Size>
+inline auto stackDimension(const StackLayoutDirection direction, const Size &size) -> decltype(size.width)
+{
+  return (direction == StackLayoutDirection::Vertical) ? size.height : size.width;
+}
+
+template <typename Size>
+inline auto crossDimension(const StackLayoutDirection direction, const Size &size) -> decltype(size.width)
+{
+  return (direction == StackLayoutDirection::Vertical) ? size.width : size.height;
+}
+
+template <typename Point, typename Float>
+inline Point directionPoint(const StackLayoutDirection direction, const Float stack, const Float cross)
+{
+  return (direction == StackLayoutDirection::Vertical) ? Point{cross, stack} : Point{stack, cross};
+}
+
+template <typename Size, typename Float>
+inline Size directionSize(const StackLayoutDirection direction, const Float stack, const Float cross)
+{
+  return (direction == StackLayoutDirection::Vertical) ? Size{cross, stack} : Size{stack, cross};
+}
+
+template <typename Point, typename Float>
+inline void setStackValueToPoint(const StackLayoutDirection direction, const Float stack, Point &point)
+{
+  (direction == StackLayoutDirection::Vertical) ? (point.y = stack) : (point.x = stack);
+}
+
+template <typename SizeRange, typename Float>
+inline SizeRange directionSizeRange(const StackLayoutDirection direction,
+                                    const Float stackMin,
+                                    const Float stackMax,
+                                    const Float crossMin,
+                                    const Float crossMax)
+{
+  typedef decltype(std::declval<SizeRange>().min) Size;
+  return {directionSize<Size>(direction, stackMin, crossMin), directionSize<Size>(direction, stackMax, crossMax)};
+}
+
+template <typename AlignSelf>
+inline StackLayoutAlignItems alignment(AlignSelf childAlignment, StackLayoutAlignItems stackAlignment)
+{
+  switch (static_cast<StackLayoutAlignSelf>(childAlignment)) {
+    case StackLayoutAlignSelf::Center:
+      return StackLayoutAlignItems::Center;
+    case StackLayoutAlignSelf::End:
+      return StackLayoutAlignItems::End;
+    case StackLayoutAlignSelf::Start:
+      return StackLayoutAlignItems::Start;
+    case StackLayoutAlignSelf::Stretch:
+      return StackLayoutAlignItems::Stretch;
+    case StackLayoutAlignSelf::Auto:
+    default:
+      return stackAlignment;
+  }
+}
+
+template <typename Traits>
+struct StackLayoutSpecItem {
+  /** The original source child. */
+  typename Traits::Child child;
+  /** The proposed layout or an empty one if none is calculated yet. */
+  typename Traits::Layout layout;
+  /** The size of the proposed layout. The engine reads this instead of asking the layout. */
+  typename Traits::Size size;
+  /** The position of the item within the stack. Only valid after the item has been positioned. */
+  typename Traits::Point position;
+};
+
+template <typename Traits>
+struct StackUnpositionedLine {
+  typedef typename Traits::Float Float;
+  /** The set of proposed children in this line, each contains child layout, not yet positioned. */
+  std::vector<StackLayoutSpecItem<Traits>> items;
+  /** The total size of the children in the stack dimension, including all spacing. */
+  Float stackDimensionSum;
+  /** The size in the cross dimension */
+  Float crossSize;
+  /** The baseline of the stack which baseline aligned children should align to */
+  Float baseline;
+};
+
+/** Represents a set of stack layout children that have their final layout computed, but are not yet positioned. */
+template <typename Traits>
+struct StackUnpositionedLayout {
+  typedef typename Traits::Float Float;
+  typedef typename Traits::Size Size;
+  typedef typename Traits::SizeRange SizeRange;
+  typedef typename Traits::Child Child;
+  typedef StackLayoutSpecItem<Traits> Item;
+  typedef StackUnpositionedLine<Traits> Line;
+  typedef StackLayoutEngineStyle<Float> Style;
+
+  /** The set of proposed lines, each contains child layouts, not yet positioned. */
+  const std::vector<Line> lines;
+  /**
+   * In a single line stack (e.g no wrap), this is the total size of the children in the stack dimension, including all spacing.
+   * In a multi-line stack, this is the largest stack dimension among lines.
+   */
+  const Float stackDimensionSum;
+  const Float crossDimensionSum;
+
+  /** Given a set of children, computes the unpositioned layouts for those children. */
+  template <typename PlatformStyle>
+  static StackUnpositionedLayout compute(const std::vector<Child> &children,
+                                         const PlatformStyle &platformStyle,
+                                         const SizeRange &sizeRange,
+                                         const bool concurrent)
+  {
+    if (children.empty()) {
+      return {{}, 0, 0};
+    }
+
+    const Style style = StackLayoutEngineStyleMake<Float>(platformStyle);
+
+    // If we have a fixed size in either dimension, pass it to children so they can resolve percentages against it.
+    // Otherwise, we pass an undefined dimension since it will depend on the content.
+    const Float undefinedDimension = UndefinedParentSize<Size>().width;
+    const Size parentSize = {
+      (sizeRange.min.width == sizeRange.max.width) ? sizeRange.min.width : undefinedDimension,
+      (sizeRange.min.height == sizeRange.max.height) ? sizeRange.min.height : undefinedDimension,
+    };
+
+    // We may be able to avoid some redundant layout passes
+    const bool optimizedFlexing = useOptimizedFlexing(children, style, sizeRange);
+
+    std::vector<Item> items;
+    items.reserve(children.size());
+    for (const auto &child : children) {
+      items.push_back({child, typename Traits::Layout(), Size(), typename Traits::Point()});
+    }
+
+    // We do a first pass of all the children, generating an unpositioned layout for each with an unbounded range along
+    // the stack dimension.  This allows us to compute the "intrinsic" size of each child and find the available violation
+    // which determines whether we must grow or shrink the flexible children.
+    layoutItemsAlongUnconstrainedStackDimension(items, style, concurrent, sizeRange, parentSize, optimizedFlexing);
+
+    // Collect items into lines (https://www.w3.org/TR/css-flexbox-1/#algo-line-break)
+    std::vector<Line> lines = collectChildrenIntoLines(items, style, sizeRange);
+
+    // Resolve the flexible lengths (https://www.w3.org/TR/css-flexbox-1/#resolve-flexible-lengths)
+    flexLinesAlongStackDimension(lines, style, concurrent, sizeRange, parentSize, optimizedFlexing);
+
+    // Calculate the cross size of each flex line (https://www.w3.org/TR/css-flexbox-1/#algo-cross-line)
+    computeLinesCrossSizeAndBaseline(lines, style, sizeRange);
+
+    // Handle 'align-content: stretch' (https://www.w3.org/TR/css-flexbox-1/#algo-line-stretch)
+    // Determine the used cross size of each item (https://www.w3.org/TR/css-flexbox-1/#algo-stretch)
+    stretchLinesAlongCrossDimension(lines, style, concurrent, sizeRange, parentSize);
+
+    // Compute stack dimension sum of each line and the whole stack
+    Float layoutStackDimensionSum = 0;
+    for (auto &line : lines) {
+      line.stackDimensionSum = computeItemsStackDimensionSum(line.items, style);
+      // layoutStackDimensionSum is the max stackDimensionSum among all lines
+      layoutStackDimensionSum = Max<Float>(line.stackDimensionSum, layoutStackDimensionSum);
+    }
+    // Compute cross dimension sum of the stack.
+    // This should be done before `lines` are moved to a new StackUnpositionedLayout struct (i.e `std::move(lines)`)
+    const Float layoutCrossDimensionSum = computeLinesCrossDimensionSum(lines, style);
+
+    return {std::move(lines), layoutStackDimensionSum, layoutCrossDimensionSum};
+  }
+
+  static Float baselineForItem(const Style &style, const Item &item)
+  {
+    // Ascender and descender are read from the child, not snapshotted, as children update them while being laid out.
+    switch (alignment(item.child.alignSelf, style.alignItems)) {
+      case StackLayoutAlignItems::BaselineFirst:
+        return Traits::ascender(item.child);
+      case StackLayoutAlignItems::BaselineLast:
+        return crossDimension(style.direction, item.size) + Traits::descender(item.child);
+      default:
+        return 0;
+    }
+  }
+
+  /**
+   Computes the violation by comparing a stack dimension sum with the overall allowable size range for the stack.
+
+   Violation is the distance you would have to add to the unbounded stack-direction length of the stack spec's
+   children in order to bring the stack within its allowed sizeRange.  The diagram below shows 3 horizontal stacks with
+   the different types of violation.
+
+                                            sizeRange
+                                         |------------|
+         +------+ +-------+ +-------+ +---------+
+         |      | |       | |       | |  |      |     |
+         |      | |       | |       | |         | (zero violation)
+         |      | |       | |       | |  |      |     |
+         +------+ +-------+ +-------+ +---------+
+                                         |            |
+         +------+ +-------+ +-------+
+         |      | |       | |       |    |            |
+         |      | |       | |       |<--> (positive violation)
+         |      | |       | |       |    |            |
+         +------+ +-------+ +-------+
+                                         |            |<------> (negative violation)
+         +------+ +-------+ +-------+ +---------+ +-----------+
+         |      | |       | |       | |  |      | |   |       |
+         |      | |       | |       | |         | |           |
+         |      | |       | |       | |  |      | |   |       |
+         +------+ +-------+ +-------+ +---------+ +-----------+
+
+   @param stackDimensionSum the consumed length of the children in the stack along the stack dimension
+   @param style layout style to be applied to all children
+   @param sizeRange the range of allowable sizes for the stack layout spec
+   */
+  static Float computeStackViolation(const Float stackDimensionSum, const Style &style, const SizeRange &sizeRange)
+  {
+    const Float minStackDimension = stackDimension(style.direction, sizeRange.min);
+    const Float maxStackDimension = stackDimension(style.direction, sizeRange.max);
+    if (stackDimensionSum < minStackDimension) {
+      return minStackDimension - stackDimensionSum;
+    } else if (stackDimensionSum > maxStackDimension) {
+      return maxStackDimension - stackDimensionSum;
+    }
+    return 0;
+  }
+
+  /**
+   Computes the violation by comparing a cross dimension sum with the overall allowable size range for the stack.
+
+   Violation is the distance you would have to add to the unbounded cross-direction length of the stack spec's
+   lines in order to bring the stack within its allowed sizeRange.  The diagram below shows 3 vertical stacks, each contains 3-5 vertical lines,
+   with the different types of violation.
+
+            Cross Dimension
+            +--------------------->
+                                                cross size range
+                                                |------------|
+            +--------+ +--------+ +--------+ +---------+  -  -  -  -  -  -  -  -
+   Vertical |Vertical| |Vertical| |Vertical| |Vertical |     |                 ^
+   Stack 1  | Line 1 | | Line 2 | | Line 3 | | Line 4  | (zero violation)      | stack size range
+            |        | |        | |        | |  |      |     |                 v
+            +--------+ +--------+ +--------+ +---------+  -  -  -  -  -  -  -  -
+                                                |            |
+            +--------+ +--------+ +--------+  -  -  -  -  -  -  -  -  -  -  -  -
+   Vertical |        | |        | |        |    |            |                 ^
+   Stack 2  |        | |        | |        |<--> (positive violation)          | stack size range
+            |        | |        | |        |    |            |                 v
+            +--------+ +--------+ +--------+  -  -  -  -  -  -  -  -  -  -  -  -
+                                                |            |<------> (negative violation)
+            +--------+ +--------+ +--------+ +---------+ +-----------+  -  -   -
+   Vertical |        | |        | |        | |  |      | |   |       |         ^
+   Stack 3  |        | |        | |        | |         | |           |         |  stack size range
+            |        | |        | |        | |  |      | |   |       |         v
+            +--------+ +--------+ +--------+ +---------+ +-----------+  -  -   -
+
+   @param crossDimensionSum the consumed length of the lines in the stack along the cross dimension
+   @param style layout style to be applied to all children
+   @param sizeRange the range of allowable sizes for the stack layout spec
+   */
+  static Float computeCrossViolation(const Float crossDimensionSum, const Style &style, const SizeRange &sizeRange)
+  {
+    const Float minCrossDimension = crossDimension(style.direction, sizeRange.min);
+    const Float maxCrossDimension = crossDimension(style.direction, sizeRange.max);
+    if (crossDimensionSum < minCrossDimension) {
+      return minCrossDimension - crossDimensionSum;
+    } else if (crossDimensionSum > maxCrossDimension) {
+      return maxCrossDimension - crossDimensionSum;
+    }
+    return 0;
+  }
+
+private:
+  static SizeRange resolvedChildSize(const Child &child)
+  {
+    return LayoutElementSizeResolveAutoSize(child.size, UndefinedParentSize<Size>(), UnconstrainedSizeRange<SizeRange>());
+  }
+
+  static Float resolveCrossDimensionMaxForStretchChild(const Style &style,
+                                                       const Child &child,
+                                                       const Float stackMax,
+                                                       const Float crossMax)
+  {
+    // stretched children may have a cross direction max that is smaller than the minimum size constraint of the parent.
+    const Float computedMax = (style.direction == StackLayoutDirection::Vertical ?
+                               resolvedChildSize(child).max.width :
+                               resolvedChildSize(child).max.height);
+    return computedMax == INFINITY ? crossMax : computedMax;
+  }
+
+  static Float resolveCrossDimensionMinForStretchChild(const Style &style,
+                                                       const Child &child,
+                                                       const Float stackMax,
+                                                       const Float crossMin)
+  {
+    // stretched children will have a cross dimension of at least crossMin, unless they explicitly define a child size
+    // that is smaller than the constraint of the parent.
+    const Float computedMin = (style.direction == StackLayoutDirection::Vertical ?
+                               resolvedChildSize(child).min.width :
+                               resolvedChildSize(child).min.height);
+    return computedMin != 0 ? computedMin : crossMin;
+  }
+
+  /**
+   Sizes the child of the item given the parameters specified, and stores the computed layout and its size in the item.
+   */
+  static void crossChildLayout(Item &item,
+                               const Style &style,
+                               const Float stackMin,
+                               const Float stackMax,
+                               const Float crossMin,
+                               const Float crossMax,
+                               const Size parentSize)
+  {
+    const Child &child = item.child;
+    const StackLayoutAlignItems alignItems = alignment(child.alignSelf, style.alignItems);
+    // stretched children will have a cross dimension of at least crossMin
+    const Float childCrossMin = (alignItems == StackLayoutAlignItems::Stretch ?
+                                 resolveCrossDimensionMinForStretchChild(style, child, stackMax, crossMin) :
+                                 0);
+    const Float childCrossMax = (alignItems == StackLayoutAlignItems::Stretch ?
+                                 resolveCrossDimensionMaxForStretchChild(style, child, stackMax, crossMax) :
+                                 crossMax);
+    const SizeRange childSizeRange = directionSizeRange<SizeRange>(style.direction, stackMin, stackMax, childCrossMin, childCrossMax);
+    item.layout = Traits::layoutThatFits(child, childSizeRange, parentSize);
+    item.size = Traits::layoutSize(item.layout);
+  }
+
+  /**
+   Computes the consumed cross dimension length for the given vector of lines and stacking style.
+
+            Cross Dimension
+            +--------------------->
+            +--------+ +--------+ +--------+ +---------+
+   Vertical |Vertical| |Vertical| |Vertical| |Vertical |
+   Stack    | Line 1 | | Line 2 | | Line 3 | | Line 4  |
+            |        | |        | |        | |         |
+            +--------+ +--------+ +--------+ +---------+
+                        crossDimensionSum
+            |------------------------------------------|
+
+   @param lines unpositioned lines
+   */
+  static Float computeLinesCrossDimensionSum(const std::vector<Line> &lines, const Style &style)
+  {
+    return std::accumulate(lines.begin(), lines.end(),
+                           // Start from default spacing between each line:
+                           lines.empty() ? 0 : style.lineSpacing * (lines.size() - 1),
+                           [&](Float x, const Line &l) {
+                             return x + l.crossSize;
+                           });
+  }
+
+  /**
+   Stretches children to lay out along the cross axis according to the alignment stretch settings of the children
+   (child.alignSelf), and the stack layout's alignment settings (style.alignItems).  This does not do the actual alignment
+   of the items once stretched though; StackPositionedLayout will do centering etc.
+
+   Finds the maximum cross dimension among child layouts.  If that dimension exceeds the minimum cross layout size then
+   we must stretch any children whose alignItems specify StackLayoutAlignItems::Stretch.
+
+   The diagram below shows 3 children in a horizontal stack.  The second child is larger than the minCrossDimension, so
+   its height is used as the childCrossMax.  Any children that are stretchable (which may be all children if
+   style.alignItems specifies stretch) like the first child must be stretched to match that maximum.  All children must be
+   at least minCrossDimension in cross dimension size, which is shown by the sizing of the third child.
+
+                   Stack Dimension
+                   +--------------------->
+                +  +-+-------------+-+-------------+--+---------------+  + + +
+                |    | child.      | |             |  |               |  | | |
+                |    | alignSelf   | |             |  |               |  | | |
+   Cross        |    | = stretch   | |             |  +-------+-------+  | | |
+   Dimension    |    +-----+-------+ |             |  |       |       |  | | |
+                |    |     |       | |             |          |          | | |
+                |          |         |             |  |       v       |  | | |
+                v  +-+- - - - - - -+-+ - - - - - - +--+- - - - - - - -+  | | + minCrossDimension
+                           |         |             |                     | |
+                     |     v       | |             |                     | |
+                     +- - - - - - -+ +-------------+                     | + childCrossMax
+                                                                         |
+                   +--------------------------------------------------+  + crossMax
+
+   @param items pre-computed items; modified in-place as needed
+   @param style the layout style of the overall stack layout
+   */
+  static void stretchItemsAlongCrossDimension(std::vector<Item> &items,
+                                              const Style &style,
+                                              const bool concurrent,
+                                              const Size parentSize,
+                                              const Float crossSize)
+  {
+    Traits::apply(items.size(), concurrent, [&](size_t i) {
+      auto &item = items[i];
+      const StackLayoutAlignItems alignItems = alignment(item.child.alignSelf, style.alignItems);
+      if (alignItems == StackLayoutAlignItems::Stretch) {
+        const Float cross = crossDimension(style.direction, item.size);
+        const Float stack = stackDimension(style.direction, item.size);
+        const Float violation = crossSize - cross;
+
+        // Only stretch if violation is positive. Compare against kViolationEpsilon here to avoid stretching against a tiny violation.
+        if (violation > kViolationEpsilon) {
+          crossChildLayout(item, style, stack, stack, crossSize, crossSize, parentSize);
+        }
+      }
+    });
+  }
+
+  /**
+   * Stretch lines and their items according to alignContent, alignItems and alignSelf.
+   * https://www.w3.org/TR/css-flexbox-1/#algo-line-stretch
+   * https://www.w3.org/TR/css-flexbox-1/#algo-stretch
+   */
+  static void stretchLinesAlongCrossDimension(std::vector<Line> &lines,
+                                              const Style &style,
+                                              const bool concurrent,
+                                              const SizeRange &sizeRange,
+                                              const Size parentSize)
+  {
+    ASCoreAssert(!lines.empty(), "A stack has at least one line");
+    const std::size_t numOfLines = lines.size();
+    const Float violation = computeCrossViolation(computeLinesCrossDimensionSum(lines, style), style, sizeRange);
+    // Don't stretch if the stack is single line, because the line's cross size was clamped against the stack's constrained size.
+    const bool shouldStretchLines = (numOfLines > 1
+                                     && style.alignContent == StackLayoutAlignContent::Stretch
+                                     && violation > kViolationEpsilon);
+
+    const Float extraCrossSizePerLine = violation / numOfLines;
+    for (auto &line : lines) {
+      if (shouldStretchLines) {
+        line.crossSize += extraCrossSizePerLine;
+      }
+
+      stretchItemsAlongCrossDimension(line.items, style, concurrent, parentSize, line.crossSize);
+    }
+  }
+
+  static bool itemIsBaselineAligned(const Style &style, const Item &l)
+  {
+    const StackLayoutAlignItems alignItems = alignment(l.child.alignSelf, style.alignItems);
+    return alignItems == StackLayoutAlignItems::BaselineFirst || alignItems == StackLayoutAlignItems::BaselineLast;
+  }
+
+  /**
+   * Computes cross size and baseline of each line.
+   * https://www.w3.org/TR/css-flexbox-1/#algo-cross-line
+   *
+   * @param lines All items to lay out
+   * @param style the layout style of the overall stack layout
+   * @param sizeRange the range of allowable sizes for the stack layout component
+   */
+  static void computeLinesCrossSizeAndBaseline(std::vector<Line> &lines,
+                                               const Style &style,
+                                               const SizeRange &sizeRange)
+  {
+    ASCoreAssert(!lines.empty(), "A stack has at least one line");
+    const bool isSingleLine = (lines.size() == 1);
+
+    const Float minCrossSize = crossDimension(style.direction, sizeRange.min);
+    const Float maxCrossSize = crossDimension(style.direction, sizeRange.max);
+    const bool definiteCrossSize = (minCrossSize == maxCrossSize);
+
+    // If the stack is single-line and has a definite cross size, the cross size of the line is the stack's definite cross size.
+    if (isSingleLine && definiteCrossSize) {
+      auto &line = lines[0];
+      line.crossSize = minCrossSize;
+
+      // We still need to determine the line's baseline
+      //TODO unit test
+      for (const auto &item : line.items) {
+        if (itemIsBaselineAligned(style, item)) {
+          const Float baseline = baselineForItem(style, item);
+          line.baseline = Max<Float>(line.baseline, baseline);
+        }
+      }
+
+      return;
+    }
+
+    for (auto &line : lines) {
+      const auto &items = line.items;
+      Float maxStartToBaselineDistance = 0;
+      Float maxBaselineToEndDistance = 0;
+      Float maxItemCrossSize = 0;
+
+      for (const auto &item : items) {
+        if (itemIsBaselineAligned(style, item)) {
+          // Step 1. Collect all the items whose align-self is baseline. Find the largest of the distances
+          // between each item’s baseline and its hypothetical outer cross-start edge (aka. its baseline value),
+          // and the largest of the distances between each item’s baseline and its hypothetical outer cross-end edge,
+          // and sum these two values.
+          const Float baseline = baselineForItem(style, item);
+          maxStartToBaselineDistance = Max<Float>(maxStartToBaselineDistance, baseline);
+          maxBaselineToEndDistance = Max<Float>(maxBaselineToEndDistance, crossDimension(style.direction, item.size) - baseline);
+        } else {
+          // Step 2. Among all the items not collected by the previous step, find the largest outer hypothetical cross size.
+          maxItemCrossSize = Max<Float>(maxItemCrossSize, crossDimension(style.direction, item.size));
+        }
+      }
+
+      // Step 3. The used cross-size of the flex line is the largest of the numbers found in the previous two steps and zero.
+      line.crossSize = Max<Float>(maxStartToBaselineDistance + maxBaselineToEndDistance, maxItemCrossSize);
+      if (isSingleLine) {
+        // If the stack is single-line, then clamp the line’s cross-size to be within the stack's min and max cross-size properties.
+        line.crossSize = Min<Float>(Max<Float>(minCrossSize, line.crossSize), maxCrossSize);
+      }
+
+      line.baseline = maxStartToBaselineDistance;
+    }
+  }
+
+  /**
+   Returns a lambda that computes the relevant flex factor based on the given violation.
+   @param violation The amount that the stack layout violates its size range.  See header for sign interpretation.
+   */
+  static std::function<Float(const Item &)> flexFactorInViolationDirection(const Float violation)
+  {
+    if (std::fabs(violation) < kViolationEpsilon) {
+      return [](const Item &item) { return (Float)0.0; };
+    } else if (violation > 0) {
+      return [](const Item &item) { return (Float)item.child.flexGrow; };
+    } else {
+      return [](const Item &item) { return (Float)item.child.flexShrink; };
+    }
+  }
+
+  static Float scaledFlexShrinkFactor(const Item &item, const Style &style, const Float flexFactorSum)
+  {
+    return stackDimension(style.direction, item.size) * (item.child.flexShrink / flexFactorSum);
+  }
+
+  /**
+   Returns a lambda that computes a flex shrink adjustment for a given item based on the provided violation.
+   @param items The unpositioned items from the original unconstrained layout pass.
+   @param style The layout style to be applied to all children.
+   @param violation The amount that the stack layout violates its size range.
+   @param flexFactorSum The sum of each item's flex factor as determined by the provided violation.
+   @return A lambda capable of computing the flex shrink adjustment, if any, for a particular item.
+   */
+  static std::function<Float(const Item &)> flexShrinkAdjustment(const std::vector<Item> &items,
+                                                                 const Style &style,
+                                                                 const Float violation,
+                                                                 const Float flexFactorSum)
+  {
+    const Float scaledFlexShrinkFactorSum = std::accumulate(items.begin(), items.end(), (Float)0.0, [&](Float x, const Item &item) {
+      return x + scaledFlexShrinkFactor(item, style, flexFactorSum);
+    });
+    return [style, scaledFlexShrinkFactorSum, violation, flexFactorSum](const Item &item) {
+      if (scaledFlexShrinkFactorSum == 0.0) {
+        return (Float)0.0;
+      }
+
+      const Float scaledFlexShrinkFactorRatio = scaledFlexShrinkFactor(item, style, flexFactorSum) / scaledFlexShrinkFactorSum;
+      // The item should shrink proportionally to the scaled flex shrink factor ratio computed above.
+      // Unlike the flex grow adjustment the flex shrink adjustment needs to take the size of each item into account.
+      return (Float)-std::fabs(scaledFlexShrinkFactorRatio * violation);
+    };
+  }
+
+  /**
+   Returns a lambda that computes a flex grow adjustment for a given item based on the provided violation.
+   @param items The unpositioned items from the original unconstrained layout pass.
+   @param violation The amount that the stack layout violates its size range.
+   @param flexFactorSum The sum of each item's flex factor as determined by the provided violation.
+   @return A lambda capable of computing the flex grow adjustment, if any, for a particular item.
+   */
+  static std::function<Float(const Item &)> flexGrowAdjustment(const std::vector<Item> &items,
+                                                               const Float violation,
+                                                               const Float flexFactorSum)
+  {
+    // To compute the flex grow adjustment distribute the violation proportionally based on each item's flex grow factor.
+    return [violation, flexFactorSum](const Item &item) {
+      return (Float)std::floor(violation * (item.child.flexGrow / flexFactorSum));
+    };
+  }
+
+  /**
+   Returns a lambda that computes a flex adjustment for a given item based on the provided violation.
+   @param items The unpositioned items from the original unconstrained layout pass.
+   @param style The layout style to be applied to all children.
+   @param violation The amount that the stack layout violates its size range.
+   @param flexFactorSum The sum of each item's flex factor as determined by the provided violation.
+   @return A lambda capable of computing the flex adjustment for a particular item.
+   */
+  static std::function<Float(const Item &)> flexAdjustmentInViolationDirection(const std::vector<Item> &items,
+                                                                               const Style &style,
+                                                                               const Float violation,
+                                                                               const Float flexFactorSum)
+  {
+    if (violation > 0) {
+      return flexGrowAdjustment(items, violation, flexFactorSum);
+    } else {
+      return flexShrinkAdjustment(items, style, violation, flexFactorSum);
+    }
+  }
+
+  static bool isFlexibleInBothDirections(const Child &child)
+  {
+    return child.flexGrow > 0 && child.flexShrink > 0;
+  }
+
+  /**
+   The flexible children may have been left not laid out in the initial layout pass, so we may have to go through and size
+   these children at zero size so that the children layouts are at least present.
+   */
+  static void layoutFlexibleChildrenAtZeroSize(std::vector<Item> &items,
+                                               const Style &style,
+                                               const bool concurrent,
+                                               const SizeRange &sizeRange,
+                                               const Size parentSize)
+  {
+    Traits::apply(items.size(), concurrent, [&](size_t i) {
+      auto &item = items[i];
+      if (isFlexibleInBothDirections(item.child)) {
+        crossChildLayout(item,
+                         style,
+                         0,
+                         0,
+                         crossDimension(style.direction, sizeRange.min),
+                         crossDimension(style.direction, sizeRange.max),
+                         parentSize);
+      }
+    });
+  }
+
+  /**
+   Computes the consumed stack dimension length for the given vector of items and stacking style.
+
+                stackDimensionSum
+            <----------------------->
+            +-----+  +-------+  +---+
+            |     |  |       |  |   |
+            |     |  |       |  |   |
+            +-----+  |       |  +---+
+                     +-------+
+
+   @param items unpositioned layouts for items
+   @param style the layout style of the overall stack layout
+   */
+  static Float computeItemsStackDimensionSum(const std::vector<Item> &items, const Style &style)
+  {
+    // Sum up the childrens' spacing
+    const Float childSpacingSum = std::accumulate(items.begin(), items.end(),
+                                                  // Start from default spacing between each child:
+                                                  items.empty() ? 0 : style.spacing * (items.size() - 1),
+                                                  [&](Float x, const Item &l) {
+                                                    return x + l.child.spacingBefore + l.child.spacingAfter;
+                                                  });
+
+    // Sum up the childrens' dimensions (including spacing) in the stack direction.
+    const Float childStackDimensionSum = std::accumulate(items.begin(), items.end(),
+                                                         childSpacingSum,
+                                                         [&](Float x, const Item &l) {
+                                                           return x + stackDimension(style.direction, l.size);
+                                                         });
+    return childStackDimensionSum;
+  }
+
+  /**
+   If we have a single flexible (both shrinkable and growable) child, and our allowed size range is set to a specific
+   number then we may avoid the first "intrinsic" size calculation.
+   */
+  static bool useOptimizedFlexing(const std::vector<Child> &children, const Style &style, const SizeRange &sizeRange)
+  {
+    const auto flexibleChildren = std::count_if(children.begin(), children.end(), isFlexibleInBothDirections);
+    return ((flexibleChildren == 1)
+            && (stackDimension(style.direction, sizeRange.min) ==
+                stackDimension(style.direction, sizeRange.max)));
+  }
+
+  /**
+   Flexes children in the stack axis to resolve a min or max stack size violation. First, determines which children are
+   flexible (see computeStackViolation and isFlexibleInViolationDirection). Then computes how much to flex each flexible child
+   and performs re-layout. Note that there may still be a non-zero violation even after flexing.
+
+   The actual CSS flexbox spec describes an iterative looping algorithm here, which may be adopted in t5837937:
+   http://www.w3.org/TR/css3-flexbox/#resolve-flexible-lengths
+
+   @param lines reference to unpositioned lines and items from the original, unconstrained layout pass; modified in-place
+   @param style layout style to be applied to all children
+   @param sizeRange the range of allowable sizes for the stack layout component
+   @param parentSize Size of the stack layout component. May be undefined in either or both directions.
+   */
+  static void flexLinesAlongStackDimension(std::vector<Line> &lines,
+                                           const Style &style,
+                                           const bool concurrent,
+                                           const SizeRange &sizeRange,
+                                           const Size parentSize,
+                                           const bool useOptimizedFlexing)
+  {
+    for (auto &line : lines) {
+      auto &items = line.items;
+      const Float violation = computeStackViolation(computeItemsStackDimensionSum(items, style), style, sizeRange);
+      std::function<Float(const Item &)> flexFactor = flexFactorInViolationDirection(violation);
+      // The flex factor sum is needed to determine if flexing is necessary.
+      // This value is also needed if the violation is positive and flexible items need to grow, so keep it around.
+      const Float flexFactorSum = std::accumulate(items.begin(), items.end(), (Float)0.0, [&](Float x, const Item &item) {
+        return x + flexFactor(item);
+      });
+
+      // If no items are able to flex then there is nothing left to do with this line. Bail.
+      if (flexFactorSum == 0) {
+        // If optimized flexing was used then we have to clean up the unsized items and lay them out at zero size.
+        if (useOptimizedFlexing) {
+          layoutFlexibleChildrenAtZeroSize(items, style, concurrent, sizeRange, parentSize);
+        }
+        continue;
+      }
+
+      std::function<Float(const Item &)> flexAdjustment = flexAdjustmentInViolationDirection(items,
+                                                                                             style,
+                                                                                             violation,
+                                                                                             flexFactorSum);
+      // Resolve the adjustment of every item once, the passes below only read the flat array.
+      std::vector<Float> flexAdjustments(items.size());
+      std::transform(items.begin(), items.end(), flexAdjustments.begin(), flexAdjustment);
+      const Float *adjustments = flexAdjustments.data();
+
+      // Compute any remaining violation to the first flexible item.
+      const Float remainingViolation = std::accumulate(flexAdjustments.begin(), flexAdjustments.end(), violation, std::minus<Float>());
+
+      // Items are consider inflexible if they do not need to make a flex adjustment.
+      const auto firstFlexAdjustment = std::find_if(flexAdjustments.begin(), flexAdjustments.end(), [](Float adjustment) {
+        return adjustment != 0;
+      });
+      if (firstFlexAdjustment == flexAdjustments.end()) {
+        continue;
+      }
+      const size_t firstFlexItem = firstFlexAdjustment - flexAdjustments.begin();
+
+      Traits::apply(items.size(), concurrent, [&](size_t i) {
+        auto &item = items[i];
+        const Float currentFlexAdjustment = adjustments[i];
+        // Items are consider inflexible if they do not need to make a flex adjustment.
+        if (currentFlexAdjustment != 0) {
+          const Float originalStackSize = stackDimension(style.direction, item.size);
+          // Only apply the remaining violation for the first flexible item that has a flex grow factor.
+          const Float flexedStackSize = originalStackSize + currentFlexAdjustment + (i == firstFlexItem && item.child.flexGrow > 0 ? remainingViolation : 0);
+          crossChildLayout(item,
+                           style,
+                           Max<Float>(flexedStackSize, 0),
+                           Max<Float>(flexedStackSize, 0),
+                           crossDimension(style.direction, sizeRange.min),
+                           crossDimension(style.direction, sizeRange.max),
+                           parentSize);
+        }
+      });
+    }
+  }
+
+  /**
+   https://www.w3.org/TR/css-flexbox-1/#algo-line-break
+   */
+  static std::vector<Line> collectChildrenIntoLines(std::vector<Item> &items,
+                                                    const Style &style,
+                                                    const SizeRange &sizeRange)
+  {
+    //TODO if infinite max stack size, fast path
+    if (style.flexWrap == StackLayoutFlexWrap::NoWrap) {
+      return std::vector<Line>(1, {std::move(items), 0, 0, 0});
+    }
+
+    std::vector<Line> lines;
+    std::vector<Item> lineItems;
+    Float lineStackDimensionSum = 0;
+    Float interitemSpacing = 0;
+
+    for (auto &item : items) {
+      const Float itemStackDimension = stackDimension(style.direction, item.size);
+      const Float itemAndSpacingStackDimension = item.child.spacingBefore + itemStackDimension + item.child.spacingAfter;
+      const bool negativeViolationIfAddItem = (computeStackViolation(lineStackDimensionSum + interitemSpacing + itemAndSpacingStackDimension, style, sizeRange) < 0);
+      const bool breakCurrentLine = negativeViolationIfAddItem && !lineItems.empty();
+
+      if (breakCurrentLine) {
+        lines.push_back({std::move(lineItems), 0, 0, 0});
+        lineItems.clear();
+        lineStackDimensionSum = 0;
+        interitemSpacing = 0;
+      }
+
+      lineItems.push_back(std::move(item));
+      lineStackDimensionSum += interitemSpacing + itemAndSpacingStackDimension;
+      interitemSpacing = style.spacing;
+    }
+
+    // Handle last line
+    lines.push_back({std::move(lineItems), 0, 0, 0});
+
+    return lines;
+  }
+
+  /**
+   Performs the first unconstrained layout of the children, generating the unpositioned items that are then flexed and
+   stretched.
+   */
+  static void layoutItemsAlongUnconstrainedStackDimension(std::vector<Item> &items,
+                                                          const Style &style,
+                                                          const bool concurrent,
+                                                          const SizeRange &sizeRange,
+                                                          const Size parentSize,
+                                                          const bool useOptimizedFlexing)
+  {
+    const Float minCrossDimension = crossDimension(style.direction, sizeRange.min);
+    const Float maxCrossDimension = crossDimension(style.direction, sizeRange.max);
+
+    Traits::apply(items.size(), concurrent, [&](size_t i) {
+      auto &item = items[i];
+      if (useOptimizedFlexing && isFlexibleInBothDirections(item.child)) {
+        // Leave the item unsized, it will be laid out during flexing.
+        item.layout = typename Traits::Layout();
+        item.size = Size();
+      } else {
+        crossChildLayout(item,
+                         style,
+                         DimensionResolve(item.child.flexBasis, stackDimension(style.direction, parentSize), (Float)0),
+                         DimensionResolve(item.child.flexBasis, stackDimension(style.direction, parentSize), (Float)INFINITY),
+                         minCrossDimension,
+                         maxCrossDimension,
+                         parentSize);
+      }
+    });
+  }
+};
+
+/** Represents a set of laid out and positioned stack layout children. */
+template <typename Traits>
+struct StackPositionedLayout {
+  typedef typename Traits::Float Float;
+  typedef typename Traits::Size Size;
+  typedef typename Traits::Point Point;
+  typedef typename Traits::SizeRange SizeRange;
+  typedef StackLayoutSpecItem<Traits> Item;
+  typedef StackUnpositionedLine<Traits> Line;
+  typedef StackUnpositionedLayout<Traits> UnpositionedLayout;
+  typedef StackLayoutEngineStyle<Float> Style;
+
+  /** The positioned items. The position of an item is stored in the item, not yet applied to its layout. */
+  const std::vector<Item> items;
+  /** Final size of the stack */
+  const Size size;
+
+  /** Given an unpositioned layout, computes the positions each child should be placed at. */
+  template <typename PlatformStyle>
+  static StackPositionedLayout compute(const UnpositionedLayout &layout,
+                                       const PlatformStyle &platformStyle,
+                                       const SizeRange &sizeRange)
+  {
+    const auto &lines = layout.lines;
+    if (lines.empty()) {
+      return {{}, Size()};
+    }
+
+    const Style style = StackLayoutEngineStyleMake<Float>(platformStyle);
+    const auto numOfLines = lines.size();
+    const auto direction = style.direction;
+    const auto alignContent = style.alignContent;
+    const auto lineSpacing = style.lineSpacing;
+    const auto justifyContent = style.justifyContent;
+    const auto crossViolation = UnpositionedLayout::computeCrossViolation(layout.crossDimensionSum, style, sizeRange);
+    Float crossOffset;
+    Float crossSpacing;
+    crossOffsetAndSpacingForEachLine(numOfLines, crossViolation, alignContent, crossOffset, crossSpacing);
+
+    std::vector<Item> positionedItems;
+    positionedItems.reserve(std::accumulate(lines.begin(), lines.end(), (size_t)0, [](size_t x, const Line &line) {
+      return x + line.items.size();
+    }));
+    Point p = directionPoint<Point, Float>(direction, 0, crossOffset);
+    bool first = true;
+    for (const auto &line : lines) {
+      if (!first) {
+        p = add(p, directionPoint<Point, Float>(direction, 0, crossSpacing + lineSpacing));
+      }
+      first = false;
+
+      const auto &items = line.items;
+      const auto stackViolation = UnpositionedLayout::computeStackViolation(line.stackDimensionSum, style, sizeRange);
+      Float stackOffset;
+      Float stackSpacing;
+      stackOffsetAndSpacingForEachItem(items.size(), stackViolation, justifyContent, stackOffset, stackSpacing);
+
+      setStackValueToPoint(direction, stackOffset, p);
+      positionItemsInLine(line, style, p, stackSpacing, positionedItems);
+
+      p = add(p, directionPoint<Point, Float>(direction, -stackOffset, line.crossSize));
+    }
+
+    const Size finalSize = directionSize<Size>(direction, layout.stackDimensionSum, layout.crossDimensionSum);
+    return {std::move(positionedItems), SizeRangeClamp(sizeRange, finalSize)};
+  }
+
+private:
+  static Point add(const Point &p1, const Point &p2)
+  {
+    return {p1.x + p2.x, p1.y + p2.y};
+  }
+
+  static Float crossOffsetForItem(const Item &item,
+                                  const Style &style,
+                                  const Float crossSize,
+                                  const Float baseline)
+  {
+    switch (alignment(item.child.alignSelf, style.alignItems)) {
+      case StackLayoutAlignItems::End:
+        return crossSize - crossDimension(style.direction, item.size);
+      case StackLayoutAlignItems::Center:
+        return Traits::floorPixelValue((crossSize - crossDimension(style.direction, item.size)) / 2);
+      case StackLayoutAlignItems::BaselineFirst:
+      case StackLayoutAlignItems::BaselineLast:
+        return baseline - UnpositionedLayout::baselineForItem(style, item);
+      case StackLayoutAlignItems::Start:
+      case StackLayoutAlignItems::Stretch:
+      case StackLayoutAlignItems::NotSet:
+        return 0;
+    }
+    return 0;
+  }
+
+  static void crossOffsetAndSpacingForEachLine(const std::size_t numOfLines,
+                                               const Float crossViolation,
+                                               StackLayoutAlignContent alignContent,
+                                               Float &offset,
+                                               Float &spacing)
+  {
+    ASCoreAssert(numOfLines > 0, "A stack has at least one line");
+
+    // Handle edge cases
+    if (alignContent == StackLayoutAlignContent::SpaceBetween && (crossViolation < kViolationEpsilon || numOfLines == 1)) {
+      alignContent = StackLayoutAlignContent::Start;
+    } else if (alignContent == StackLayoutAlignContent::SpaceAround && (crossViolation < kViolationEpsilon || numOfLines == 1)) {
+      alignContent = StackLayoutAlignContent::Center;
+    }
+
+    offset = 0;
+    spacing = 0;
+
+    switch (alignContent) {
+      case StackLayoutAlignContent::Center:
+        offset = crossViolation / 2;
+        break;
+      case StackLayoutAlignContent::End:
+        offset = crossViolation;
+        break;
+      case StackLayoutAlignContent::SpaceBetween:
+        // Spacing between the items, no spaces at the edges, evenly distributed
+        spacing = crossViolation / (numOfLines - 1);
+        break;
+      case StackLayoutAlignContent::SpaceAround: {
+        // Spacing between items are twice the spacing on the edges
+        const Float spacingUnit = crossViolation / (numOfLines * 2);
+        offset = spacingUnit;
+        spacing = spacingUnit * 2;
+        break;
+      }
+      case StackLayoutAlignContent::Start:
+      case StackLayoutAlignContent::Stretch:
+        break;
+    }
+  }
+
+  static void stackOffsetAndSpacingForEachItem(const std::size_t numOfItems,
+                                               const Float stackViolation,
+                                               StackLayoutJustifyContent justifyContent,
+                                               Float &offset,
+                                               Float &spacing)
+  {
+    ASCoreAssert(numOfItems > 0, "A line has at least one item");
+
+    // Handle edge cases
+    if (justifyContent == StackLayoutJustifyContent::SpaceBetween && (stackViolation < kViolationEpsilon || numOfItems == 1)) {
+      justifyContent = StackLayoutJustifyContent::Start;
+    } else if (justifyContent == StackLayoutJustifyContent::SpaceAround && (stackViolation < kViolationEpsilon || numOfItems == 1)) {
+      justifyContent = StackLayoutJustifyContent::Center;
+    }
+
+    offset = 0;
+    spacing = 0;
+
+    switch (justifyContent) {
+      case StackLayoutJustifyContent::Center:
+        offset = stackViolation / 2;
+        break;
+      case StackLayoutJustifyContent::End:
+        offset = stackViolation;
+        break;
+      case StackLayoutJustifyContent::SpaceBetween:
+        // Spacing between the items, no spaces at the edges, evenly distributed
+        spacing = stackViolation / (numOfItems - 1);
+        break;
+      case StackLayoutJustifyContent::SpaceAround: {
+        // Spacing between items are twice the spacing on the edges
+        const Float spacingUnit = stackViolation / (numOfItems * 2);
+        offset = spacingUnit;
+        spacing = spacingUnit * 2;
+        break;
+      }
+      case StackLayoutJustifyContent::Start:
+        break;
+    }
+  }
+
+  static void positionItemsInLine(const Line &line,
+                                  const Style &style,
+                                  const Point &startingPoint,
+                                  const Float stackSpacing,
+                                  std::vector<Item> &positionedItems)
+  {
+    Point p = startingPoint;
+    bool first = true;
+
+    for (const auto &item : line.items) {
+      p = add(p, directionPoint<Point, Float>(style.direction, item.child.spacingBefore, 0));
+      if (!first) {
+        p = add(p, directionPoint<Point, Float>(style.direction, style.spacing + stackSpacing, 0));
+      }
+      first = false;
+      positionedItems.push_back(item);
+      positionedItems.back().position = add(p, directionPoint<Point, Float>(style.direction, 0, crossOffsetForItem(item, style, line.crossSize, line.baseline)));
+
+      p = add(p, directionPoint<Point, Float>(style.direction, stackDimension(style.direction, item.size) + item.child.spacingAfter, 0));
+    }
+  }
+};
+
+} // namespace ASCore
@@ -18,12 +18,10 @@
 #import <vector>
 
 #import <AsyncDisplayKit/ASLayout.h>
+#import <AsyncDisplayKit/ASStackLayoutEngine.h>
 #import <AsyncDisplayKit/ASStackLayoutSpecUtilities.h>
 #import <AsyncDisplayKit/ASStackLayoutSpec.h>
 
-/** The threshold that determines if a violation has actually occurred. */
-AS_EXTERN CGFloat const kViolationEpsilon;
-
 struct ASStackLayoutSpecChild {
   /** The original source child. */
   id<ASLayoutElement> element;
@@ -31,51 +29,63 @@ struct ASStackLayoutSpecChild {
   ASLayoutElementStyle *style;
   /** Size object of the element */
   ASLayoutElementSize size;
+  /**
+   * Flex inputs of the element, read from the style once. The flex passes read these many times per item and
+   * each style accessor takes the style's lock.
+   */
+  CGFloat spacingBefore;
+  CGFloat spacingAfter;
+  CGFloat flexGrow;
+  CGFloat flexShrink;
+  ASDimension flexBasis;
+  ASStackLayoutAlignSelf alignSelf;
 };
 
-struct ASStackLayoutSpecItem {
-  /** The original source child. */
-  ASStackLayoutSpecChild child;
-  /** The proposed layout or nil if no is calculated yet. */
-  ASLayout *layout;
-};
+/**
+ * Adapts ASStackLayoutSpecChild and ASLayout to the stack engine in ASStackLayoutEngine.h, which is shared with the
+ * portable layout core.
+ */
+struct ASStackLayoutEngineTraits {
+  typedef CGFloat Float;
+  typedef CGSize Size;
+  typedef CGPoint Point;
+  typedef ASSizeRange SizeRange;
+  typedef ASStackLayoutSpecChild Child;
+  typedef ASLayout *Layout;
 
-struct ASStackUnpositionedLine {
-  /** The set of proposed children in this line, each contains child layout, not yet positioned. */
-  std::vector<ASStackLayoutSpecItem> items;
-  /** The total size of the children in the stack dimension, including all spacing. */
-  CGFloat stackDimensionSum;
-  /** The size in the cross dimension */
-  CGFloat crossSize;
-  /** The baseline of the stack which baseline aligned children should align to */
-  CGFloat baseline;
-};
+  static ASLayout *layoutThatFits(const ASStackLayoutSpecChild &child, const ASSizeRange &sizeRange, const CGSize &parentSize);
 
-/** Represents a set of stack layout children that have their final layout computed, but are not yet positioned. */
-struct ASStackUnpositionedLayout {
-  /** The set of proposed lines, each contains child layouts, not yet positioned. */
-  const std::vector<ASStackUnpositionedLine> lines;
-  /** 
-   * In a single line stack (e.g no wrao), this is the total size of the children in the stack dimension, including all spacing.
-   * In a multi-line stack, this is the largest stack dimension among lines.
-   */
-  const CGFloat stackDimensionSum;
-  const CGFloat crossDimensionSum;
-  
-  /** Given a set of children, computes the unpositioned layouts for those children. */
-  static ASStackUnpositionedLayout compute(const std::vector<ASStackLayoutSpecChild> &children,
-                                           const ASStackLayoutSpecStyle &style,
-                                           const ASSizeRange &sizeRange,
-                                           const BOOL concurrent);
-  
-  static CGFloat baselineForItem(const ASStackLayoutSpecStyle &style,
-                                 const ASStackLayoutSpecItem &l);
-  
-  static CGFloat computeStackViolation(const CGFloat stackDimensionSum,
-                                       const ASStackLayoutSpecStyle &style,
-                                       const ASSizeRange &sizeRange);
+  static CGSize layoutSize(ASLayout *layout)
+  {
+    return layout.size;
+  }
 
-  static CGFloat computeCrossViolation(const CGFloat crossDimensionSum,
-                                       const ASStackLayoutSpecStyle &style,
-                                       const ASSizeRange &sizeRange);
+  static CGFloat ascender(const ASStackLayoutSpecChild &child)
+  {
+    return child.style.ascender;
+  }
+
+  static CGFloat descender(const ASStackLayoutSpecChild &child)
+  {
+    return child.style.descender;
+  }
+
+  static CGFloat floorPixelValue(CGFloat f);
+
+  template <typename Work>
+  static void apply(size_t count, bool concurrent, const Work &work)
+  {
+    applyBlock(count, concurrent, ^(size_t i) {
+      work(i);
+    });
+  }
+
+  /** Calls work for each index, on helper queues if concurrent and there are enough items to make that worthwhile. */
+  static void applyBlock(size_t count, bool concurrent, void(^work)(size_t i));
 };
+
+typedef ASCore::StackLayoutSpecItem<ASStackLayoutEngineTraits> ASStackLayoutSpecItem;
+typedef ASCore::StackUnpositionedLine<ASStackLayoutEngineTraits> ASStackUnpositionedLine;
+
+/** Represents a set of stack layout children that have their final layout computed, but are not yet positioned. */
+typedef ASCore::StackUnpositionedLayout<ASStackLayoutEngineTraits> ASStackUnpositionedLayout;
@@ -204,6 +204,25 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType);
 /// Returns all item indexes affected by changes of the given type in the given section.
 - (NSIndexSet *)indexesForItemChangesOfType:(_ASHierarchyChangeType)changeType inSection:(NSUInteger)section;
 
+/**
+ * Counts the items, in section order across sections, at the start and at the end of the data that no change touches.
+ * They are the same items before and after the update. Inserted and deleted sections count as changes even if they
+ * are empty. The leading and trailing items never overlap. Both counts are 0 if the change set reloads data.
+ */
+- (void)getUnchangedLeadingItemCount:(NSUInteger *)leadingItemCount trailingItemCount:(NSUInteger *)trailingItemCount;
+
+/**
+ * Returns a new change set with the same effect as applying the given change sets one after the other. Items and
+ * sections that moved, or that were inserted and then deleted, become deletes and inserts of the merged change set.
+ * Executing its completion handler executes the completion handlers of the given change sets, in order.
+ *
+ * If any of the change sets includes reload data, or if a change set doesn't apply to the data left by the ones
+ * before it, the merged change set reloads data.
+ *
+ * @precondition None of the change sets are completed, and the first one has the old data of the merged change set.
+ */
++ (_ASHierarchyChangeSet *)changeSetByMergingChangeSets:(NSArray<_ASHierarchyChangeSet *> *)changeSets;
+
 - (void)reloadData;
 - (void)deleteSections:(NSIndexSet *)sections animationOptions:(ASDataControllerAnimationOptions)options;
 - (void)insertSections:(NSIndexSet *)sections animationOptions:(ASDataControllerAnimationOptions)options;
@@ -23,6 +23,7 @@
 #import <AsyncDisplayKit/ASDisplayNode+Beta.h>
 #import <AsyncDisplayKit/ASObjectDescriptionHelpers.h>
 #import <unordered_map>
+#import <vector>
 #import <AsyncDisplayKit/ASDataController.h>
 #import <AsyncDisplayKit/ASBaseDefines.h>
 
@@ -118,6 +119,31 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
 
 @end
 
+/**
+ * A section while merging change sets. It is either a section from before the first change set, in which case it
+ * tracks where each of its items came from once an item was deleted or inserted, or a section that one of the change
+ * sets inserted or reloaded.
+ */
+struct ASMergedSection {
+  // The section before the first change set, or NSNotFound if the section is new.
+  NSInteger oldSection;
+  NSInteger itemCount;
+  // The item before the first change set for each item, or NSNotFound if the item is new. Empty until items change.
+  bool itemsChanged;
+  std::vector<NSInteger> items;
+
+  void ensureItems()
+  {
+    if (!itemsChanged) {
+      items.resize(itemCount);
+      for (NSInteger i = 0; i < itemCount; i++) {
+        items[i] = i;
+      }
+      itemsChanged = true;
+    }
+  }
+};
+
 @implementation _ASHierarchyChangeSet {
   std::vector<NSInteger> _oldItemCounts;
   std::vector<NSInteger> _newItemCounts;
@@ -245,6 +271,73 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
   return result;
 }
 
+- (void)getUnchangedLeadingItemCount:(NSUInteger *)leadingItemCount trailingItemCount:(NSUInteger *)trailingItemCount
+{
+  [self _ensureCompleted];
+  *leadingItemCount = 0;
+  *trailingItemCount = 0;
+  if (_includesReloadData) {
+    return;
+  }
+
+  // The position of every section's first item, plus the total item count.
+  let sectionStarts = [](const std::vector<NSInteger> &itemCounts) {
+    std::vector<NSInteger> starts(1, 0);
+    for (let count : itemCounts) {
+      starts.push_back(starts.back() + count);
+    }
+    return starts;
+  };
+  let oldStarts = sectionStarts(_oldItemCounts);
+  let newStarts = sectionStarts(_newItemCounts);
+  NSInteger oldTotal = oldStarts.back();
+  NSInteger newTotal = newStarts.back();
+
+  // Items before the first change are at the same position in both data, so the first change can be looked for in
+  // both. The last changes are looked for separately, the items after them are the same ones counted from the end.
+  NSInteger firstChange = MIN(oldTotal, newTotal);
+  NSInteger oldChangesEnd = 0;
+  NSInteger newChangesEnd = 0;
+  BOOL changed = NO;
+  for (_ASHierarchySectionChange *change in _deleteSectionChanges) {
+    if (change.indexSet.count == 0) {
+      continue;
+    }
+    changed = YES;
+    firstChange = MIN(firstChange, oldStarts[change.indexSet.firstIndex]);
+    oldChangesEnd = MAX(oldChangesEnd, oldStarts[change.indexSet.lastIndex + 1]);
+  }
+  for (_ASHierarchySectionChange *change in _insertSectionChanges) {
+    if (change.indexSet.count == 0) {
+      continue;
+    }
+    changed = YES;
+    firstChange = MIN(firstChange, newStarts[change.indexSet.firstIndex]);
+    newChangesEnd = MAX(newChangesEnd, newStarts[change.indexSet.lastIndex + 1]);
+  }
+  for (_ASHierarchyItemChange *change in _deleteItemChanges) {
+    for (NSIndexPath *indexPath in change.indexPaths) {
+      changed = YES;
+      NSInteger position = oldStarts[indexPath.section] + indexPath.item;
+      firstChange = MIN(firstChange, position);
+      oldChangesEnd = MAX(oldChangesEnd, position + 1);
+    }
+  }
+  for (_ASHierarchyItemChange *change in _insertItemChanges) {
+    for (NSIndexPath *indexPath in change.indexPaths) {
+      changed = YES;
+      NSInteger position = newStarts[indexPath.section] + indexPath.item;
+      firstChange = MIN(firstChange, position);
+      newChangesEnd = MAX(newChangesEnd, position + 1);
+    }
+  }
+
+  *leadingItemCount = firstChange;
+  if (changed) {
+    *trailingItemCount = MIN(oldTotal - oldChangesEnd, newTotal - newChangesEnd);
+  }
+}
+
 - (NSUInteger)newSectionForOldSection:(NSUInteger)oldSection
 {
   return [self.sectionMapping integerForKey:oldSection];
@@ -431,6 +524,238 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
   [self insertSections:[NSIndexSet indexSetWithIndex:newSection] animationOptions:options];
 }
 
+#pragma mark Merging
+
++ (_ASHierarchyChangeSet *)changeSetByMergingChangeSets:(NSArray<_ASHierarchyChangeSet *> *)changeSets
+{
+  changeSets = [changeSets copy];
+  ASDisplayNodeAssert(changeSets.count > 0, @"Attempt to merge no change sets.");
+  _ASHierarchyChangeSet *firstChangeSet = changeSets.firstObject;
+  let result = [[_ASHierarchyChangeSet alloc] initWithOldData:firstChangeSet->_oldItemCounts];
+  result.rootActivity = firstChangeSet.rootActivity;
+  result.submitActivity = firstChangeSet.submitActivity;
+
+  BOOL animated = YES;
+  BOOL includesReloadData = NO;
+  for (_ASHierarchyChangeSet *changeSet in changeSets) {
+    [changeSet _ensureNotCompleted];
+    animated = animated && changeSet.animated;
+    includesReloadData = includesReloadData || changeSet.includesReloadData;
+  }
+  result.animated = animated;
+  [result addCompletionHandler:^(BOOL finished) {
+    for (_ASHierarchyChangeSet *changeSet in changeSets) {
+      [changeSet executeCompletionHandlerWithFinished:finished];
+    }
+  }];
+
+  // Replay the change sets, in order, on the sections from before the first one.
+  std::vector<ASMergedSection> sections;
+  NSInteger oldSection = 0;
+  for (let oldItemCount : firstChangeSet->_oldItemCounts) {
+    sections.push_back({oldSection++, oldItemCount, false, {}});
+  }
+  __block ASDataControllerAnimationOptions options = 0;
+  __block BOOL foundOptions = NO;
+  void (^recordOptions)(NSArray *) = ^(NSArray *changes) {
+    if (!foundOptions && changes.count > 0) {
+      options = [changes.firstObject animationOptions];
+      foundOptions = YES;
+    }
+  };
+  for (_ASHierarchyChangeSet *changeSet in changeSets) {
+    if (includesReloadData) {
+      break;
+    }
+    recordOptions(changeSet->_originalDeleteSectionChanges);
+    recordOptions(changeSet->_originalInsertSectionChanges);
+    recordOptions(changeSet->_reloadSectionChanges);
+    recordOptions(changeSet->_originalDeleteItemChanges);
+    recordOptions(changeSet->_originalInsertItemChanges);
+    recordOptions(changeSet->_reloadItemChanges);
+    if (![changeSet _applyToMergedSections:sections]) {
+      // The change set doesn't apply to the data it was submitted against. Fall back to reloading everything.
+      includesReloadData = YES;
+    }
+  }
+
+  if (includesReloadData) {
+    [result reloadData];
+    return result;
+  }
+
+  // Keep the old sections that are still in order. The others are deleted and inserted again, like moves are.
+  let deletedSections = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, firstChangeSet->_oldItemCounts.size())];
+  let insertedSections = [[NSMutableIndexSet alloc] init];
+  let deletedItems = [[NSMutableArray<NSIndexPath *> alloc] init];
+  let insertedItems = [[NSMutableArray<NSIndexPath *> alloc] init];
+  NSInteger lastOldSection = -1;
+  for (NSInteger newSection = 0; newSection < sections.size(); newSection++) {
+    let &section = sections[newSection];
+    if (section.oldSection == NSNotFound || section.oldSection <= lastOldSection) {
+      [insertedSections addIndex:newSection];
+      continue;
+    }
+    lastOldSection = section.oldSection;
+    [deletedSections removeIndex:section.oldSection];
+    if (!section.itemsChanged) {
+      continue;
+    }
+
+    // Same for the items of the section.
+    let keptItems = [[NSMutableIndexSet alloc] init];
+    NSInteger lastOldItem = -1;
+    for (NSInteger newItem = 0; newItem < section.items.size(); newItem++) {
+      NSInteger oldItem = section.items[newItem];
+      if (oldItem == NSNotFound || oldItem <= lastOldItem) {
+        [insertedItems addObject:[NSIndexPath indexPathForItem:newItem inSection:newSection]];
+      } else {
+        lastOldItem = oldItem;
+        [keptItems addIndex:oldItem];
+      }
+    }
+    for (NSInteger oldItem = 0; oldItem < section.itemCount; oldItem++) {
+      if (![keptItems containsIndex:oldItem]) {
+        [deletedItems addObject:[NSIndexPath indexPathForItem:oldItem inSection:section.oldSection]];
+      }
+    }
+  }
+
+  if (deletedSections.count > 0) {
+    [result deleteSections:deletedSections animationOptions:options];
+  }
+  if (insertedSections.count > 0) {
+    [result insertSections:insertedSections animationOptions:options];
+  }
+  if (deletedItems.count > 0) {
+    [result deleteItems:deletedItems animationOptions:options];
+  }
+  if (insertedItems.count > 0) {
+    [result insertItems:insertedItems animationOptions:options];
+  }
+  return result;
+}
+
+/**
+ * Applies the changes of this change set, which must not be completed, to the given sections the same way
+ * -markCompletedWithNewItemCounts: decomposes them: reloads become deletes at their old index and inserts at
+ * their new one, deletes apply before inserts and section changes before item changes.
+ *
+ * @return NO if a change is out of bounds, in which case the sections are left in an undefined state.
+ */
+- (BOOL)_applyToMergedSections:(std::vector<ASMergedSection> &)sections
+{
+  NSInteger oldSectionCount = sections.size();
+  NSIndexSet *originalDeletedSections = [_ASHierarchySectionChange allIndexesInSectionChanges:_originalDeleteSectionChanges];
+  NSIndexSet *originalInsertedSections = [_ASHierarchySectionChange allIndexesInSectionChanges:_originalInsertSectionChanges];
+  NSIndexSet *reloadedSections = [_ASHierarchySectionChange allIndexesInSectionChanges:_reloadSectionChanges];
+  let removedSections = [originalDeletedSections mutableCopy];
+  [removedSections addIndexes:reloadedSections];
+  if (removedSections.count > 0 && (NSInteger)removedSections.lastIndex >= oldSectionCount) {
+    ASFailUpdateValidation(@"Attempt to delete section %ld but there are only %ld sections before the update.", (long)removedSections.lastIndex, (long)oldSectionCount);
+    return NO;
+  }
+  NSInteger newSectionCount = oldSectionCount - originalDeletedSections.count + originalInsertedSections.count;
+  ASIntegerMap *sectionMapping = [ASIntegerMap mapForUpdateWithOldCount:oldSectionCount deleted:originalDeletedSections inserted:originalInsertedSections];
+
+  // Item deletes are in the old section indexes.
+  NSDictionary<NSNumber *, NSIndexSet *> *deleteMap = [_ASHierarchyItemChange sectionToIndexSetMapFromChanges:_originalDeleteItemChanges];
+  NSDictionary<NSNumber *, NSIndexSet *> *reloadMap = [_ASHierarchyItemChange sectionToIndexSetMapFromChanges:_reloadItemChanges];
+  NSDictionary<NSNumber *, NSIndexSet *> *insertMap = [_ASHierarchyItemChange sectionToIndexSetMapFromChanges:_originalInsertItemChanges];
+  std::unordered_map<NSInteger, NSMutableIndexSet *> insertedItems;
+  for (NSInteger section = 0; section < oldSectionCount; section++) {
+    NSIndexSet *deleted = deleteMap[@(section)];
+    NSIndexSet *reloaded = reloadMap[@(section)];
+    auto &mergedSection = sections[section];
+    // Items of new sections aren't tracked, the whole section is inserted.
+    if ((deleted == nil && reloaded == nil) || [removedSections containsIndex:section] || mergedSection.oldSection == NSNotFound) {
+      continue;
+    }
+    NSInteger itemCount = mergedSection.itemsChanged ? mergedSection.items.size() : mergedSection.itemCount;
+    let removedItems = [NSMutableIndexSet indexSet];
+    [removedItems addIndexes:deleted];
+    [removedItems addIndexes:reloaded];
+    if ((NSInteger)removedItems.lastIndex >= itemCount) {
+      ASFailUpdateValidation(@"Attempt to delete item %ld from section %ld, which only contains %ld items before the update.", (long)removedItems.lastIndex, (long)section, (long)itemCount);
+      return NO;
+    }
+
+    // Reloaded items are inserted again at their new index.
+    NSInteger newSection = [sectionMapping integerForKey:section];
+    if (reloaded != nil) {
+      ASIntegerMap *itemMapping = [ASIntegerMap mapForUpdateWithOldCount:itemCount deleted:deleted inserted:insertMap[@(newSection)]];
+      if (insertedItems[newSection] == nil) {
+        insertedItems[newSection] = [NSMutableIndexSet indexSet];
+      }
+      for (NSUInteger item = reloaded.firstIndex; item != NSNotFound; item = [reloaded indexGreaterThanIndex:item]) {
+        NSInteger newItem = [itemMapping integerForKey:item];
+        if (newItem == NSNotFound) {
+          ASFailUpdateValidation(@"Attempt to delete and reload the same item at index path %@", [NSIndexPath indexPathForItem:item inSection:section]);
+          return NO;
+        }
+        [insertedItems[newSection] addIndex:newItem];
+      }
+    }
+
+    mergedSection.ensureItems();
+    auto &items = mergedSection.items;
+    NSInteger remainingCount = 0;
+    for (NSInteger item = 0; item < items.size(); item++) {
+      if (![removedItems containsIndex:item]) {
+        items[remainingCount++] = items[item];
+      }
+    }
+    items.resize(remainingCount);
+  }
+
+  // Move the remaining sections to their new index, the other indexes are new sections.
+  std::vector<ASMergedSection> newSections(newSectionCount, ASMergedSection{NSNotFound, 0, false, {}});
+  for (NSInteger section = 0; section < oldSectionCount; section++) {
+    if (![removedSections containsIndex:section]) {
+      NSInteger newSection = [sectionMapping integerForKey:section];
+      if (newSection == NSNotFound || newSection >= newSectionCount) {
+        ASFailUpdateValidation(@"Attempt to insert section %ld but there are only %ld sections after the update.", (long)originalInsertedSections.lastIndex, (long)newSectionCount);
+        return NO;
+      }
+      newSections[newSection] = std::move(sections[section]);
+    }
+  }
+  sections = std::move(newSections);
+
+  // Item inserts are in the new section indexes.
+  for (NSNumber *section in insertMap) {
+    if (insertedItems[section.integerValue] == nil) {
+      insertedItems[section.integerValue] = [NSMutableIndexSet indexSet];
+    }
+    [insertedItems[section.integerValue] addIndexes:insertMap[section]];
+  }
+  for (let &e : insertedItems) {
+    NSInteger section = e.first;
+    if (section >= newSectionCount) {
+      ASFailUpdateValidation(@"Attempt to insert item %ld into section %ld, but there are only %ld sections after the update.", (long)e.second.firstIndex, (long)section, (long)newSectionCount);
+      return NO;
+    }
+    auto &mergedSection = sections[section];
+    if (mergedSection.oldSection == NSNotFound || [originalInsertedSections containsIndex:section]) {
+      continue;
+    }
+    mergedSection.ensureItems();
+    NSIndexSet *inserted = e.second;
+    NSInteger newItemCount = mergedSection.items.size() + inserted.count;
+    if ((NSInteger)inserted.lastIndex >= newItemCount) {
+      ASFailUpdateValidation(@"Attempt to insert item %ld into section %ld, which only contains %ld items after the update.", (long)inserted.lastIndex, (long)section, (long)newItemCount);
+      return NO;
+    }
+    std::vector<NSInteger> items;
+    items.reserve(newItemCount);
+    for (NSInteger item = 0, remainingItem = 0; item < newItemCount; item++) {
+      items.push_back([inserted containsIndex:item] ? NSNotFound : mergedSection.items[remainingItem++]);
+    }
+    mergedSection.items = std::move(items);
+  }
+  return YES;
+}
+
 #pragma mark Private
 
 - (BOOL)_ensureNotCompleted
@@ -0,0 +1,162 @@
+//
+//  ASCollectionLayoutCacheTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+#import <AsyncDisplayKit/ASCollectionGalleryLayoutDelegate.h>
+#import <AsyncDisplayKit/ASCollectionLayoutCache.h>
+#import <AsyncDisplayKit/ASCollectionLayoutContext+Private.h>
+#import <AsyncDisplayKit/ASCollectionLayoutState+Private.h>
+
+@interface ASCollectionLayoutCacheTests : XCTestCase
+@end
+
+@implementation ASCollectionLayoutCacheTests {
+  NSMutableArray<ASElementMap *> *_elementMaps;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  _elementMaps = [NSMutableArray array];
+}
+
+- (ASCollectionLayoutContext *)contextWithElements:(ASElementMap *)elements
+{
+  return [[ASCollectionLayoutContext alloc] initWithViewportSize:CGSizeMake(300, 500)
+                                            initialContentOffset:CGPointZero
+                                            scrollableDirections:ASScrollDirectionVerticalDirections
+                                                        elements:elements
+                                             layoutDelegateClass:[ASCollectionGalleryLayoutDelegate class]
+                                                     layoutCache:nil
+                                                  additionalInfo:nil];
+}
+
+/// Returns an empty layout for a new element map, which the test keeps alive.
+- (ASCollectionLayoutState *)layout
+{
+  ASElementMap *elements = [[ASElementMap alloc] init];
+  [_elementMaps addObject:elements];
+  return [[ASCollectionLayoutState alloc] initWithContext:[self contextWithElements:elements]];
+}
+
+/// Stores the layout and marks it as current, like the collection layout does once it applies it.
+- (void)applyLayout:(ASCollectionLayoutState *)layout inCache:(ASCollectionLayoutCache *)cache
+{
+  [cache setLayout:layout forContext:layout.context];
+  [cache markLayoutAsCurrentForContext:layout.context];
+}
+
+- (void)testThatLeastRecentlyUsedLayoutsAreEvictedOverTheCostLimit
+{
+  NSArray<ASCollectionLayoutState *> *layouts = @[ [self layout], [self layout], [self layout], [self layout] ];
+  let cache = [[ASCollectionLayoutCache alloc] initWithCostLimit:layouts[0].cost * 3];
+  for (NSUInteger i = 0; i < 3; i++) {
+    [self applyLayout:layouts[i] inCache:cache];
+  }
+  XCTAssertEqual(cache.totalCost, layouts[0].cost * 3);
+
+  // Using the first layout makes the second one the least recently used.
+  XCTAssertEqual([cache layoutForContext:[self contextWithElements:layouts[0].context.elements]], layouts[0]);
+  [cache setLayout:layouts[3] forContext:layouts[3].context];
+
+  XCTAssertEqual([cache layoutForContext:layouts[0].context], layouts[0]);
+  XCTAssertNil([cache layoutForContext:layouts[1].context]);
+  XCTAssertEqual([cache layoutForContext:layouts[2].context], layouts[2]);
+  XCTAssertEqual([cache layoutForContext:layouts[3].context], layouts[3]);
+  XCTAssertEqual(cache.totalCost, layouts[0].cost * 3);
+  XCTAssertEqual(cache.hitCount, 4);
+  XCTAssertEqual(cache.missCount, 1);
+  XCTAssertEqual(cache.evictionCount, 1);
+}
+
+- (void)testThatPendingAndCurrentLayoutsAreKeptOverTheCostLimit
+{
+  NSArray<ASCollectionLayoutState *> *layouts = @[ [self layout], [self layout], [self layout] ];
+  let cache = [[ASCollectionLayoutCache alloc] initWithCostLimit:layouts[0].cost - 1];
+
+  // The newest layout is stored even though it exceeds the limit on its own.
+  [self applyLayout:layouts[0] inCache:cache];
+  XCTAssertEqual(cache.totalCost, layouts[0].cost);
+
+  // Layouts of updates in flight are kept until they are applied, and so is the one on screen.
+  [cache setLayout:layouts[1] forContext:layouts[1].context];
+  [cache setLayout:layouts[2] forContext:layouts[2].context];
+  XCTAssertEqual(cache.totalCost, layouts[0].cost * 3);
+  XCTAssertEqual(cache.evictionCount, 0);
+
+  // Applying an update releases the previous layout.
+  [cache markLayoutAsCurrentForContext:layouts[1].context];
+  XCTAssertNil([cache layoutForContext:layouts[0].context]);
+  XCTAssertEqual([cache layoutForContext:layouts[1].context], layouts[1]);
+  XCTAssertEqual([cache layoutForContext:layouts[2].context], layouts[2]);
+  XCTAssertEqual(cache.evictionCount, 1);
+}
+
+- (void)testThatLayoutsStoredBeforeTheCurrentOneAreEvictedOverTheCostLimit
+{
+  NSArray<ASCollectionLayoutState *> *layouts = @[ [self layout], [self layout], [self layout], [self layout], [self layout] ];
+  let cache = [[ASCollectionLayoutCache alloc] initWithCostLimit:layouts[0].cost * 2];
+
+  // Layouts of superseded updates and replaced contexts are stored, but never applied.
+  for (NSUInteger i = 0; i < 4; i++) {
+    [cache setLayout:layouts[i] forContext:layouts[i].context];
+  }
+  XCTAssertEqual(cache.totalCost, layouts[0].cost * 4);
+
+  // Once a later layout is applied they are no longer pending, and the cost limit holds again.
+  [self applyLayout:layouts[4] inCache:cache];
+  XCTAssertLessThanOrEqual(cache.totalCost, cache.costLimit);
+  XCTAssertEqual(cache.evictionCount, 3);
+  XCTAssertEqual([cache layoutForContext:layouts[4].context], layouts[4]);
+  XCTAssertEqual([cache layoutForContext:layouts[3].context], layouts[3]);
+  for (NSUInteger i = 0; i < 3; i++) {
+    XCTAssertNil([cache layoutForContext:layouts[i].context]);
+  }
+}
+
+- (void)testThatMemoryWarningsKeepOnlyTheCurrentLayout
+{
+  let cache = [[ASCollectionLayoutCache alloc] init];
+  NSArray<ASCollectionLayoutState *> *layouts = @[ [self layout], [self layout], [self layout] ];
+  [self applyLayout:layouts[0] inCache:cache];
+  [self applyLayout:layouts[1] inCache:cache];
+  [cache setLayout:layouts[2] forContext:layouts[2].context];
+
+  [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+
+  XCTAssertNil([cache layoutForContext:layouts[0].context]);
+  XCTAssertEqual([cache layoutForContext:layouts[1].context], layouts[1]);
+  XCTAssertNil([cache layoutForContext:layouts[2].context]);
+  XCTAssertEqual(cache.totalCost, layouts[1].cost);
+  XCTAssertEqual(cache.evictionCount, 2);
+}
+
+- (void)testThatLayoutsOfDeallocatedElementMapsAreDropped
+{
+  let cache = [[ASCollectionLayoutCache alloc] init];
+  __weak ASCollectionLayoutState *weakLayout;
+  @autoreleasepool {
+    ASElementMap *elements = [[ASElementMap alloc] init];
+    ASCollectionLayoutState *layout = [[ASCollectionLayoutState alloc] initWithContext:[self contextWithElements:elements]];
+    [cache setLayout:layout forContext:layout.context];
+    weakLayout = layout;
+  }
+
+  ASCollectionLayoutState *layout = [self layout];
+  XCTAssertNil([cache layoutForContext:layout.context]);
+  XCTAssertNil(weakLayout);
+  XCTAssertEqual(cache.totalCost, 0);
+}
+
+@end
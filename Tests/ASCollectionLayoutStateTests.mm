@@ -0,0 +1,224 @@
+//
+//  ASCollectionLayoutStateTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+#import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASCollectionGalleryLayoutDelegate.h>
+#import <AsyncDisplayKit/ASCollectionLayoutContext+Private.h>
+#import <AsyncDisplayKit/ASCollectionLayoutState+Private.h>
+#import <AsyncDisplayKit/ASSection.h>
+#import <AsyncDisplayKit/_ASCollectionGalleryLayoutInfo.h>
+
+@interface ASCollectionLayoutStateTests : XCTestCase
+@end
+
+@implementation ASCollectionLayoutStateTests {
+  ASCollectionNode *_owningNode;
+  NSMutableArray<ASCollectionElement *> *_elements;
+  NSMutableArray<UICollectionViewLayoutAttributes *> *_allAttributes;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  _owningNode = [[ASCollectionNode alloc] initWithCollectionViewLayout:[[UICollectionViewFlowLayout alloc] init]];
+  _elements = [NSMutableArray array];
+  _allAttributes = [NSMutableArray array];
+}
+
+/**
+ * A masonry layout: three columns of items of varying height, and a few items spanning all columns.
+ */
+- (ASCollectionLayoutState *)masonryLayoutStateWithItemCount:(NSInteger)itemCount
+{
+  NSMapTable *table = [NSMapTable elementToLayoutAttributesTable];
+  CGFloat columnHeights[3] = { 0, 0, 0 };
+  for (NSInteger i = 0; i < itemCount; i++) {
+    CGRect frame;
+    if (i % 25 == 24) {
+      CGFloat top = MAX(columnHeights[0], MAX(columnHeights[1], columnHeights[2]));
+      frame = CGRectMake(0, top, 300, 50);
+      columnHeights[0] = columnHeights[1] = columnHeights[2] = CGRectGetMaxY(frame);
+    } else {
+      NSInteger column = i % 3;
+      frame = CGRectMake(column * 100, columnHeights[column], 100, 40 + (i * 37) % 160);
+      columnHeights[column] = CGRectGetMaxY(frame);
+    }
+    [self addAttributesWithFrame:frame toTable:table];
+  }
+  CGFloat height = MAX(columnHeights[0], MAX(columnHeights[1], columnHeights[2]));
+  return [self layoutStateWithContentSize:CGSizeMake(300, height) table:table];
+}
+
+- (void)addAttributesWithFrame:(CGRect)frame toTable:(NSMapTable *)table
+{
+  NSIndexPath *indexPath = [NSIndexPath indexPathForItem:_elements.count inSection:0];
+  ASCollectionElement *element = [[ASCollectionElement alloc] initWithNodeModel:nil
+                                                                      nodeBlock:^{ return [[ASCellNode alloc] init]; }
+                                                       supplementaryElementKind:nil
+                                                                constrainedSize:ASSizeRangeMake(frame.size)
+                                                                     owningNode:_owningNode
+                                                                traitCollection:ASPrimitiveTraitCollectionMakeDefault()];
+  UICollectionViewLayoutAttributes *attrs = [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+  attrs.frame = frame;
+  [table setObject:attrs forKey:element];
+  // The table holds elements weakly.
+  [_elements addObject:element];
+  [_allAttributes addObject:attrs];
+}
+
+- (ASCollectionLayoutState *)layoutStateWithContentSize:(CGSize)contentSize table:(NSMapTable *)table
+{
+  ASCollectionLayoutContext *context = [[ASCollectionLayoutContext alloc] initWithViewportSize:CGSizeMake(300, 500)
+                                                                          initialContentOffset:CGPointZero
+                                                                          scrollableDirections:ASScrollDirectionVerticalDirections
+                                                                                      elements:[[ASElementMap alloc] init]
+                                                                           layoutDelegateClass:[ASCollectionGalleryLayoutDelegate class]
+                                                                                   layoutCache:nil
+                                                                                additionalInfo:nil];
+  return [[ASCollectionLayoutState alloc] initWithContext:context contentSize:contentSize elementToLayoutAttributesTable:table];
+}
+
+- (NSSet<UICollectionViewLayoutAttributes *> *)attributesIntersectingRect:(CGRect)rect
+{
+  NSMutableSet *result = [NSMutableSet set];
+  for (UICollectionViewLayoutAttributes *attrs in _allAttributes) {
+    if (CGRectIntersectsRect(rect, attrs.frame)) {
+      [result addObject:attrs];
+    }
+  }
+  return result;
+}
+
+- (void)testThatRectQueriesReturnExactlyTheIntersectingAttributes
+{
+  ASCollectionLayoutState *state = [self masonryLayoutStateWithItemCount:1000];
+  CGFloat height = state.contentSize.height;
+  for (CGFloat y = -250; y < height + 250; y += 137) {
+    for (CGRect rect : { CGRectMake(0, y, 300, 500), CGRectMake(150, y, 20, 90), CGRectMake(0, y, 300, 0.5) }) {
+      NSArray *attributes = [state layoutAttributesForElementsInRect:rect];
+      NSSet *expectedAttributes = [self attributesIntersectingRect:rect];
+      XCTAssertEqual(attributes.count, expectedAttributes.count, @"Duplicate or missing attributes in %@", NSStringFromCGRect(rect));
+      XCTAssertEqualObjects([NSSet setWithArray:attributes], expectedAttributes, @"Wrong attributes in %@", NSStringFromCGRect(rect));
+    }
+  }
+
+  XCTAssertEqual([state layoutAttributesForElementsInRect:CGRectMake(0, height, 300, 500)].count, 0);
+  XCTAssertEqual([state layoutAttributesForElementsInRect:CGRectNull].count, 0);
+  XCTAssertEqual([state layoutAttributesForElementsInRect:CGRectMake(0, 0, 300, height)].count, 1000);
+}
+
+- (void)testThatRectQueriesIndexTheLongerAxis
+{
+  NSMapTable *table = [NSMapTable elementToLayoutAttributesTable];
+  for (NSInteger i = 0; i < 100; i++) {
+    [self addAttributesWithFrame:CGRectMake(i * 50, (i % 2) * 100, 60, 100) toTable:table];
+  }
+  ASCollectionLayoutState *state = [self layoutStateWithContentSize:CGSizeMake(5010, 200) table:table];
+
+  CGRect rect = CGRectMake(1000, 150, 200, 10);
+  NSArray *attributes = [state layoutAttributesForElementsInRect:rect];
+  XCTAssertEqualObjects([NSSet setWithArray:attributes], [self attributesIntersectingRect:rect]);
+  XCTAssertEqual(attributes.count, 3);
+}
+
+- (void)testThatUnmeasuredAttributesAreOnlyReturnedOnce
+{
+  ASCollectionLayoutState *state = [self masonryLayoutStateWithItemCount:500];
+
+  CGRect firstRect = CGRectMake(0, 0, 300, 500);
+  NSArray *attributes = [state getAndRemoveUnmeasuredLayoutAttributesInRect:firstRect];
+  XCTAssertEqualObjects([NSSet setWithArray:attributes], [self attributesIntersectingRect:firstRect]);
+  XCTAssertNil([state getAndRemoveUnmeasuredLayoutAttributesInRect:firstRect]);
+
+  // Attributes that span both rects were taken by the first one.
+  CGRect secondRect = CGRectMake(0, 0, 300, 1000);
+  NSMutableSet *expectedAttributes = [[self attributesIntersectingRect:secondRect] mutableCopy];
+  [expectedAttributes minusSet:[self attributesIntersectingRect:firstRect]];
+  attributes = [state getAndRemoveUnmeasuredLayoutAttributesInRect:secondRect];
+  XCTAssertEqual(attributes.count, expectedAttributes.count);
+  XCTAssertEqualObjects([NSSet setWithArray:attributes], expectedAttributes);
+
+  // Rect queries are not affected.
+  XCTAssertEqualObjects([NSSet setWithArray:[state layoutAttributesForElementsInRect:secondRect]], [self attributesIntersectingRect:secondRect]);
+}
+
+#pragma mark - Incremental layouts
+
+- (ASCollectionLayoutContext *)galleryContextWithElements:(ASElementMap *)elements
+                                         previousElements:(ASElementMap *)previousElements
+                                unchangedLeadingItemCount:(NSUInteger)unchangedLeadingItemCount
+                               unchangedTrailingItemCount:(NSUInteger)unchangedTrailingItemCount
+{
+  _ASCollectionGalleryLayoutInfo *info = [[_ASCollectionGalleryLayoutInfo alloc] initWithItemSize:CGSizeMake(90, 90)
+                                                                               minimumLineSpacing:10
+                                                                          minimumInteritemSpacing:5
+                                                                                     sectionInset:UIEdgeInsetsMake(8, 12, 8, 12)];
+  return [[ASCollectionLayoutContext alloc] initWithViewportSize:CGSizeMake(300, 500)
+                                            initialContentOffset:CGPointZero
+                                            scrollableDirections:ASScrollDirectionVerticalDirections
+                                                        elements:elements
+                                             layoutDelegateClass:[ASCollectionGalleryLayoutDelegate class]
+                                                     layoutCache:nil
+                                                  additionalInfo:info
+                                                previousElements:previousElements
+                                       unchangedLeadingItemCount:unchangedLeadingItemCount
+                                      unchangedTrailingItemCount:unchangedTrailingItemCount];
+}
+
+- (ASElementMap *)mapWithItemElements:(NSArray<ASCollectionElement *> *)itemElements
+{
+  return [[ASElementMap alloc] initWithSections:@[ [[ASSection alloc] initWithSectionID:0 context:nil] ]
+                                          items:@[ itemElements ]
+                          supplementaryElements:@{}];
+}
+
+- (void)testThatIncrementalGalleryLayoutMatchesFullLayout
+{
+  for (NSInteger i = 0; i < 40; i++) {
+    [self addAttributesWithFrame:CGRectMake(0, 0, 90, 90) toTable:[NSMapTable elementToLayoutAttributesTable]];
+  }
+  NSArray<ASCollectionElement *> *previousItemElements = [_elements copy];
+  ASElementMap *previousElements = [self mapWithItemElements:previousItemElements];
+  Class<ASCollectionLayoutDelegate> delegateClass = [ASCollectionGalleryLayoutDelegate class];
+  ASCollectionLayoutState *previousLayout = [delegateClass calculateLayoutWithContext:[self galleryContextWithElements:previousElements previousElements:nil unchangedLeadingItemCount:0 unchangedTrailingItemCount:0]];
+
+  // Insert 2 items in the middle of the 4th line: the trailing items reflow by 2 positions.
+  NSMutableArray<ASCollectionElement *> *itemElements = [previousItemElements mutableCopy];
+  for (NSInteger i = 0; i < 2; i++) {
+    [self addAttributesWithFrame:CGRectMake(0, 0, 90, 90) toTable:[NSMapTable elementToLayoutAttributesTable]];
+    [itemElements insertObject:_elements.lastObject atIndex:10];
+  }
+  ASElementMap *elements = [self mapWithItemElements:itemElements];
+  ASCollectionLayoutState *expectedLayout = [delegateClass calculateLayoutWithContext:[self galleryContextWithElements:elements previousElements:nil unchangedLeadingItemCount:0 unchangedTrailingItemCount:0]];
+  ASCollectionLayoutState *layout = [delegateClass calculateLayoutWithContext:[self galleryContextWithElements:elements previousElements:previousElements unchangedLeadingItemCount:10 unchangedTrailingItemCount:30]
+                                                               previousLayout:previousLayout
+                                                    unchangedLeadingItemCount:10
+                                                   unchangedTrailingItemCount:30];
+
+  XCTAssertNotNil(layout);
+  XCTAssertTrue(CGSizeEqualToSize(layout.contentSize, expectedLayout.contentSize));
+  XCTAssertEqual(layout.allLayoutAttributes.count, itemElements.count);
+  for (ASCollectionElement *element in itemElements) {
+    UICollectionViewLayoutAttributes *attrs = [layout layoutAttributesForElement:element];
+    UICollectionViewLayoutAttributes *expectedAttrs = [expectedLayout layoutAttributesForElement:element];
+    XCTAssertTrue(CGRectEqualToRect(attrs.frame, expectedAttrs.frame), @"%@ != %@", NSStringFromCGRect(attrs.frame), NSStringFromCGRect(expectedAttrs.frame));
+    XCTAssertEqualObjects(attrs.indexPath, expectedAttrs.indexPath);
+  }
+  // Leading items keep their attributes.
+  XCTAssertEqual([layout layoutAttributesForElement:itemElements[0]], [previousLayout layoutAttributesForElement:itemElements[0]]);
+}
+
+@end
+
@@ -18,18 +18,22 @@
 #import <XCTest/XCTest.h>
 #import <AsyncDisplayKit/AsyncDisplayKit.h>
 #import <AsyncDisplayKit/ASCollectionViewFlowLayoutInspector.h>
+#import <AsyncDisplayKit/ASCollectionInternal.h>
 #import <AsyncDisplayKit/ASDataController.h>
+#import <AsyncDisplayKit/ASRangeController.h>
 #import <AsyncDisplayKit/ASSectionContext.h>
 #import <vector>
 #import <OCMock/OCMock.h>
 #import <AsyncDisplayKit/ASCollectionView+Undeprecated.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
 #import "ASDisplayNodeTestsHelper.h"
+#import "ASTestCase.h"
 
 @interface ASTextCellNodeWithSetSelectedCounter : ASTextCellNode
 
 @property (nonatomic) NSUInteger setSelectedCounter;
 @property (nonatomic) NSUInteger applyLayoutAttributesCount;
+@property (atomic) BOOL measuredOnMainThread;
 
 @end
 
@@ -46,6 +50,14 @@
   _applyLayoutAttributesCount++;
 }
 
+- (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
+{
+  if (ASDisplayNodeThreadIsMain()) {
+    self.measuredOnMainThread = YES;
+  }
+  return [super calculateLayoutThatFits:constrainedSize];
+}
+
 @end
 
 @interface ASTestSectionContext : NSObject <ASSectionContext>
@@ -174,6 +186,15 @@
 
 @end
 
+@interface ASDataController (InternalTesting)
+
+- (NSArray<ASCollectionElement *> *)_elementsByProximity:(NSArray<ASCollectionElement *> *)elements
+                                            toIndexPaths:(NSArray<NSIndexPath *> *)anchorIndexPaths
+                                                   inMap:(ASElementMap *)map
+                                         firstPhaseCount:(NSUInteger *)firstPhaseCount;
+
+@end
+
 @interface ASCollectionViewTests : XCTestCase
 
 @end
@@ -708,6 +729,84 @@
   XCTAssertEqualObjects(completions, (@[ inner0, inner1, outer ]), @"Expected completion order to be correct");
 }
 
+- (void)testThatBackToBackUpdatesDontWaitForEarlierUpdates
+{
+  updateValidationTestPrologue
+  NSInteger section = del->_itemCounts.size() - 1;
+  ASDataController *dataController = cv.dataController;
+  NSUInteger deliveredUpdateCount = dataController.updateStatistics.deliveredUpdateCount;
+
+  for (NSInteger i = 0; i < 3; i++) {
+    del->_itemCounts[section]++;
+    [cv insertItemsAtIndexPaths:@[ [NSIndexPath indexPathForItem:0 inSection:section] ]];
+    XCTAssertEqual(dataController.updateStatistics.mainThreadWaitDuration, 0);
+  }
+  [cn waitUntilAllUpdatesAreProcessed];
+
+  ASDataControllerUpdateStatistics statistics = dataController.updateStatistics;
+  XCTAssertEqual(statistics.deliveredUpdateCount, deliveredUpdateCount + 3);
+  XCTAssertEqual(statistics.inFlightUpdateCount, 0);
+  XCTAssertGreaterThanOrEqual(statistics.maxInFlightUpdateCount, 1);
+  XCTAssertEqual([cn numberOfItemsInSection:section], del->_itemCounts[section]);
+}
+
+- (void)testThatNodesAreAllocatedOutwardFromVisibleElements
+{
+  updateValidationTestPrologue
+  ASDataController *dataController = cv.dataController;
+  ASElementMap *map = dataController.visibleMap;
+  NSArray<ASCollectionElement *> *elements = map.itemElements;
+  XCTAssertEqual(elements.count, 100);
+
+  // Ten sections of ten items, so items 23 to 26 are on screen.
+  NSArray *visibleIndexPaths = @[ [NSIndexPath indexPathForItem:3 inSection:2], [NSIndexPath indexPathForItem:6 inSection:2] ];
+  NSUInteger firstPhaseCount;
+  NSArray<ASCollectionElement *> *orderedElements = [dataController _elementsByProximity:elements toIndexPaths:visibleIndexPaths inMap:map firstPhaseCount:&firstPhaseCount];
+  XCTAssertEqual(orderedElements.count, elements.count);
+  XCTAssertEqualObjects([NSSet setWithArray:orderedElements], [NSSet setWithArray:elements]);
+  XCTAssertEqualObjects(orderedElements[0], elements[23]);
+  XCTAssertEqualObjects(orderedElements[1], elements[26]);
+  XCTAssertEqualObjects(orderedElements.lastObject, elements[99]);
+  // The elements at most a visible span (4 items) away from the screen go first.
+  XCTAssertEqual(firstPhaseCount, 12);
+  XCTAssertEqualObjects([NSSet setWithArray:[orderedElements subarrayWithRange:NSMakeRange(0, firstPhaseCount)]],
+                        [NSSet setWithArray:[elements subarrayWithRange:NSMakeRange(19, 12)]]);
+
+  // Index paths from an older, larger map are clamped.
+  orderedElements = [dataController _elementsByProximity:elements toIndexPaths:@[ [NSIndexPath indexPathForItem:0 inSection:20] ] inMap:map firstPhaseCount:&firstPhaseCount];
+  XCTAssertEqualObjects(orderedElements[0], elements[90]);
+  XCTAssertEqual(firstPhaseCount, 3);
+
+  // Without anything on screen, the order is kept.
+  orderedElements = [dataController _elementsByProximity:elements toIndexPaths:@[] inMap:map firstPhaseCount:&firstPhaseCount];
+  XCTAssertEqualObjects(orderedElements, elements);
+  XCTAssertEqual(firstPhaseCount, elements.count);
+}
+
+- (void)testThatFlowLayoutUpdatesWaitForTheSecondAllocationPhase
+{
+  updateValidationTestPrologue
+  ASDataController *dataController = cv.dataController;
+  NSUInteger deliveredUpdateCount = dataController.updateStatistics.deliveredUpdateCount;
+
+  // Items are on screen now, so the reload allocates its nodes in two phases. The flow layout asks for the size of
+  // every item once the update is applied, so the update must not be delivered before the second phase is done.
+  [cn reloadData];
+  XCTAssertTrue(ASDisplayNodeRunRunLoopUntilBlockIsTrue(^BOOL{
+    return dataController.updateStatistics.deliveredUpdateCount > deliveredUpdateCount;
+  }));
+  [cv layoutIfNeeded];
+
+  NSArray<ASCollectionElement *> *elements = dataController.visibleMap.itemElements;
+  XCTAssertEqual(elements.count, 100);
+  for (ASCollectionElement *element in elements) {
+    let node = (ASTextCellNodeWithSetSelectedCounter *)element.nodeIfAllocated;
+    XCTAssertNotNil(node.calculatedLayout, @"%@", element);
+    XCTAssertFalse(node.measuredOnMainThread, @"%@", element);
+  }
+  [cn waitUntilAllUpdatesAreProcessed];
+}
+
 #pragma mark - ASSectionContext tests
 
 - (void)testThatSectionContextsAreCorrectAfterTheInitialLayout
@@ -1088,6 +1187,94 @@
   XCTAssertEqual([[cn valueForKeyPath:@"rangeController.currentRangeMode"] integerValue], ASLayoutRangeModeMinimum, @"Expected range mode to be minimum before scrolling begins.");
 }
 
+- (void)testThatRangesFollowScrolling
+{
+  UIWindow *window = [[UIWindow alloc] initWithFrame:[UIScreen mainScreen].bounds];
+  ASCollectionViewTestController *testController = [[ASCollectionViewTestController alloc] initWithNibName:nil bundle:nil];
+  testController.asyncDelegate->_itemCounts = std::vector<NSInteger>(10, 100);
+  ASCollectionNode *cn = testController.collectionNode;
+  ASRangeController *rangeController = [cn valueForKeyPath:@"rangeController"];
+  window.rootViewController = testController;
+  [window makeKeyAndVisible];
+  [window layoutIfNeeded];
+  [cn waitUntilAllUpdatesAreProcessed];
+  [cn.view layoutIfNeeded];
+
+  // Scroll down and back up in steps. Each update only visits the items that entered or exited a range,
+  // so items must be cleared as they exit and set as they enter.
+  CGFloat height = cn.bounds.size.height;
+  CGFloat maxOffset = cn.view.contentSize.height - height;
+  XCTAssertGreaterThan(maxOffset, 10 * height);
+  for (CGFloat offset : { 0.5, 1.0, 2.5, 5.0, 5.5, 9.0, 4.0, 0.0 }) {
+    cn.view.contentOffset = CGPointMake(0, MIN(offset * height, maxOffset));
+    [cn.view layoutIfNeeded];
+    [rangeController updateIfNeeded];
+
+    CGRect bounds = cn.view.bounds;
+    CGRect farBounds = CGRectInset(bounds, 0, -4 * height);
+    for (NSInteger s = 0; s < cn.numberOfSections; s++) {
+      for (NSInteger i = 0; i < [cn numberOfItemsInSection:s]; i++) {
+        NSIndexPath *indexPath = [NSIndexPath indexPathForItem:i inSection:s];
+        ASCellNode *node = [cn nodeForItemAtIndexPath:indexPath];
+        CGRect frame = [cn.view layoutAttributesForItemAtIndexPath:indexPath].frame;
+        if (CGRectIntersectsRect(CGRectInset(bounds, 0, 1), frame)) {
+          XCTAssertTrue(node.isVisible, @"Expected %@ to be visible at offset %f", indexPath, offset);
+        }
+        if (CGRectIntersectsRect(farBounds, frame) == NO) {
+          XCTAssertFalse(node.isVisible || node.isInPreloadState || node.isInDisplayState, @"Expected %@ to be out of range at offset %f", indexPath, offset);
+        }
+      }
+    }
+  }
+}
+
+- (void)testThatMemoryBudgetLimitsRanges
+{
+  ASConfiguration *config = [[ASConfiguration alloc] initWithDictionary:nil];
+  config.experimentalFeatures = ASExperimentalRangeMemoryBudget;
+  [ASConfigurationManager test_resetWithConfiguration:config];
+  NSUInteger defaultBudget = [ASDisplayNode rangeMemoryBudget];
+  [ASDisplayNode setRangeMemoryBudget:1];
+
+  UIWindow *window = [[UIWindow alloc] initWithFrame:[UIScreen mainScreen].bounds];
+  ASCollectionViewTestController *testController = [[ASCollectionViewTestController alloc] initWithNibName:nil bundle:nil];
+  testController.asyncDelegate->_itemCounts = std::vector<NSInteger>(1, 100);
+  ASCollectionNode *cn = testController.collectionNode;
+  ASRangeController *rangeController = [cn valueForKeyPath:@"rangeController"];
+  window.rootViewController = testController;
+  [window makeKeyAndVisible];
+  [window layoutIfNeeded];
+  [cn waitUntilAllUpdatesAreProcessed];
+  [cn.view layoutIfNeeded];
+  [rangeController updateIfNeeded];
+
+  // Only the visible items fit in the budget.
+  CGRect bounds = cn.view.bounds;
+  NSIndexPath *firstOffscreenIndexPath = nil;
+  for (NSInteger i = 0; i < [cn numberOfItemsInSection:0]; i++) {
+    NSIndexPath *indexPath = [NSIndexPath indexPathForItem:i inSection:0];
+    ASCellNode *node = [cn nodeForItemAtIndexPath:indexPath];
+    CGRect frame = [cn.view layoutAttributesForItemAtIndexPath:indexPath].frame;
+    if (CGRectIntersectsRect(CGRectInset(bounds, 0, 1), frame)) {
+      XCTAssertTrue(node.isVisible && node.isInPreloadState && node.isInDisplayState, @"Expected %@ to be visible", indexPath);
+    } else if (CGRectIntersectsRect(CGRectInset(bounds, 0, -10), frame) == NO) {
+      XCTAssertFalse(node.isInPreloadState || node.isInDisplayState, @"Expected %@ to be out of range", indexPath);
+      if (firstOffscreenIndexPath == nil && CGRectGetMinY(frame) > CGRectGetMaxY(bounds)) {
+        firstOffscreenIndexPath = indexPath;
+      }
+    }
+  }
+  XCTAssertNotNil(firstOffscreenIndexPath);
+
+  // Raising the budget admits the rest of the ranges.
+  [ASDisplayNode setRangeMemoryBudget:NSUIntegerMax];
+  [rangeController updateIfNeeded];
+  XCTAssertTrue([cn nodeForItemAtIndexPath:firstOffscreenIndexPath].isInPreloadState);
+
+  [ASDisplayNode setRangeMemoryBudget:defaultBudget];
+  [ASConfigurationManager test_resetWithConfiguration:nil];
+}
+
 - (void)testTraitCollectionChangesMidUpdate
 {
   CGRect screenBounds = [UIScreen mainScreen].bounds;
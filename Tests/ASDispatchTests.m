@@ -69,4 +69,55 @@
   XCTAssertEqualObjects(indices, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, iterations)]);
 }
 
+- (void)testDispatchCooperativeApply
+{
+  dispatch_queue_t q = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+  NSInteger expectedThreadCount = [NSProcessInfo processInfo].activeProcessorCount + 1;
+  NSLock *lock = [NSLock new];
+  NSMutableSet *threads = [NSMutableSet set];
+  NSMutableIndexSet *indices = [NSMutableIndexSet indexSet];
+  
+  size_t const iterations = 1E5;
+  ASDispatchCooperativeApply(iterations, q, 2, ^(size_t i) {
+    [lock lock];
+    [threads addObject:[NSThread currentThread]];
+    XCTAssertFalse([indices containsIndex:i]);
+    [indices addIndex:i];
+    [lock unlock];
+  });
+  XCTAssertLessThanOrEqual(threads.count, expectedThreadCount);
+  XCTAssertEqualObjects(indices, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, iterations)]);
+}
+
+- (void)testDispatchCooperativeApplyNested
+{
+  dispatch_queue_t q = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+  NSLock *lock = [NSLock new];
+  NSMutableIndexSet *indices = [NSMutableIndexSet indexSet];
+  
+  size_t const outerIterations = 100;
+  size_t const innerIterations = 100;
+  ASDispatchCooperativeApply(outerIterations, q, 2, ^(size_t i) {
+    ASDispatchCooperativeApply(innerIterations, q, 2, ^(size_t j) {
+      [lock lock];
+      [indices addIndex:i * innerIterations + j];
+      [lock unlock];
+    });
+  });
+  XCTAssertEqualObjects(indices, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, outerIterations * innerIterations)]);
+}
+
+- (void)testDispatchCooperativeApplyRunsSmallWorkOnCallingThread
+{
+  dispatch_queue_t q = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+  NSThread *thread = [NSThread currentThread];
+  __block size_t count = 0;
+  ASDispatchCooperativeApply(3, q, 4, ^(size_t i) {
+    XCTAssertEqual(thread, [NSThread currentThread]);
+    XCTAssertEqual(count, i);
+    count++;
+  });
+  XCTAssertEqual(count, 3);
+}
+
 @end
@@ -15,7 +15,7 @@
 //      http://www.apache.org/licenses/LICENSE-2.0
 //
 
-#import <XCTest/XCTest.h>
+#import "ASTestCase.h"
 
 #import <AsyncDisplayKit/AsyncDisplayKit.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
@@ -43,7 +43,7 @@
 
 @end
 
-@interface ASDisplayNodeImplicitHierarchyTests : XCTestCase
+@interface ASDisplayNodeImplicitHierarchyTests : ASTestCase
 
 @end
 
@@ -187,6 +187,59 @@
   XCTAssertEqual(node.subnodes[2], node2);
 }
 
+- (void)testIncrementalLayoutTransitionMatchesSynchronousResult
+{
+  ASConfiguration *config = [[ASConfiguration alloc] initWithDictionary:nil];
+  config.experimentalFeatures = ASExperimentalIncrementalLayoutTransitions;
+  [ASConfigurationManager test_resetWithConfiguration:config];
+
+  NSMutableArray<ASDisplayNode *> *nodes = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 200; i++) {
+    ASDisplayNode *subnode = [[ASDisplayNode alloc] init];
+    subnode.style.preferredSize = CGSizeMake(10, 10);
+    [nodes addObject:subnode];
+  }
+
+  // State 1 shows the first half in order, state 2 shows every third node in reverse order.
+  NSArray<ASDisplayNode *> *firstNodes = [nodes subarrayWithRange:NSMakeRange(0, 100)];
+  NSMutableArray<ASDisplayNode *> *secondNodes = [NSMutableArray array];
+  for (ASDisplayNode *subnode in nodes.reverseObjectEnumerator) {
+    if ([nodes indexOfObject:subnode] % 3 == 0) {
+      [secondNodes addObject:subnode];
+    }
+  }
+
+  ASSpecTestDisplayNode *node = [[ASSpecTestDisplayNode alloc] init];
+  node.automaticallyManagesSubnodes = YES;
+  node.layoutSpecBlock = ^(ASDisplayNode *weakNode, ASSizeRange constrainedSize){
+    ASSpecTestDisplayNode *strongNode = (ASSpecTestDisplayNode *)weakNode;
+    NSArray *children = [strongNode.layoutState isEqualToNumber:@1] ? firstNodes : secondNodes;
+    return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionVertical
+                                                   spacing:0
+                                            justifyContent:ASStackLayoutJustifyContentStart
+                                                alignItems:ASStackLayoutAlignItemsStart
+                                                  children:children];
+  };
+
+  ASDisplayNodeSizeToFitSizeRange(node, ASSizeRangeMake(CGSizeZero, CGSizeMake(CGFLOAT_MAX, CGFLOAT_MAX)));
+  [node.view layoutIfNeeded];
+
+  node.layoutState = @2;
+  [node setNeedsLayout];
+  ASDisplayNodeSizeToFitSizeRange(node, ASSizeRangeMake(CGSizeZero, CGSizeMake(CGFLOAT_MAX, CGFLOAT_MAX)));
+  [node.view layoutIfNeeded];
+
+  NSDate *date = [NSDate dateWithTimeIntervalSinceNow:2];
+  while ([date timeIntervalSinceNow] > 0 && [node.subnodes isEqualToArray:secondNodes] == NO) {
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+
+  XCTAssertEqualObjects(node.subnodes, secondNodes);
+  [secondNodes enumerateObjectsUsingBlock:^(ASDisplayNode *subnode, NSUInteger idx, BOOL *stop) {
+    XCTAssertTrue(CGRectEqualToRect(subnode.frame, CGRectMake(0, idx * 10, 10, 10)));
+  }];
+}
+
 // Disable test for now as we disabled the assertion
 //- (void)testLayoutTransitionWillThrowForManualSubnodeManagement
 //{
@@ -0,0 +1,130 @@
+//
+//  ASElementMapPerformanceTests.m
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+#import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASSection.h>
+
+/**
+ * Benchmarks of the element map lookups that collection views do on every layout pass: index path for element and
+ * element for layout attributes, over every element of maps with 10k and 100k elements in sections of 100 items,
+ * each section with a header.
+ *
+ * NOTE: This test case is not run during the "test" action. You have to run it manually (click the little diamond.)
+ */
+
+@interface ASElementMapPerformanceTests : XCTestCase
+@end
+
+@implementation ASElementMapPerformanceTests {
+  ASCollectionNode *_owningNode;
+}
+
+static NSInteger const kItemsPerSection = 100;
+
+- (void)setUp
+{
+  [super setUp];
+  _owningNode = [[ASCollectionNode alloc] initWithCollectionViewLayout:[[UICollectionViewFlowLayout alloc] init]];
+}
+
+- (ASCollectionElement *)elementOfKind:(NSString *)kind
+{
+  return [[ASCollectionElement alloc] initWithNodeModel:nil
+                                              nodeBlock:^{ return [[ASCellNode alloc] init]; }
+                               supplementaryElementKind:kind
+                                        constrainedSize:ASSizeRangeUnconstrained
+                                             owningNode:_owningNode
+                                        traitCollection:ASPrimitiveTraitCollectionMakeDefault()];
+}
+
+- (ASElementMap *)mapWithElementCount:(NSInteger)elementCount
+{
+  NSInteger sectionCount = elementCount / kItemsPerSection;
+  NSMutableArray<ASSection *> *sections = [NSMutableArray arrayWithCapacity:sectionCount];
+  NSMutableArray<NSArray<ASCollectionElement *> *> *items = [NSMutableArray arrayWithCapacity:sectionCount];
+  NSMutableDictionary<NSIndexPath *, ASCollectionElement *> *headers = [NSMutableDictionary dictionaryWithCapacity:sectionCount];
+  for (NSInteger s = 0; s < sectionCount; s++) {
+    [sections addObject:[[ASSection alloc] initWithSectionID:s context:nil]];
+    NSMutableArray<ASCollectionElement *> *sectionOfItems = [NSMutableArray arrayWithCapacity:kItemsPerSection];
+    for (NSInteger i = 0; i < kItemsPerSection; i++) {
+      [sectionOfItems addObject:[self elementOfKind:nil]];
+    }
+    [items addObject:sectionOfItems];
+    headers[[NSIndexPath indexPathForItem:0 inSection:s]] = [self elementOfKind:UICollectionElementKindSectionHeader];
+  }
+  return [[ASElementMap alloc] initWithSections:sections
+                                          items:items
+                          supplementaryElements:@{ UICollectionElementKindSectionHeader : headers }];
+}
+
+- (void)measureIndexPathLookupsWithElementCount:(NSInteger)elementCount
+{
+  ASElementMap *map = [self mapWithElementCount:elementCount];
+  NSMutableArray<ASCollectionElement *> *elements = [NSMutableArray arrayWithCapacity:map.count];
+  for (ASCollectionElement *element in map) {
+    [elements addObject:element];
+  }
+
+  [self measureBlock:^{
+    NSUInteger foundCount = 0;
+    for (ASCollectionElement *element in elements) {
+      foundCount += ([map indexPathForElement:element] != nil);
+    }
+    XCTAssertEqual(foundCount, elements.count);
+  }];
+}
+
+- (void)measureLayoutAttributesLookupsWithElementCount:(NSInteger)elementCount
+{
+  ASElementMap *map = [self mapWithElementCount:elementCount];
+  NSMutableArray<UICollectionViewLayoutAttributes *> *attributes = [NSMutableArray arrayWithCapacity:map.count];
+  for (NSIndexPath *indexPath in map.itemIndexPaths) {
+    [attributes addObject:[UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath]];
+  }
+  for (NSInteger s = 0; s < map.numberOfSections; s++) {
+    NSIndexPath *indexPath = [NSIndexPath indexPathForItem:0 inSection:s];
+    [attributes addObject:[UICollectionViewLayoutAttributes layoutAttributesForSupplementaryViewOfKind:UICollectionElementKindSectionHeader withIndexPath:indexPath]];
+  }
+
+  [self measureBlock:^{
+    NSUInteger foundCount = 0;
+    for (UICollectionViewLayoutAttributes *layoutAttributes in attributes) {
+      foundCount += ([map elementForLayoutAttributes:layoutAttributes] != nil);
+    }
+    XCTAssertEqual(foundCount, attributes.count);
+  }];
+}
+
+- (void)testPerformance_IndexPathForElement10k
+{
+  [self measureIndexPathLookupsWithElementCount:10000];
+}
+
+- (void)testPerformance_IndexPathForElement100k
+{
+  [self measureIndexPathLookupsWithElementCount:100000];
+}
+
+- (void)testPerformance_ElementForLayoutAttributes10k
+{
+  [self measureLayoutAttributesLookupsWithElementCount:10000];
+}
+
+- (void)testPerformance_ElementForLayoutAttributes100k
+{
+  [self measureLayoutAttributesLookupsWithElementCount:100000];
+}
+
+@end
@@ -0,0 +1,134 @@
+//
+//  ASElementMapTests.m
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+#import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASMutableElementMap.h>
+#import <AsyncDisplayKit/ASSection.h>
+
+@interface ASElementMap (Testing)
+@property (nonatomic, readonly) ASCollectionElementTwoDimensionalArray *sectionsOfItems;
+@end
+
+@interface ASElementMapTests : XCTestCase
+@end
+
+@implementation ASElementMapTests {
+  NSArray<ASSection *> *_sections;
+  ASCollectionNode *_owningNode;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  _owningNode = [[ASCollectionNode alloc] initWithCollectionViewLayout:[[UICollectionViewFlowLayout alloc] init]];
+  _sections = @[ [[ASSection alloc] initWithSectionID:0 context:nil], [[ASSection alloc] initWithSectionID:1 context:nil] ];
+}
+
+- (ASCollectionElement *)elementOfKind:(NSString *)kind
+{
+  return [[ASCollectionElement alloc] initWithNodeModel:nil
+                                              nodeBlock:^{ return [[ASCellNode alloc] init]; }
+                               supplementaryElementKind:kind
+                                        constrainedSize:ASSizeRangeUnconstrained
+                                             owningNode:_owningNode
+                                        traitCollection:ASPrimitiveTraitCollectionMakeDefault()];
+}
+
+- (ASElementMap *)mapWithItemCounts:(NSArray<NSNumber *> *)itemCounts
+{
+  NSMutableArray *items = [NSMutableArray array];
+  for (NSNumber *itemCount in itemCounts) {
+    NSMutableArray *section = [NSMutableArray array];
+    for (NSInteger i = 0; i < itemCount.integerValue; i++) {
+      [section addObject:[self elementOfKind:nil]];
+    }
+    [items addObject:section];
+  }
+  return [[ASElementMap alloc] initWithSections:_sections items:items supplementaryElements:@{}];
+}
+
+- (void)testInsertingItemSharesUntouchedSections
+{
+  ASElementMap *map = [self mapWithItemCounts:@[ @3, @3 ]];
+  ASCollectionElement *movedElement = [map elementForItemAtIndexPath:[NSIndexPath indexPathForItem:0 inSection:1]];
+  ASCollectionElement *untouchedElement = [map elementForItemAtIndexPath:[NSIndexPath indexPathForItem:2 inSection:0]];
+
+  ASMutableElementMap *mutableMap = [map mutableCopy];
+  ASCollectionElement *insertedElement = [self elementOfKind:nil];
+  [mutableMap insertElement:insertedElement atIndexPath:[NSIndexPath indexPathForItem:0 inSection:1]];
+  ASElementMap *newMap = [mutableMap copy];
+
+  XCTAssertEqual(newMap.sectionsOfItems[0], map.sectionsOfItems[0]);
+  XCTAssertNotEqual(newMap.sectionsOfItems[1], map.sectionsOfItems[1]);
+  XCTAssertEqual(newMap.count, 7);
+  XCTAssertEqual(map.count, 6);
+
+  // Both maps look elements up in their own version of the section.
+  XCTAssertEqualObjects([newMap indexPathForElement:untouchedElement], [NSIndexPath indexPathForItem:2 inSection:0]);
+  XCTAssertEqualObjects([newMap indexPathForElement:insertedElement], [NSIndexPath indexPathForItem:0 inSection:1]);
+  XCTAssertEqualObjects([newMap indexPathForElement:movedElement], [NSIndexPath indexPathForItem:1 inSection:1]);
+  XCTAssertEqualObjects([map indexPathForElement:movedElement], [NSIndexPath indexPathForItem:0 inSection:1]);
+  XCTAssertNil([map indexPathForElement:insertedElement]);
+}
+
+- (void)testRemovingSectionShiftsIndexPathsOfLaterSections
+{
+  ASElementMap *map = [self mapWithItemCounts:@[ @2, @2 ]];
+  ASCollectionElement *element = [map elementForItemAtIndexPath:[NSIndexPath indexPathForItem:1 inSection:1]];
+
+  ASMutableElementMap *mutableMap = [map mutableCopy];
+  [mutableMap removeSectionsAtIndexes:[NSIndexSet indexSetWithIndex:0]];
+  [mutableMap removeSectionsOfItems:[NSIndexSet indexSetWithIndex:0]];
+  ASElementMap *newMap = [mutableMap copy];
+
+  XCTAssertEqual(newMap.sectionsOfItems[0], map.sectionsOfItems[1]);
+  XCTAssertEqualObjects([newMap indexPathForElement:element], [NSIndexPath indexPathForItem:1 inSection:0]);
+  XCTAssertEqual([newMap convertSection:1 fromMap:map], 0);
+  XCTAssertEqual([newMap convertSection:0 fromMap:map], NSNotFound);
+}
+
+- (void)testElementsOutsideOfTheMapHaveNoIndexPath
+{
+  ASElementMap *emptyMap = [[ASElementMap alloc] init];
+  ASElementMap *map = [self mapWithItemCounts:@[ @1, @1 ]];
+
+  // The element was never added to a map, so it has no section yet.
+  ASCollectionElement *element = [self elementOfKind:nil];
+  XCTAssertNil([emptyMap indexPathForElement:element]);
+  XCTAssertNil([map indexPathForElement:element]);
+  XCTAssertNil([emptyMap indexPathForElement:[map elementForItemAtIndexPath:[NSIndexPath indexPathForItem:0 inSection:0]]]);
+}
+
+- (void)testEnumerationIncludesItemsAndSupplementaryElements
+{
+  ASCollectionElement *header = [self elementOfKind:UICollectionElementKindSectionHeader];
+  ASElementMap *itemMap = [self mapWithItemCounts:@[ @20, @0 ]];
+  ASElementMap *map = [[ASElementMap alloc] initWithSections:_sections
+                                                       items:itemMap.sectionsOfItems
+                                       supplementaryElements:@{ UICollectionElementKindSectionHeader : @{ [NSIndexPath indexPathForItem:0 inSection:1] : header } }];
+
+  NSMutableArray<ASCollectionElement *> *elements = [NSMutableArray array];
+  for (ASCollectionElement *element in map) {
+    [elements addObject:element];
+  }
+  NSMutableArray<ASCollectionElement *> *expectedElements = [map.itemElements mutableCopy];
+  [expectedElements addObject:header];
+  XCTAssertEqualObjects(elements, expectedElements);
+  XCTAssertEqual(map.count, 21);
+  XCTAssertEqualObjects([map indexPathForElement:header], [NSIndexPath indexPathForItem:0 inSection:1]);
+  XCTAssertNil([map indexPathForElementIfCell:header]);
+}
+
+@end
@@ -0,0 +1,167 @@
+//
+//  ASHierarchyChangeSetTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import "ASTestCase.h"
+#import <AsyncDisplayKit/_ASHierarchyChangeSet.h>
+
+@interface ASHierarchyChangeSetTests : ASTestCase
+
+@end
+
+@implementation ASHierarchyChangeSetTests
+
+#pragma mark - Merging
+
+/// 5 items, insert 0, then insert 0 again
+- (void)testMergingInsertsAtTop
+{
+  let first = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 5 }];
+  [first insertItems:@[ [NSIndexPath indexPathForItem:0 inSection:0] ] animationOptions:kNilOptions];
+  let second = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 5 }];
+  [second insertItems:@[ [NSIndexPath indexPathForItem:0 inSection:0] ] animationOptions:kNilOptions];
+
+  let merged = [_ASHierarchyChangeSet changeSetByMergingChangeSets:@[ first, second ]];
+  [merged markCompletedWithNewItemCounts:{ 7 }];
+  XCTAssertEqualObjects([merged indexesForItemChangesOfType:_ASHierarchyChangeTypeInsert inSection:0], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+  XCTAssertEqual([merged indexesForItemChangesOfType:_ASHierarchyChangeTypeDelete inSection:0].count, 0);
+}
+
+/// 3 items, insert 2, then delete 2
+- (void)testMergingInsertThenDeleteIsEmpty
+{
+  let first = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 3 }];
+  [first insertItems:@[ [NSIndexPath indexPathForItem:2 inSection:0] ] animationOptions:kNilOptions];
+  let second = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 3 }];
+  [second deleteItems:@[ [NSIndexPath indexPathForItem:2 inSection:0] ] animationOptions:kNilOptions];
+
+  let merged = [_ASHierarchyChangeSet changeSetByMergingChangeSets:@[ first, second ]];
+  XCTAssertTrue(merged.isEmpty);
+}
+
+/// 3 items, reload {0-1}, then delete 0
+- (void)testMergingReloadThenDelete
+{
+  let first = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 3 }];
+  [first reloadItems:@[ [NSIndexPath indexPathForItem:0 inSection:0], [NSIndexPath indexPathForItem:1 inSection:0] ] animationOptions:kNilOptions];
+  let second = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 3 }];
+  [second deleteItems:@[ [NSIndexPath indexPathForItem:0 inSection:0] ] animationOptions:kNilOptions];
+
+  let merged = [_ASHierarchyChangeSet changeSetByMergingChangeSets:@[ first, second ]];
+  [merged markCompletedWithNewItemCounts:{ 2 }];
+  XCTAssertEqualObjects([merged indexesForItemChangesOfType:_ASHierarchyChangeTypeDelete inSection:0], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+  XCTAssertEqualObjects([merged indexesForItemChangesOfType:_ASHierarchyChangeTypeInsert inSection:0], [NSIndexSet indexSetWithIndex:0]);
+  XCTAssertEqual([merged newIndexPathForOldIndexPath:[NSIndexPath indexPathForItem:2 inSection:0]].item, 1);
+}
+
+/// 1 section with 2 items, insert section 0, then insert an item into it
+- (void)testMergingItemInsertIntoInsertedSection
+{
+  let first = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 2 }];
+  [first insertSections:[NSIndexSet indexSetWithIndex:0] animationOptions:kNilOptions];
+  let second = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 2 }];
+  [second insertItems:@[ [NSIndexPath indexPathForItem:0 inSection:0] ] animationOptions:kNilOptions];
+
+  let merged = [_ASHierarchyChangeSet changeSetByMergingChangeSets:@[ first, second ]];
+  [merged markCompletedWithNewItemCounts:{ 1, 2 }];
+  XCTAssertEqualObjects(merged.insertedSections, [NSIndexSet indexSetWithIndex:0]);
+  XCTAssertEqual(merged.deletedSections.count, 0);
+  XCTAssertEqual([merged itemChangesOfType:_ASHierarchyChangeTypeInsert].count, 0);
+  XCTAssertEqual([merged newSectionForOldSection:0], 1);
+}
+
+- (void)testMergingWithReloadDataReloadsData
+{
+  let first = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 2 }];
+  [first deleteItems:@[ [NSIndexPath indexPathForItem:0 inSection:0] ] animationOptions:kNilOptions];
+  let second = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 2 }];
+  [second reloadData];
+
+  let merged = [_ASHierarchyChangeSet changeSetByMergingChangeSets:@[ first, second ]];
+  XCTAssertTrue(merged.includesReloadData);
+}
+
+- (void)testMergedCompletionHandlerCallsCompletionHandlersInOrder
+{
+  let calls = [NSMutableArray<NSNumber *> array];
+  let first = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 1 }];
+  first.animated = YES;
+  [first addCompletionHandler:^(BOOL finished) {
+    [calls addObject:@1];
+  }];
+  let second = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 1 }];
+  second.animated = NO;
+  [second addCompletionHandler:^(BOOL finished) {
+    [calls addObject:@2];
+  }];
+
+  let merged = [_ASHierarchyChangeSet changeSetByMergingChangeSets:@[ first, second ]];
+  XCTAssertFalse(merged.animated);
+  [merged executeCompletionHandlerWithFinished:YES];
+  XCTAssertEqualObjects(calls, (@[ @1, @2 ]));
+}
+
+#pragma mark - Unchanged items
+
+/// 2 sections of 10 items, append 3 items to section 1
+- (void)testUnchangedItemsOfAppend
+{
+  let changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 10, 10 }];
+  [changeSet insertItems:@[ [NSIndexPath indexPathForItem:10 inSection:1], [NSIndexPath indexPathForItem:11 inSection:1], [NSIndexPath indexPathForItem:12 inSection:1] ] animationOptions:kNilOptions];
+  [changeSet markCompletedWithNewItemCounts:{ 10, 13 }];
+
+  NSUInteger leadingItemCount, trailingItemCount;
+  [changeSet getUnchangedLeadingItemCount:&leadingItemCount trailingItemCount:&trailingItemCount];
+  XCTAssertEqual(leadingItemCount, 20);
+  XCTAssertEqual(trailingItemCount, 0);
+}
+
+/// 2 sections of 10 items, reload item 5 of section 0 and delete item 2 of section 1
+- (void)testUnchangedItemsAroundReloadAndDelete
+{
+  let changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 10, 10 }];
+  [changeSet reloadItems:@[ [NSIndexPath indexPathForItem:5 inSection:0] ] animationOptions:kNilOptions];
+  [changeSet deleteItems:@[ [NSIndexPath indexPathForItem:2 inSection:1] ] animationOptions:kNilOptions];
+  [changeSet markCompletedWithNewItemCounts:{ 10, 9 }];
+
+  NSUInteger leadingItemCount, trailingItemCount;
+  [changeSet getUnchangedLeadingItemCount:&leadingItemCount trailingItemCount:&trailingItemCount];
+  XCTAssertEqual(leadingItemCount, 5);
+  XCTAssertEqual(trailingItemCount, 7);
+}
+
+/// 1 section of 10 items, insert an empty section 0
+- (void)testUnchangedItemsAfterInsertingEmptySection
+{
+  let changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 10 }];
+  [changeSet insertSections:[NSIndexSet indexSetWithIndex:0] animationOptions:kNilOptions];
+  [changeSet markCompletedWithNewItemCounts:{ 0, 10 }];
+
+  NSUInteger leadingItemCount, trailingItemCount;
+  [changeSet getUnchangedLeadingItemCount:&leadingItemCount trailingItemCount:&trailingItemCount];
+  XCTAssertEqual(leadingItemCount, 0);
+  XCTAssertEqual(trailingItemCount, 10);
+}
+
+- (void)testNoItemsAreUnchangedByReloadData
+{
+  let changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:{ 10 }];
+  [changeSet reloadData];
+  [changeSet markCompletedWithNewItemCounts:{ 10 }];
+
+  NSUInteger leadingItemCount, trailingItemCount;
+  [changeSet getUnchangedLeadingItemCount:&leadingItemCount trailingItemCount:&trailingItemCount];
+  XCTAssertEqual(leadingItemCount, 0);
+  XCTAssertEqual(trailingItemCount, 0);
+}
+
+@end
+
@@ -114,4 +114,45 @@
   XCTAssertEqual([map integerForKey:5], NSNotFound);
 }
 
+/// 50000 items, insert 0
+- (void)testInsertAtTopOfLargeSection
+{
+  ASIntegerMap *map = [ASIntegerMap mapForUpdateWithOldCount:50000 deleted:nil inserted:[NSIndexSet indexSetWithIndex:0]];
+  XCTAssertEqual([map integerForKey:0], 1);
+  XCTAssertEqual([map integerForKey:49999], 50000);
+  XCTAssertEqual([map integerForKey:50000], NSNotFound);
+  XCTAssertEqual([map integerForKey:-1], NSNotFound);
+}
+
+/// 5 items, delete {0-1, 3} insert {1-2, 4}, then invert
+- (void)testInverseMap
+{
+  NSMutableIndexSet *deletes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)];
+  [deletes addIndex:3];
+  NSMutableIndexSet *inserts = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 2)];
+  [inserts addIndex:4];
+  ASIntegerMap *inverseMap = [[ASIntegerMap mapForUpdateWithOldCount:5 deleted:deletes inserted:inserts] inverseMap];
+  XCTAssertEqual([inverseMap integerForKey:0], 2);
+  XCTAssertEqual([inverseMap integerForKey:1], NSNotFound);
+  XCTAssertEqual([inverseMap integerForKey:2], NSNotFound);
+  XCTAssertEqual([inverseMap integerForKey:3], 4);
+  XCTAssertEqual([inverseMap integerForKey:4], NSNotFound);
+}
+
+/// Maps created for an update equal maps with the same entries set one by one.
+- (void)testUpdateMapIsEqualToExplicitMap
+{
+  ASIntegerMap *map = [ASIntegerMap mapForUpdateWithOldCount:3 deleted:[NSIndexSet indexSetWithIndex:1] inserted:nil];
+  ASIntegerMap *alsoMap = [[ASIntegerMap alloc] init];
+  [alsoMap setInteger:0 forKey:0];
+  [alsoMap setInteger:1 forKey:2];
+  XCTAssertEqualObjects(map, alsoMap);
+
+  ASIntegerMap *mutatedMap = [map copy];
+  [mutatedMap setInteger:5 forKey:1];
+  XCTAssertEqual([mutatedMap integerForKey:1], 5);
+  XCTAssertEqual([mutatedMap integerForKey:2], 1);
+  XCTAssertNotEqualObjects(map, mutatedMap);
+}
+
 @end
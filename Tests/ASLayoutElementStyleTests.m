@@ -18,6 +18,7 @@
 #import <XCTest/XCTest.h>
 #import "ASXCTExtensions.h"
 #import <AsyncDisplayKit/ASLayoutElement.h>
+#import <AsyncDisplayKit/ASLayoutElementStylePrivate.h>
 
 #pragma mark - ASLayoutElementStyleTestsDelegate
 
@@ -132,4 +133,50 @@
   XCTAssertTrue([delegate.propertyNameChanged isEqualToString:ASLayoutElementStyleWidthProperty]);
 }
 
+- (void)testValuesSnapshotReflectsProperties
+{
+  ASLayoutElementStyle *style = [[ASLayoutElementStyle alloc] init];
+  NSUInteger version = style.version;
+  style.preferredSize = CGSizeMake(10, 20);
+  style.spacingBefore = 4;
+  style.flexGrow = 1;
+  style.flexBasis = ASDimensionMakeWithFraction(0.5);
+  style.alignSelf = ASStackLayoutAlignSelfCenter;
+  style.layoutPosition = CGPointMake(3, 4);
+
+  ASLayoutElementStyleValues values = style.values;
+  XCTAssertGreaterThan(values.version, version);
+  XCTAssertEqual(values.version, style.version);
+  XCTAssertTrue(ASDimensionEqualToDimension(values.size.width, ASDimensionMake(10)));
+  XCTAssertTrue(ASDimensionEqualToDimension(values.size.height, ASDimensionMake(20)));
+  XCTAssertEqual(values.spacingBefore, 4);
+  XCTAssertEqual(values.flexGrow, 1);
+  XCTAssertTrue(ASDimensionEqualToDimension(values.flexBasis, ASDimensionMakeWithFraction(0.5)));
+  XCTAssertEqual(values.alignSelf, ASStackLayoutAlignSelfCenter);
+  XCTAssertTrue(CGPointEqualToPoint(values.layoutPosition, CGPointMake(3, 4)));
+}
+
+- (void)testValuesSnapshotIsConsistentWhileWriting
+{
+  ASLayoutElementStyle *style = [[ASLayoutElementStyle alloc] init];
+  style.preferredSize = CGSizeMake(0, 0);
+
+  __block BOOL done = NO;
+  dispatch_group_t group = dispatch_group_create();
+  dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+    for (NSUInteger i = 1; i <= 10000; i++) {
+      style.preferredSize = CGSizeMake(i, i);
+    }
+    done = YES;
+  });
+
+  // Width and height are written together, so a snapshot must never see them differ.
+  while (!done) {
+    ASLayoutElementStyleValues values = style.values;
+    XCTAssertEqual(values.size.width.value, values.size.height.value);
+    XCTAssertEqual(values.version % 2, 0);
+  }
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+}
+
 @end
@@ -207,4 +207,19 @@ static ASLayout *layout(id<ASLayoutElement> element, NSArray<ASLayout *> *sublay
   }
 }
 
+#pragma mark - Frame lookup
+
+- (void)testThatFrameForElementUsesSublayoutFramesAtCreationTime
+{
+  ASDisplayNode *subnode = [[ASDisplayNode alloc] init];
+  ASLayout *sublayout = layoutWithCustomPosition(CGPointMake(10, 20), subnode, @[]);
+  ASLayout *parentLayout = layout([[ASLayoutSpec alloc] init], @[ sublayout ]);
+  
+  // Moving the sublayout afterwards (e.g. because it is reused in another parent) must not affect the parent.
+  sublayout.position = CGPointMake(50, 50);
+  XCTAssertTrue(CGRectEqualToRect(CGRectMake(10, 20, 100, 100), [parentLayout frameForElement:subnode]));
+  XCTAssertTrue(CGRectIsNull([parentLayout frameForElement:[[ASDisplayNode alloc] init]]));
+  XCTAssertTrue(CGRectIsNull([sublayout frameForElement:subnode]));
+}
+
 @end
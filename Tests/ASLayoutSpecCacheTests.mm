@@ -0,0 +1,193 @@
+//
+//  ASLayoutSpecCacheTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import "ASTestCase.h"
+
+#import <AsyncDisplayKit/ASLayoutSpecPrivate.h>
+
+@interface ASLayoutSpecCacheTests : ASTestCase
+@end
+
+@implementation ASLayoutSpecCacheTests {
+  ASDisplayNode *_nodeA;
+  ASDisplayNode *_nodeB;
+  ASSizeRange _sizeRange;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  ASConfiguration *config = [[ASConfiguration alloc] initWithDictionary:nil];
+  config.experimentalFeatures = ASExperimentalLayoutSpecCache;
+  [ASConfigurationManager test_resetWithConfiguration:config];
+
+  _nodeA = [[ASDisplayNode alloc] init];
+  _nodeA.style.preferredSize = CGSizeMake(50, 50);
+  _nodeB = [[ASDisplayNode alloc] init];
+  _nodeB.style.preferredSize = CGSizeMake(20, 30);
+  _sizeRange = ASSizeRangeMake(CGSizeZero, CGSizeMake(320, INFINITY));
+}
+
+- (ASStackLayoutSpec *)stackLayoutSpecWithSpacing:(CGFloat)spacing
+{
+  ASInsetLayoutSpec *inset = [ASInsetLayoutSpec insetLayoutSpecWithInsets:UIEdgeInsetsMake(4, 4, 4, 4) child:_nodeA];
+  return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal
+                                                 spacing:spacing
+                                          justifyContent:ASStackLayoutJustifyContentStart
+                                              alignItems:ASStackLayoutAlignItemsStart
+                                                children:@[ inset, _nodeB ]];
+}
+
+- (void)testLayoutIsReusedForEqualInputs
+{
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [stack layoutThatFits:_sizeRange];
+  XCTAssertEqual(layout, [stack layoutThatFits:_sizeRange]);
+  XCTAssertNotEqual(layout, [stack layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(200, INFINITY))]);
+}
+
+- (void)testLayoutIsNotReusedWhenFeatureIsDisabled
+{
+  [ASConfigurationManager test_resetWithConfiguration:nil];
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  XCTAssertNotEqual([stack layoutThatFits:_sizeRange], [stack layoutThatFits:_sizeRange]);
+}
+
+- (void)testInvalidatingChildNodeDropsCachedLayout
+{
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [stack layoutThatFits:_sizeRange];
+  [_nodeA setNeedsLayout];
+  XCTAssertNotEqual(layout, [stack layoutThatFits:_sizeRange]);
+}
+
+- (void)testChangingChildStyleDropsCachedLayout
+{
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [stack layoutThatFits:_sizeRange];
+  _nodeB.style.spacingBefore = 5;
+  ASLayout *newLayout = [stack layoutThatFits:_sizeRange];
+  XCTAssertNotEqual(layout, newLayout);
+  XCTAssertEqual(newLayout.size.width, 50 + 8 + 10 + 5 + 20);
+}
+
+- (void)testChangingNestedSpecStyleDropsCachedLayout
+{
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [stack layoutThatFits:_sizeRange];
+  stack.children.firstObject.style.spacingAfter = 5;
+  ASLayout *newLayout = [stack layoutThatFits:_sizeRange];
+  XCTAssertNotEqual(layout, newLayout);
+  XCTAssertEqual(newLayout.size.width, 50 + 8 + 5 + 10 + 20);
+}
+
+- (void)testEquivalentSpecTreeAdoptsCachedLayout
+{
+  ASStackLayoutSpec *previousStack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [previousStack layoutThatFits:_sizeRange];
+
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  XCTAssertTrue([stack adoptCachedLayoutsFromLayoutSpec:previousStack]);
+  XCTAssertEqual(layout, [stack layoutThatFits:_sizeRange]);
+}
+
+- (void)testEquivalentSpecTreeWithDifferentStyleHistoryAdoptsCachedLayout
+{
+  ASStackLayoutSpec *previousStack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [previousStack layoutThatFits:_sizeRange];
+
+  // The nested spec ends up with equal style values at a different style version.
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  ASLayoutElementStyle *insetStyle = stack.children.firstObject.style;
+  insetStyle.flexShrink = 1;
+  insetStyle.flexShrink = 0;
+  XCTAssertTrue([stack adoptCachedLayoutsFromLayoutSpec:previousStack]);
+  XCTAssertEqual(layout, [stack layoutThatFits:_sizeRange]);
+}
+
+- (void)testDifferentSpecConfigurationIsNotAdopted
+{
+  ASStackLayoutSpec *previousStack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [previousStack layoutThatFits:_sizeRange];
+
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:20];
+  XCTAssertFalse([stack adoptCachedLayoutsFromLayoutSpec:previousStack]);
+  ASLayout *newLayout = [stack layoutThatFits:_sizeRange];
+  XCTAssertNotEqual(layout, newLayout);
+  XCTAssertEqual(newLayout.size.width, 50 + 8 + 20 + 20);
+}
+
+- (void)testDifferentChildStyleIsNotAdopted
+{
+  ASStackLayoutSpec *previousStack = [self stackLayoutSpecWithSpacing:10];
+  [previousStack layoutThatFits:_sizeRange];
+
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  stack.children.firstObject.style.flexShrink = 1;
+  XCTAssertFalse([stack adoptCachedLayoutsFromLayoutSpec:previousStack]);
+}
+
+- (void)testReusedSpecDropsCachedLayout
+{
+  ASStackLayoutSpec *stack = [self stackLayoutSpecWithSpacing:10];
+  ASLayout *layout = [stack layoutThatFits:_sizeRange];
+
+  // The spec may have been mutated between layout passes, so it can't be trusted.
+  XCTAssertFalse([stack adoptCachedLayoutsFromLayoutSpec:stack]);
+  XCTAssertNotEqual(layout, [stack layoutThatFits:_sizeRange]);
+}
+
+- (void)testNodeAdoptsLayoutsOfPreviousLayoutPass
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  __block ASStackLayoutSpec *stack = nil;
+  node.layoutSpecBlock = ^ASLayoutSpec *(__kindof ASDisplayNode *n, ASSizeRange constrainedSize) {
+    stack = [self stackLayoutSpecWithSpacing:10];
+    return stack;
+  };
+
+  [node layoutThatFits:_sizeRange];
+  ASLayout *insetLayout = [stack layoutThatFits:_sizeRange].sublayouts.firstObject;
+
+  // Invalidating the sibling forces a new layout pass of the stack, but the inset subtree is untouched.
+  [_nodeB setNeedsLayout];
+  [node setNeedsLayout];
+  [node layoutThatFits:_sizeRange];
+  XCTAssertEqual(insetLayout, [stack layoutThatFits:_sizeRange].sublayouts.firstObject);
+}
+
+- (void)testFlexedChildReusesBothOfItsLayouts
+{
+  ASStackLayoutSpec *(^stackLayoutSpec)(void) = ^{
+    ASInsetLayoutSpec *inset = [ASInsetLayoutSpec insetLayoutSpecWithInsets:UIEdgeInsetsZero child:_nodeA];
+    inset.style.flexGrow = 1;
+    return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal
+                                                   spacing:0
+                                            justifyContent:ASStackLayoutJustifyContentStart
+                                                alignItems:ASStackLayoutAlignItemsStart
+                                                  children:@[ inset, _nodeB ]];
+  };
+  
+  // The inset is laid out at its intrinsic width first, then at its flexed width.
+  ASSizeRange sizeRange = ASSizeRangeMake(CGSizeMake(200, 0), CGSizeMake(200, INFINITY));
+  ASStackLayoutSpec *previousStack = stackLayoutSpec();
+  ASLayout *insetLayout = [previousStack layoutThatFits:sizeRange].sublayouts.firstObject;
+  XCTAssertEqual(insetLayout.size.width, 180);
+  
+  ASStackLayoutSpec *stack = stackLayoutSpec();
+  XCTAssertTrue([stack adoptCachedLayoutsFromLayoutSpec:previousStack]);
+  // Only the sibling changes, so the stack is laid out again but the inset reuses both of its layouts.
+  [_nodeB setNeedsLayout];
+  XCTAssertEqual(insetLayout, [stack layoutThatFits:sizeRange].sublayouts.firstObject);
+}
+
+@end
@@ -0,0 +1,134 @@
+//
+//  ASStackLayoutSpecPerformanceTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+#import <QuartzCore/QuartzCore.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+
+/**
+ * Benchmarks of the stack layout engine on synthetic layout spec trees. Each test logs the time spent per node.
+ * LayoutCore/Benchmarks/ASCoreStackLayoutBenchmark.cpp runs the same trees through the same engine on any platform.
+ *
+ * NOTE: This test case is not run during the "test" action. You have to run it manually (click the little diamond.)
+ */
+
+@interface ASStackLayoutSpecPerformanceTests : XCTestCase
+@end
+
+@implementation ASStackLayoutSpecPerformanceTests
+
+static NSUInteger const kIterationCount = 100;
+
+static ASDisplayNode *leafNode(CGSize size)
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  node.style.preferredSize = size;
+  return node;
+}
+
+static ASStackLayoutSpec *stackLayoutSpec(ASStackLayoutDirection direction, ASStackLayoutAlignItems alignItems, NSArray<id<ASLayoutElement>> *children)
+{
+  return [ASStackLayoutSpec stackLayoutSpecWithDirection:direction
+                                                 spacing:4
+                                          justifyContent:ASStackLayoutJustifyContentStart
+                                              alignItems:alignItems
+                                                children:children];
+}
+
+/**
+ * Lays out the given layout spec repeatedly and logs the time per node. The leaf nodes cache their layouts after
+ * the first pass, so this measures the layout spec math only.
+ */
+- (void)measureLayoutOfLayoutSpec:(ASLayoutSpec *)layoutSpec nodeCount:(NSUInteger)nodeCount sizeRange:(ASSizeRange)sizeRange
+{
+  [layoutSpec layoutThatFits:sizeRange];
+  
+  __block CFTimeInterval time = 0;
+  __block NSUInteger runCount = 0;
+  [self measureBlock:^{
+    CFTimeInterval start = CACurrentMediaTime();
+    for (NSUInteger i = 0; i < kIterationCount; i++) {
+      @autoreleasepool {
+        [layoutSpec layoutThatFits:sizeRange];
+      }
+    }
+    time += CACurrentMediaTime() - start;
+    runCount++;
+  }];
+  NSLog(@"%@: %.0f ns per node", self.name, time / (runCount * kIterationCount * nodeCount) * 1E9);
+}
+
+- (void)testPerformance_DeepTree
+{
+  NSUInteger const depth = 50;
+  id<ASLayoutElement> element = leafNode(CGSizeMake(20, 20));
+  for (NSUInteger i = 0; i < depth; i++) {
+    ASStackLayoutDirection direction = (i % 2 == 0) ? ASStackLayoutDirectionVertical : ASStackLayoutDirectionHorizontal;
+    element = stackLayoutSpec(direction, ASStackLayoutAlignItemsStretch, @[ element, leafNode(CGSizeMake(10, 10)) ]);
+  }
+  
+  [self measureLayoutOfLayoutSpec:(ASLayoutSpec *)element
+                        nodeCount:depth + 1
+                        sizeRange:ASSizeRangeMake(CGSizeZero, CGSizeMake(1000, INFINITY))];
+}
+
+- (void)testPerformance_WideTree
+{
+  NSUInteger const nodeCount = 500;
+  NSMutableArray<ASDisplayNode *> *children = [NSMutableArray arrayWithCapacity:nodeCount];
+  for (NSUInteger i = 0; i < nodeCount; i++) {
+    ASDisplayNode *node = leafNode(CGSizeMake(20 + i % 7, 20 + i % 5));
+    node.style.flexShrink = 1;
+    [children addObject:node];
+  }
+  
+  // The children don't fit, so every one of them is shrunk.
+  [self measureLayoutOfLayoutSpec:stackLayoutSpec(ASStackLayoutDirectionHorizontal, ASStackLayoutAlignItemsCenter, children)
+                        nodeCount:nodeCount
+                        sizeRange:ASSizeRangeMake(CGSizeMake(2000, 0), CGSizeMake(2000, INFINITY))];
+}
+
+- (void)testPerformance_WrappingTree
+{
+  NSUInteger const nodeCount = 500;
+  NSMutableArray<ASDisplayNode *> *children = [NSMutableArray arrayWithCapacity:nodeCount];
+  for (NSUInteger i = 0; i < nodeCount; i++) {
+    [children addObject:leafNode(CGSizeMake(30 + i % 40, 20))];
+  }
+  
+  ASStackLayoutSpec *stack = stackLayoutSpec(ASStackLayoutDirectionHorizontal, ASStackLayoutAlignItemsStart, children);
+  stack.flexWrap = ASStackLayoutFlexWrapWrap;
+  stack.alignContent = ASStackLayoutAlignContentSpaceBetween;
+  stack.lineSpacing = 4;
+  [self measureLayoutOfLayoutSpec:stack
+                        nodeCount:nodeCount
+                        sizeRange:ASSizeRangeMake(CGSizeMake(375, 0), CGSizeMake(375, INFINITY))];
+}
+
+- (void)testPerformance_BaselineAlignedTree
+{
+  NSUInteger const nodeCount = 500;
+  NSMutableArray<ASDisplayNode *> *children = [NSMutableArray arrayWithCapacity:nodeCount];
+  for (NSUInteger i = 0; i < nodeCount; i++) {
+    ASDisplayNode *node = leafNode(CGSizeMake(20, 14 + i % 10));
+    node.style.ascender = 10 + i % 10;
+    node.style.descender = -4;
+    [children addObject:node];
+  }
+  
+  [self measureLayoutOfLayoutSpec:stackLayoutSpec(ASStackLayoutDirectionHorizontal, ASStackLayoutAlignItemsBaselineFirst, children)
+                        nodeCount:nodeCount
+                        sizeRange:ASSizeRangeMake(CGSizeZero, CGSizeMake(INFINITY, INFINITY))];
+}
+
+@end
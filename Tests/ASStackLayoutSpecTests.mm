@@ -0,0 +1,110 @@
+//
+//  ASStackLayoutSpecTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+
+/**
+ * Checks the frames the stack engine computes for its children. The snapshot tests cover rendering, these cover the
+ * numbers: sizes after flexing, positions along both axes, line wrapping and the size of the stack itself.
+ */
+@interface ASStackLayoutSpecTests : XCTestCase
+@end
+
+@implementation ASStackLayoutSpecTests
+
+static ASDisplayNode *nodeWithSize(CGSize size)
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  node.style.preferredSize = size;
+  return node;
+}
+
+- (void)assertSublayoutOfLayout:(ASLayout *)layout atIndex:(NSUInteger)index hasFrame:(CGRect)frame
+{
+  ASLayout *sublayout = layout.sublayouts[index];
+  XCTAssertTrue(CGRectEqualToRect(sublayout.frame, frame), @"Sublayout %lu has frame %@, expected %@", (unsigned long)index, NSStringFromCGRect(sublayout.frame), NSStringFromCGRect(frame));
+}
+
+- (void)testThatChildrenAreSizedAndPositionedAlongTheStack
+{
+  ASStackLayoutSpec *stack = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal
+                                                                     spacing:10
+                                                              justifyContent:ASStackLayoutJustifyContentStart
+                                                                  alignItems:ASStackLayoutAlignItemsCenter
+                                                                    children:@[ nodeWithSize(CGSizeMake(50, 20)), nodeWithSize(CGSizeMake(30, 40)) ]];
+  ASLayout *layout = [stack layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(200, 100))];
+
+  XCTAssertTrue(CGSizeEqualToSize(layout.size, CGSizeMake(90, 40)));
+  [self assertSublayoutOfLayout:layout atIndex:0 hasFrame:CGRectMake(0, 10, 50, 20)];
+  [self assertSublayoutOfLayout:layout atIndex:1 hasFrame:CGRectMake(60, 0, 30, 40)];
+}
+
+- (void)testThatFlexibleChildrenGrowAndShrink
+{
+  ASDisplayNode *fixedNode = nodeWithSize(CGSizeMake(40, 20));
+  ASDisplayNode *growingNode = nodeWithSize(CGSizeMake(20, 20));
+  growingNode.style.flexGrow = 1;
+  ASStackLayoutSpec *stack = [ASStackLayoutSpec horizontalStackLayoutSpec];
+  stack.children = @[ fixedNode, growingNode ];
+
+  ASLayout *layout = [stack layoutThatFits:ASSizeRangeMake(CGSizeMake(100, 0), CGSizeMake(100, 100))];
+  XCTAssertTrue(CGSizeEqualToSize(layout.size, CGSizeMake(100, 20)));
+  [self assertSublayoutOfLayout:layout atIndex:0 hasFrame:CGRectMake(0, 0, 40, 20)];
+  [self assertSublayoutOfLayout:layout atIndex:1 hasFrame:CGRectMake(40, 0, 60, 20)];
+
+  growingNode.style.flexGrow = 0;
+  fixedNode.style.flexShrink = 1;
+  growingNode.style.preferredSize = CGSizeMake(80, 20);
+  layout = [stack layoutThatFits:ASSizeRangeMake(CGSizeMake(100, 0), CGSizeMake(100, 100))];
+  [self assertSublayoutOfLayout:layout atIndex:0 hasFrame:CGRectMake(0, 0, 20, 20)];
+  [self assertSublayoutOfLayout:layout atIndex:1 hasFrame:CGRectMake(20, 0, 80, 20)];
+}
+
+- (void)testThatChildrenStretchAndJustifyAlongTheCrossAxis
+{
+  // The first child has no width, so it is stretched. The second one keeps its own width.
+  ASDisplayNode *stretchedNode = [[ASDisplayNode alloc] init];
+  stretchedNode.style.height = ASDimensionMake(10);
+  ASStackLayoutSpec *stack = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionVertical
+                                                                     spacing:0
+                                                              justifyContent:ASStackLayoutJustifyContentEnd
+                                                                  alignItems:ASStackLayoutAlignItemsStretch
+                                                                    children:@[ stretchedNode, nodeWithSize(CGSizeMake(30, 40)) ]];
+  ASLayout *layout = [stack layoutThatFits:ASSizeRangeMake(CGSizeMake(80, 100), CGSizeMake(80, 100))];
+
+  XCTAssertTrue(CGSizeEqualToSize(layout.size, CGSizeMake(80, 100)));
+  [self assertSublayoutOfLayout:layout atIndex:0 hasFrame:CGRectMake(0, 50, 80, 10)];
+  [self assertSublayoutOfLayout:layout atIndex:1 hasFrame:CGRectMake(0, 60, 30, 40)];
+}
+
+- (void)testThatWrappingChildrenStartNewLines
+{
+  NSMutableArray<ASDisplayNode *> *children = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 3; i++) {
+    [children addObject:nodeWithSize(CGSizeMake(40, 20 + 10 * i))];
+  }
+  ASStackLayoutSpec *stack = [ASStackLayoutSpec horizontalStackLayoutSpec];
+  stack.flexWrap = ASStackLayoutFlexWrapWrap;
+  stack.spacing = 5;
+  stack.lineSpacing = 10;
+  stack.children = children;
+  ASLayout *layout = [stack layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(100, 200))];
+
+  XCTAssertTrue(CGSizeEqualToSize(layout.size, CGSizeMake(85, 80)));
+  [self assertSublayoutOfLayout:layout atIndex:0 hasFrame:CGRectMake(0, 0, 40, 20)];
+  [self assertSublayoutOfLayout:layout atIndex:1 hasFrame:CGRectMake(45, 0, 40, 30)];
+  [self assertSublayoutOfLayout:layout atIndex:2 hasFrame:CGRectMake(0, 40, 40, 40)];
+}
+
+@end
@@ -0,0 +1,114 @@
+//
+//  ASTableLayoutControllerTests.m
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import "ASTestCase.h"
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+#import <AsyncDisplayKit/ASRangeController.h>
+#import <AsyncDisplayKit/ASTableLayoutController.h>
+
+@interface ASDeceleratingTableView : UITableView
+@property (nonatomic) BOOL test_decelerating;
+@end
+
+@implementation ASDeceleratingTableView
+
+- (BOOL)isDecelerating
+{
+  return _test_decelerating;
+}
+
+@end
+
+@interface ASTableLayoutControllerTests : ASTestCase
+@end
+
+@implementation ASTableLayoutControllerTests {
+  ASDeceleratingTableView *_tableView;
+  ASTableLayoutController *_layoutController;
+  ASRangeTuningParameters _tuningParameters;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  ASConfiguration *config = [[ASConfiguration alloc] initWithDictionary:nil];
+  config.experimentalFeatures = ASExperimentalPredictiveRanges;
+  [ASConfigurationManager test_resetWithConfiguration:config];
+
+  _tableView = [[ASDeceleratingTableView alloc] initWithFrame:CGRectMake(0, 0, 320, 500) style:UITableViewStylePlain];
+  _tableView.contentSize = CGSizeMake(320, 10000);
+  _tableView.contentOffset = CGPointMake(0, 1000);
+  _layoutController = [[ASTableLayoutController alloc] initWithTableView:_tableView];
+  _tuningParameters = (ASRangeTuningParameters){ .leadingBufferScreenfuls = 1, .trailingBufferScreenfuls = 0.5 };
+}
+
+- (CGRect)rangeBounds
+{
+  return [_layoutController rangeBoundsOfScrollView:_tableView
+                               scrollableDirections:ASScrollDirectionVerticalDirections
+                                    scrollDirection:ASScrollDirectionDown
+                              rangeTuningParameters:_tuningParameters];
+}
+
+- (void)testThatIdleRangeBoundsAreNotStretched
+{
+  XCTAssertTrue(CGRectEqualToRect([self rangeBounds], CGRectMake(0, 750, 320, 1250)));
+}
+
+- (void)testThatDeceleratingRangeBoundsStretchTowardTheTarget
+{
+  _tableView.test_decelerating = YES;
+  _layoutController.decelerationTargetContentOffset = CGPointMake(0, 6000);
+
+  CGRect predictedBounds = ASScrollViewPredictedBounds(_tableView, _layoutController.decelerationTargetContentOffset, _layoutController.rangePredictionInterval);
+  XCTAssertGreaterThan(CGRectGetMinY(predictedBounds), 1000);
+  XCTAssertLessThan(CGRectGetMinY(predictedBounds), 6000);
+
+  // The range covers both the current and the predicted bounds, expanded by the tuning parameters.
+  CGRect rangeBounds = [self rangeBounds];
+  XCTAssertEqual(CGRectGetMinY(rangeBounds), 750);
+  XCTAssertEqual(CGRectGetMaxY(rangeBounds), CGRectGetMaxY(predictedBounds) + 500);
+
+  // Predictions stay within the content.
+  _layoutController.decelerationTargetContentOffset = CGPointMake(0, 20000);
+  _layoutController.rangePredictionInterval = 10;
+  XCTAssertEqual(CGRectGetMaxY([self rangeBounds]), 10000 + 500);
+}
+
+- (void)testThatRangeBoundsAreNotStretchedWithoutTheExperiment
+{
+  [ASConfigurationManager test_resetWithConfiguration:nil];
+  _tableView.test_decelerating = YES;
+  _layoutController.decelerationTargetContentOffset = CGPointMake(0, 6000);
+  XCTAssertTrue(CGRectEqualToRect([self rangeBounds], CGRectMake(0, 750, 320, 1250)));
+}
+
+- (void)testThatBufferScaleScalesRangeBounds
+{
+  [ASConfigurationManager test_resetWithConfiguration:nil];
+  _layoutController.bufferScale = 2;
+  XCTAssertTrue(CGRectEqualToRect([self rangeBounds], CGRectMake(0, 500, 320, 2000)));
+}
+
+- (void)testThatBufferScaleGrowsWithSlackAndShrinksWithDroppedFrames
+{
+  XCTAssertEqualWithAccuracy(ASRangeBufferScaleAfterFrameWindow(1, 0, 30), 1.1, 0.001);
+  XCTAssertEqual(ASRangeBufferScaleAfterFrameWindow(2, 0, 30), 2);
+  // 1 dropped frame in 30 is tolerated.
+  XCTAssertEqual(ASRangeBufferScaleAfterFrameWindow(1, 1, 30), 1);
+  XCTAssertEqual(ASRangeBufferScaleAfterFrameWindow(1, 5, 35), 0.75);
+  XCTAssertEqual(ASRangeBufferScaleAfterFrameWindow(0.25, 30, 60), 0.25);
+}
+
+@end
+
@@ -27,6 +27,8 @@
 #import <JGMethodSwizzler/JGMethodSwizzler.h>
 #import "ASXCTExtensions.h"
 #import <AsyncDisplayKit/ASInternalHelpers.h>
+#import <AsyncDisplayKit/ASTableLayoutController.h>
+#import "ASTestCase.h"
 
 #define NumberOfSections 10
 #define NumberOfReloadIterations 50
@@ -881,6 +883,65 @@
   XCTAssertEqual([node.view numberOfRowsInSection:0], 2);
 }
 
+- (void)testThatRowOffsetIndexMatchesTableView
+{
+  ASConfiguration *config = [[ASConfiguration alloc] initWithDictionary:nil];
+  config.experimentalFeatures = ASExperimentalTableRowOffsets;
+  [ASConfigurationManager test_resetWithConfiguration:config];
+
+  // Grouped sections are separated by headers and footers that only the table view knows the heights of.
+  UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0, 0, 375, 667)];
+  ASTableNode *node = [[ASTableNode alloc] initWithStyle:UITableViewStyleGrouped];
+  node.frame = window.bounds;
+  [window addSubnode:node];
+
+  ASTableViewFilledDataSource *dataSource = [ASTableViewFilledDataSource new];
+  dataSource.nodeBlockForItem = ^(NSIndexPath *indexPath) {
+    return (ASCellNodeBlock)^{
+      ASCellNode *cellNode = [[ASCellNode alloc] init];
+      cellNode.style.height = ASDimensionMake(20 + (indexPath.row % 7) * 10.5);
+      return cellNode;
+    };
+  };
+  node.delegate = dataSource;
+  node.dataSource = dataSource;
+  [node reloadData];
+  [node waitUntilAllUpdatesAreProcessed];
+  [node setNeedsLayout];
+  [node layoutIfNeeded];
+
+  ASTableView *tableView = node.view;
+  ASTableLayoutController *layoutController = [tableView valueForKey:@"layoutController"];
+  void (^assertRowsMatchTableView)(void) = ^{
+    ASElementMap *map = tableView.dataController.visibleMap;
+    for (CGFloat y = -100; y < tableView.contentSize.height + 100; y += 137) {
+      CGRect rect = CGRectMake(0, y, 375, 250);
+      XCTAssertEqualObjects([layoutController indexPathsForRowsInRect:rect map:map], [tableView indexPathsForRowsInRect:rect], @"In rect %@", NSStringFromCGRect(rect));
+    }
+  };
+  assertRowsMatchTableView();
+
+  // Relayout a row, which moves the rows and sections after it.
+  ASCellNode *cellNode = [node nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:1]];
+  cellNode.style.height = ASDimensionMake(300);
+  [cellNode setNeedsLayout];
+  [node layoutIfNeeded];
+  XCTAssertEqual([tableView rectForRowAtIndexPath:[NSIndexPath indexPathForRow:3 inSection:1]].size.height, 300 + 1.0 / ASScreenScale());
+  assertRowsMatchTableView();
+
+  // Reload a section, which only indexes that section again.
+  [node reloadSections:[NSIndexSet indexSetWithIndex:2] withRowAnimation:UITableViewRowAnimationNone];
+  [node waitUntilAllUpdatesAreProcessed];
+  assertRowsMatchTableView();
+
+  // Add a table header, which moves all sections without changing the data.
+  tableView.tableHeaderView = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 375, 123)];
+  [node layoutIfNeeded];
+  assertRowsMatchTableView();
+
+  [ASConfigurationManager test_resetWithConfiguration:nil];
+}
+
 @end
 
 @implementation UITableView (Testing)
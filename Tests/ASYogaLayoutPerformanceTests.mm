@@ -0,0 +1,141 @@
+//
+//  ASYogaLayoutPerformanceTests.mm
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+
+#if YOGA
+
+/**
+ * Benchmarks of repeated layout passes over a grid of rows, built once as a Yoga tree and once as the equivalent
+ * ASStackLayoutSpec tree. The root is invalidated before every pass, the rest of the tree is either left unchanged
+ * or has a single leaf resized.
+ *
+ * NOTE: This test case is not run during the "test" action. You have to run it manually (click the little diamond.)
+ */
+
+@interface ASYogaLayoutPerformanceTests : XCTestCase
+@end
+
+@implementation ASYogaLayoutPerformanceTests {
+  NSArray<NSArray<ASDisplayNode *> *> *_leafNodes;
+  ASSizeRange _sizeRange;
+}
+
+static NSUInteger const kRowCount = 20;
+static NSUInteger const kColumnCount = 10;
+static NSUInteger const kIterationCount = 100;
+
+- (void)setUp
+{
+  [super setUp];
+
+  NSMutableArray<NSArray<ASDisplayNode *> *> *leafNodes = [NSMutableArray arrayWithCapacity:kRowCount];
+  for (NSUInteger row = 0; row < kRowCount; row++) {
+    NSMutableArray<ASDisplayNode *> *rowNodes = [NSMutableArray arrayWithCapacity:kColumnCount];
+    for (NSUInteger column = 0; column < kColumnCount; column++) {
+      ASDisplayNode *node = [[ASDisplayNode alloc] init];
+      node.style.preferredSize = CGSizeMake(20, 20 + column);
+      node.style.spacingBefore = 4;
+      [rowNodes addObject:node];
+    }
+    [leafNodes addObject:rowNodes];
+  }
+  _leafNodes = leafNodes;
+  _sizeRange = ASSizeRangeMake(CGSizeZero, CGSizeMake(320, INFINITY));
+}
+
+- (ASDisplayNode *)yogaRootNode
+{
+  ASDisplayNode *rootNode = [[ASDisplayNode alloc] init];
+  rootNode.style.flexDirection = ASStackLayoutDirectionVertical;
+  for (NSArray<ASDisplayNode *> *rowNodes in _leafNodes) {
+    ASDisplayNode *rowNode = [[ASDisplayNode alloc] init];
+    rowNode.style.flexDirection = ASStackLayoutDirectionHorizontal;
+    rowNode.style.alignItems = ASStackLayoutAlignItemsStart;
+    for (ASDisplayNode *node in rowNodes) {
+      // The Yoga equivalent of spacingBefore in a horizontal stack.
+      node.style.margin = ASEdgeInsetsMake(UIEdgeInsetsMake(0, 4, 0, 0));
+      [rowNode addYogaChild:node];
+    }
+    [rootNode addYogaChild:rowNode];
+  }
+  return rootNode;
+}
+
+- (ASDisplayNode *)stackRootNode
+{
+  NSMutableArray<ASStackLayoutSpec *> *rows = [NSMutableArray arrayWithCapacity:kRowCount];
+  for (NSArray<ASDisplayNode *> *rowNodes in _leafNodes) {
+    [rows addObject:[ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal
+                                                            spacing:0
+                                                     justifyContent:ASStackLayoutJustifyContentStart
+                                                         alignItems:ASStackLayoutAlignItemsStart
+                                                           children:rowNodes]];
+  }
+  ASStackLayoutSpec *stack = [ASStackLayoutSpec verticalStackLayoutSpec];
+  stack.children = rows;
+
+  ASDisplayNode *rootNode = [[ASDisplayNode alloc] init];
+  rootNode.automaticallyManagesSubnodes = YES;
+  rootNode.layoutSpecBlock = ^ASLayoutSpec *(__kindof ASDisplayNode *node, ASSizeRange constrainedSize) {
+    return stack;
+  };
+  return rootNode;
+}
+
+/**
+ * Lays out the root node repeatedly. If resizesLeaf is YES, a single leaf is resized before every pass.
+ */
+- (void)measureLayoutOfRootNode:(ASDisplayNode *)rootNode resizesLeaf:(BOOL)resizesLeaf
+{
+  [rootNode layoutThatFits:_sizeRange];
+
+  ASDisplayNode *leafNode = _leafNodes[kRowCount / 2][kColumnCount / 2];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kIterationCount; i++) {
+      @autoreleasepool {
+        if (resizesLeaf) {
+          leafNode.style.width = ASDimensionMake(20 + (i % 2));
+          [leafNode setNeedsLayout];
+        }
+        [rootNode setNeedsLayout];
+        [rootNode layoutThatFits:_sizeRange];
+      }
+    }
+  }];
+}
+
+- (void)testPerformance_YogaUnchangedTree
+{
+  [self measureLayoutOfRootNode:[self yogaRootNode] resizesLeaf:NO];
+}
+
+- (void)testPerformance_StackUnchangedTree
+{
+  [self measureLayoutOfRootNode:[self stackRootNode] resizesLeaf:NO];
+}
+
+- (void)testPerformance_YogaSingleLeafResized
+{
+  [self measureLayoutOfRootNode:[self yogaRootNode] resizesLeaf:YES];
+}
+
+- (void)testPerformance_StackSingleLeafResized
+{
+  [self measureLayoutOfRootNode:[self stackRootNode] resizesLeaf:YES];
+}
+
+@end
+
+#endif
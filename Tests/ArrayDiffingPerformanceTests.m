@@ -0,0 +1,127 @@
+//
+//  ArrayDiffingPerformanceTests.m
+//  Texture
+//
+//  Copyright (c) 2018-present, Pinterest, Inc.  All rights reserved.
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/NSArray+Diffing.h>
+
+/**
+ * Benchmarks of the array diffing algorithms on the inputs layout transitions produce: a container with a large
+ * number of subnodes where a few subnodes are inserted, removed and moved between two layout passes. The equality
+ * based diff is also measured on large append-heavy, shuffle-heavy and mostly equal arrays.
+ *
+ * NOTE: This test case is not run during the "test" action. You have to run it manually (click the little diamond.)
+ */
+
+@interface ArrayDiffingPerformanceTests : XCTestCase
+@end
+
+@implementation ArrayDiffingPerformanceTests {
+  NSArray<NSObject *> *_previousSubnodes;
+  NSArray<NSObject *> *_pendingSubnodes;
+}
+
+static NSUInteger const kSubnodeCount = 1000;
+
+- (void)setUp
+{
+  [super setUp];
+
+  NSMutableArray<NSObject *> *previousSubnodes = [NSMutableArray arrayWithCapacity:kSubnodeCount];
+  for (NSUInteger i = 0; i < kSubnodeCount; i++) {
+    [previousSubnodes addObject:[[NSObject alloc] init]];
+  }
+
+  // Remove every 50th subnode, insert a new one every 40th and swap a few pairs.
+  NSMutableArray<NSObject *> *pendingSubnodes = [previousSubnodes mutableCopy];
+  for (NSInteger i = kSubnodeCount - 1; i >= 0; i -= 50) {
+    [pendingSubnodes removeObjectAtIndex:i];
+  }
+  for (NSUInteger i = 0; i < pendingSubnodes.count; i += 40) {
+    [pendingSubnodes insertObject:[[NSObject alloc] init] atIndex:i];
+  }
+  for (NSUInteger i = 0; i + 100 < pendingSubnodes.count; i += 200) {
+    [pendingSubnodes exchangeObjectAtIndex:i withObjectAtIndex:i + 100];
+  }
+
+  _previousSubnodes = previousSubnodes;
+  _pendingSubnodes = pendingSubnodes;
+}
+
+- (void)testPerformance_LongestCommonSubsequenceDiff
+{
+  [self measureBlock:^{
+    NSIndexSet *insertions, *deletions;
+    NSArray<NSIndexPath *> *moves;
+    [_previousSubnodes asdk_diffWithArray:_pendingSubnodes insertions:&insertions deletions:&deletions moves:&moves];
+  }];
+}
+
+- (void)testPerformance_IdentityDiff
+{
+  [self measureBlock:^{
+    NSIndexSet *insertions, *deletions;
+    NSArray<NSIndexPath *> *moves;
+    [_previousSubnodes asdk_diffByIdentityWithArray:_pendingSubnodes insertions:&insertions deletions:&deletions moves:&moves];
+  }];
+}
+
+static NSUInteger const kElementCount = 5000;
+
+- (NSArray<NSNumber *> *)numbersInRange:(NSRange)range
+{
+  NSMutableArray<NSNumber *> *numbers = [NSMutableArray arrayWithCapacity:range.length];
+  for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+    [numbers addObject:@(i)];
+  }
+  return numbers;
+}
+
+- (void)measureDiffFromArray:(NSArray *)array toArray:(NSArray *)otherArray
+{
+  [self measureBlock:^{
+    NSIndexSet *insertions, *deletions;
+    NSArray<NSIndexPath *> *moves;
+    [array asdk_diffWithArray:otherArray insertions:&insertions deletions:&deletions moves:&moves];
+  }];
+}
+
+- (void)testPerformance_AppendHeavyDiff
+{
+  // A feed that loaded another page: the old elements are kept and as many new ones are appended.
+  NSArray<NSNumber *> *array = [self numbersInRange:NSMakeRange(0, kElementCount)];
+  [self measureDiffFromArray:array toArray:[self numbersInRange:NSMakeRange(0, 2 * kElementCount)]];
+}
+
+- (void)testPerformance_ShuffleHeavyDiff
+{
+  NSArray<NSNumber *> *array = [self numbersInRange:NSMakeRange(0, kElementCount)];
+  NSMutableArray<NSNumber *> *shuffledArray = [array mutableCopy];
+  srand48(0);
+  for (NSUInteger i = kElementCount - 1; i > 0; i--) {
+    [shuffledArray exchangeObjectAtIndex:i withObjectAtIndex:(NSUInteger)(drand48() * (i + 1))];
+  }
+  [self measureDiffFromArray:array toArray:shuffledArray];
+}
+
+- (void)testPerformance_MostlyEqualDiff
+{
+  // Replace one element in every thousand.
+  NSArray<NSNumber *> *array = [self numbersInRange:NSMakeRange(0, kElementCount)];
+  NSMutableArray<NSNumber *> *otherArray = [array mutableCopy];
+  for (NSUInteger i = 500; i < kElementCount; i += 1000) {
+    otherArray[i] = @(kElementCount + i);
+  }
+  [self measureDiffFromArray:array toArray:otherArray];
+}
+
+@end
@@ -76,6 +76,64 @@
   }
 }
 
+- (void)testDiffingCommonIndexesAreLongestCommonSubsequence
+{
+  for (int testNumber = 0; testNumber < 100; testNumber++) {
+    NSMutableArray<NSNumber *> *original = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *pending = [NSMutableArray array];
+    uint32_t range = 1 + arc4random_uniform(20);
+    for (uint32_t i = arc4random_uniform(40); i > 0; i--) {
+      [original addObject:@(arc4random_uniform(range))];
+    }
+    for (uint32_t i = arc4random_uniform(40); i > 0; i--) {
+      [pending addObject:@(arc4random_uniform(range))];
+    }
+
+    // Length of the longest common subsequence, one row at a time.
+    NSUInteger pendingCount = pending.count;
+    NSUInteger lengths[pendingCount + 1], previousLengths[pendingCount + 1];
+    memset(lengths, 0, sizeof(lengths));
+    for (NSNumber *number in original) {
+      memcpy(previousLengths, lengths, sizeof(lengths));
+      for (NSUInteger j = 1; j <= pendingCount; j++) {
+        lengths[j] = [number isEqual:pending[j - 1]] ? previousLengths[j - 1] + 1 : MAX(previousLengths[j], lengths[j - 1]);
+      }
+    }
+
+    NSIndexSet *indexSet = [original _asdk_commonIndexesWithArray:pending compareBlock:^BOOL(id lhs, id rhs) {
+      return [lhs isEqual:rhs];
+    }];
+    XCTAssertEqual(indexSet.count, lengths[pendingCount], @"[%@] -> [%@]",
+                   [original componentsJoinedByString:@","], [pending componentsJoinedByString:@","]);
+
+    // The common objects must appear in the same order in the pending array.
+    __block NSUInteger j = 0;
+    [indexSet enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+      while (j < pendingCount && ![pending[j] isEqual:original[idx]]) {
+        j++;
+      }
+      XCTAssertLessThan(j, pendingCount);
+      j++;
+    }];
+  }
+}
+
+- (void)testDiffingAmbiguousCommonIndexes
+{
+  // Both {0,1} and {0,2} are longest common subsequences. Pin the one that is chosen, so changes to it are deliberate.
+  NSArray *original = @[ @0, @1, @1 ];
+  NSArray *pending = @[ @0, @1, @0 ];
+  NSIndexSet *indexSet = [original _asdk_commonIndexesWithArray:pending compareBlock:^BOOL(id lhs, id rhs) {
+    return [lhs isEqual:rhs];
+  }];
+  XCTAssertEqualObjects(indexSet, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+
+  NSIndexSet *insertions, *deletions;
+  [original asdk_diffWithArray:pending insertions:&insertions deletions:&deletions];
+  XCTAssertEqualObjects(deletions, [NSIndexSet indexSetWithIndex:2]);
+  XCTAssertEqualObjects(insertions, [NSIndexSet indexSetWithIndex:2]);
+}
+
 - (void)testDiffingInsertionsAndDeletions {
   NSArray<NSArray *> *tests = @[
       @[
@@ -318,4 +376,73 @@
     pending = @[];
   }
 }
+
+- (void)testDiffingByIdentityRebuildsTargetArray
+{
+  NSMutableArray<NSObject *> *objects = [NSMutableArray array];
+  for (NSUInteger i = 0; i < 25; i++) {
+    [objects addObject:[[NSObject alloc] init]];
+  }
+
+  for (int testNumber = 0; testNumber <= 100; testNumber++) {
+    NSMutableArray<NSObject *> *original = [NSMutableArray array];
+    NSMutableArray<NSObject *> *pending = [NSMutableArray array];
+    for (NSObject *object in objects) {
+      if (arc4random_uniform(2)) {
+        [original insertObject:object atIndex:arc4random_uniform((uint32_t)original.count + 1)];
+      }
+      if (arc4random_uniform(2)) {
+        [pending insertObject:object atIndex:arc4random_uniform((uint32_t)pending.count + 1)];
+      }
+    }
+
+    NSIndexSet *insertions, *deletions;
+    NSArray<NSIndexPath *> *moves;
+    [original asdk_diffByIdentityWithArray:pending insertions:&insertions deletions:&deletions moves:&moves];
+
+    // Remove deleted and moved-from objects, then insert at ascending destination indexes.
+    NSMutableIndexSet *removals = [deletions mutableCopy];
+    for (NSIndexPath *move in moves) {
+      [removals addIndex:[move indexAtPosition:0]];
+    }
+    NSMutableArray<NSObject *> *test = [original mutableCopy];
+    [test removeObjectsAtIndexes:removals];
+
+    __block NSUInteger j = 0;
+    NSMutableIndexSet *destinations = [insertions mutableCopy];
+    for (NSIndexPath *move in moves) {
+      [destinations addIndex:[move indexAtPosition:1]];
+    }
+    [destinations enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+      if ([insertions containsIndex:idx]) {
+        [test insertObject:pending[idx] atIndex:idx];
+      } else {
+        XCTAssertEqual([moves[j] indexAtPosition:1], idx);
+        [test insertObject:original[[moves[j] indexAtPosition:0]] atIndex:idx];
+        j++;
+      }
+    }];
+
+    XCTAssertEqualObjects(test, pending, @"insertions: %@\nmoves: %@\ndeletions: %@", insertions, moves, deletions);
+  }
+}
+
+- (void)testDiffingByIdentityOnlyMovesDisplacedObjects
+{
+  NSObject *a = [[NSObject alloc] init], *b = [[NSObject alloc] init], *c = [[NSObject alloc] init], *d = [[NSObject alloc] init];
+  NSIndexSet *insertions, *deletions;
+  NSArray<NSIndexPath *> *moves;
+
+  // Moving the last object to the front only moves that object, even though all other indexes shift.
+  [@[a, b, c, d] asdk_diffByIdentityWithArray:@[d, a, b, c] insertions:&insertions deletions:&deletions moves:&moves];
+  XCTAssertEqual(insertions.count, 0);
+  XCTAssertEqual(deletions.count, 0);
+  XCTAssertEqualObjects(moves, @[ [NSIndexPath indexPathWithIndexes:(NSUInteger[]){3, 0} length:2] ]);
+
+  [@[a, b, c] asdk_diffByIdentityWithArray:@[d, a, c] insertions:&insertions deletions:&deletions moves:&moves];
+  XCTAssertEqualObjects(insertions, [NSIndexSet indexSetWithIndex:0]);
+  XCTAssertEqualObjects(deletions, [NSIndexSet indexSetWithIndex:1]);
+  XCTAssertEqual(moves.count, 0);
+}
+
 @end
@@ -192,6 +192,16 @@ if [ "$MODE" = "framework" -o "$MODE" = "all" ]; then
     success="1"
 fi
 
+if [ "$MODE" = "layout-core" ]; then
+    echo "Building, testing & benchmarking the portable layout core."
+
+    cmake -S LayoutCore -B build/LayoutCore -DCMAKE_BUILD_TYPE=Release
+    cmake --build build/LayoutCore
+    ctest --test-dir build/LayoutCore --output-on-failure
+    build/LayoutCore/ASCoreStackLayoutBenchmark
+    success="1"
+fi
+
 if [ "$MODE" = "cocoapods-lint" -o "$MODE" = "all" ]; then
     echo "Verifying that podspec lints."
 